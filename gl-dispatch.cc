@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include "gl-dispatch.h"
+
+//
+// Each entry is a small forwarding function rather than the address of the
+// GL function itself, because with some interface headers (GLEW, for one)
+// the GL names are macros for pointers that are only loaded at run time.
+//
+static const GLDispatch systemDispatch = {
+    .CreateShader = [](GLenum type)
+        { return glCreateShader(type); },
+    .ShaderSource = [](GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+        { glShaderSource(shader, count, string, length); },
+    .CompileShader = [](GLuint shader)
+        { glCompileShader(shader); },
+    .GetShaderiv = [](GLuint shader, GLenum pname, GLint* params)
+        { glGetShaderiv(shader, pname, params); },
+    .GetShaderInfoLog = [](GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+        { glGetShaderInfoLog(shader, bufSize, length, infoLog); },
+    .DeleteShader = [](GLuint shader)
+        { glDeleteShader(shader); },
+    .CreateProgram = []()
+        { return glCreateProgram(); },
+    .AttachShader = [](GLuint program, GLuint shader)
+        { glAttachShader(program, shader); },
+    .LinkProgram = [](GLuint program)
+        { glLinkProgram(program); },
+    .GetProgramiv = [](GLuint program, GLenum pname, GLint* params)
+        { glGetProgramiv(program, pname, params); },
+    .GetProgramInfoLog = [](GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+        { glGetProgramInfoLog(program, bufSize, length, infoLog); },
+    .UseProgram = [](GLuint program)
+        { glUseProgram(program); },
+    .DeleteProgram = [](GLuint program)
+        { glDeleteProgram(program); },
+    .ProgramParameteri = [](GLuint program, GLenum pname, GLint value)
+        { glProgramParameteri(program, pname, value); },
+    .GetProgramBinary = [](GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary)
+        { glGetProgramBinary(program, bufSize, length, binaryFormat, binary); },
+    .ProgramBinary = [](GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+        { glProgramBinary(program, binaryFormat, binary, length); },
+    .GetAttribLocation = [](GLuint program, const GLchar* name)
+        { return glGetAttribLocation(program, name); },
+    .GetUniformLocation = [](GLuint program, const GLchar* name)
+        { return glGetUniformLocation(program, name); },
+    .GetActiveAttrib = [](GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+        { glGetActiveAttrib(program, index, bufSize, length, size, type, name); },
+    .GetActiveUniform = [](GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+        { glGetActiveUniform(program, index, bufSize, length, size, type, name); },
+    .GetUniformBlockIndex = [](GLuint program, const GLchar* uniformBlockName)
+        { return glGetUniformBlockIndex(program, uniformBlockName); },
+    .UniformBlockBinding = [](GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+        { glUniformBlockBinding(program, uniformBlockIndex, uniformBlockBinding); },
+    .Uniform1f = [](GLint location, GLfloat v0)
+        { glUniform1f(location, v0); },
+    .Uniform1i = [](GLint location, GLint v0)
+        { glUniform1i(location, v0); },
+    .Uniform1fv = [](GLint location, GLsizei count, const GLfloat* value)
+        { glUniform1fv(location, count, value); },
+    .Uniform2fv = [](GLint location, GLsizei count, const GLfloat* value)
+        { glUniform2fv(location, count, value); },
+    .Uniform3fv = [](GLint location, GLsizei count, const GLfloat* value)
+        { glUniform3fv(location, count, value); },
+    .Uniform4fv = [](GLint location, GLsizei count, const GLfloat* value)
+        { glUniform4fv(location, count, value); },
+    .Uniform1iv = [](GLint location, GLsizei count, const GLint* value)
+        { glUniform1iv(location, count, value); },
+    .UniformMatrix3fv = [](GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+        { glUniformMatrix3fv(location, count, transpose, value); },
+    .UniformMatrix4fv = [](GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+        { glUniformMatrix4fv(location, count, transpose, value); },
+    .GenBuffers = [](GLsizei n, GLuint* buffers)
+        { glGenBuffers(n, buffers); },
+    .DeleteBuffers = [](GLsizei n, const GLuint* buffers)
+        { glDeleteBuffers(n, buffers); },
+    .BindBuffer = [](GLenum target, GLuint buffer)
+        { glBindBuffer(target, buffer); },
+    .BindBufferBase = [](GLenum target, GLuint index, GLuint buffer)
+        { glBindBufferBase(target, index, buffer); },
+    .BufferData = [](GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+        { glBufferData(target, size, data, usage); },
+    .BufferSubData = [](GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+        { glBufferSubData(target, offset, size, data); },
+    .GetIntegerv = [](GLenum pname, GLint* data)
+        { glGetIntegerv(pname, data); },
+    .GetString = [](GLenum name)
+        { return glGetString(name); },
+    .GetStringi = [](GLenum name, GLuint index)
+        { return glGetStringi(name, index); },
+};
+
+const GLDispatch&
+GLDispatch::system()
+{
+    return systemDispatch;
+}
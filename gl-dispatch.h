@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef GL_DISPATCH_H_
+#define GL_DISPATCH_H_
+
+#include "gl-if.h"
+
+//
+// Table of the OpenGL entry points used by Program, Shader and
+// UniformBuffer.  They make every GL call through the current table,
+// rather than calling GL directly, so that the calls can be redirected:
+// to a mock implementation for testing without a GPU, or to a wrapper
+// that counts or checks them.
+//
+// The default table, system(), simply forwards to the functions provided
+// by gl-if.h, and lives in its own translation unit (gl-dispatch.cc).  A
+// program without a GL library to link against (such as the unit tests)
+// links a stub definition of system() in place of gl-dispatch.o, and
+// installs its own table with set().
+//
+struct GLDispatch
+{
+    // Shaders
+    GLuint (*CreateShader)(GLenum type);
+    void (*ShaderSource)(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length);
+    void (*CompileShader)(GLuint shader);
+    void (*GetShaderiv)(GLuint shader, GLenum pname, GLint* params);
+    void (*GetShaderInfoLog)(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+    void (*DeleteShader)(GLuint shader);
+
+    // Programs
+    GLuint (*CreateProgram)();
+    void (*AttachShader)(GLuint program, GLuint shader);
+    void (*LinkProgram)(GLuint program);
+    void (*GetProgramiv)(GLuint program, GLenum pname, GLint* params);
+    void (*GetProgramInfoLog)(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+    void (*UseProgram)(GLuint program);
+    void (*DeleteProgram)(GLuint program);
+    void (*ProgramParameteri)(GLuint program, GLenum pname, GLint value);
+    void (*GetProgramBinary)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+    void (*ProgramBinary)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+
+    // Program interface queries
+    GLint (*GetAttribLocation)(GLuint program, const GLchar* name);
+    GLint (*GetUniformLocation)(GLuint program, const GLchar* name);
+    void (*GetActiveAttrib)(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name);
+    void (*GetActiveUniform)(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name);
+    GLuint (*GetUniformBlockIndex)(GLuint program, const GLchar* uniformBlockName);
+    void (*UniformBlockBinding)(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+
+    // Uniforms
+    void (*Uniform1f)(GLint location, GLfloat v0);
+    void (*Uniform1i)(GLint location, GLint v0);
+    void (*Uniform1fv)(GLint location, GLsizei count, const GLfloat* value);
+    void (*Uniform2fv)(GLint location, GLsizei count, const GLfloat* value);
+    void (*Uniform3fv)(GLint location, GLsizei count, const GLfloat* value);
+    void (*Uniform4fv)(GLint location, GLsizei count, const GLfloat* value);
+    void (*Uniform1iv)(GLint location, GLsizei count, const GLint* value);
+    void (*UniformMatrix3fv)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+    void (*UniformMatrix4fv)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+    // Buffers
+    void (*GenBuffers)(GLsizei n, GLuint* buffers);
+    void (*DeleteBuffers)(GLsizei n, const GLuint* buffers);
+    void (*BindBuffer)(GLenum target, GLuint buffer);
+    void (*BindBufferBase)(GLenum target, GLuint index, GLuint buffer);
+    void (*BufferData)(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+    void (*BufferSubData)(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+
+    // State queries
+    void (*GetIntegerv)(GLenum pname, GLint* data);
+    const GLubyte* (*GetString)(GLenum name);
+    const GLubyte* (*GetStringi)(GLenum name, GLuint index);
+
+    // The table of real GL entry points.
+    static const GLDispatch& system();
+
+    // The table in use.  Passing NULL to set() goes back to system().
+    static const GLDispatch& get() { return current_ ? *current_ : system(); }
+    static void set(const GLDispatch* table) { current_ = table; }
+
+private:
+    static inline const GLDispatch* current_ = 0;
+};
+
+#endif // GL_DISPATCH_H_
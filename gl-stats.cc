@@ -0,0 +1,376 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <chrono>
+#include <iomanip>
+#include <tuple>
+#include <type_traits>
+#include "gl-dispatch.h"
+#include "gl-stats.h"
+
+using std::string;
+
+namespace
+{
+
+// How a call is charged to a program.
+enum CallKind
+{
+    OtherCall,          // not charged to a program
+    ProgramCall,        // first argument is the program
+    LocationCall,       // ProgramCall, and a location query
+    BindCall,           // glUseProgram
+    UniformCall         // charged to the bound program
+};
+
+// One entry per GLDispatch member, in the same order.
+enum CallId
+{
+    IdCreateShader,
+    IdShaderSource,
+    IdCompileShader,
+    IdGetShaderiv,
+    IdGetShaderInfoLog,
+    IdDeleteShader,
+    IdCreateProgram,
+    IdAttachShader,
+    IdLinkProgram,
+    IdGetProgramiv,
+    IdGetProgramInfoLog,
+    IdUseProgram,
+    IdDeleteProgram,
+    IdProgramParameteri,
+    IdGetProgramBinary,
+    IdProgramBinary,
+    IdGetAttribLocation,
+    IdGetUniformLocation,
+    IdGetActiveAttrib,
+    IdGetActiveUniform,
+    IdGetUniformBlockIndex,
+    IdUniformBlockBinding,
+    IdUniform1f,
+    IdUniform1i,
+    IdUniform1fv,
+    IdUniform2fv,
+    IdUniform3fv,
+    IdUniform4fv,
+    IdUniform1iv,
+    IdUniformMatrix3fv,
+    IdUniformMatrix4fv,
+    IdGenBuffers,
+    IdDeleteBuffers,
+    IdBindBuffer,
+    IdBindBufferBase,
+    IdBufferData,
+    IdBufferSubData,
+    IdGetIntegerv,
+    IdGetString,
+    IdGetStringi,
+    NumCalls
+};
+
+struct CallInfo
+{
+    const char* name;
+    CallKind kind;
+};
+
+const CallInfo callInfo[NumCalls] = {
+    { "CreateShader", OtherCall },
+    { "ShaderSource", OtherCall },
+    { "CompileShader", OtherCall },
+    { "GetShaderiv", OtherCall },
+    { "GetShaderInfoLog", OtherCall },
+    { "DeleteShader", OtherCall },
+    { "CreateProgram", OtherCall },
+    { "AttachShader", ProgramCall },
+    { "LinkProgram", ProgramCall },
+    { "GetProgramiv", ProgramCall },
+    { "GetProgramInfoLog", ProgramCall },
+    { "UseProgram", BindCall },
+    { "DeleteProgram", ProgramCall },
+    { "ProgramParameteri", ProgramCall },
+    { "GetProgramBinary", ProgramCall },
+    { "ProgramBinary", ProgramCall },
+    { "GetAttribLocation", LocationCall },
+    { "GetUniformLocation", LocationCall },
+    { "GetActiveAttrib", ProgramCall },
+    { "GetActiveUniform", ProgramCall },
+    { "GetUniformBlockIndex", ProgramCall },
+    { "UniformBlockBinding", ProgramCall },
+    { "Uniform1f", UniformCall },
+    { "Uniform1i", UniformCall },
+    { "Uniform1fv", UniformCall },
+    { "Uniform2fv", UniformCall },
+    { "Uniform3fv", UniformCall },
+    { "Uniform4fv", UniformCall },
+    { "Uniform1iv", UniformCall },
+    { "UniformMatrix3fv", UniformCall },
+    { "UniformMatrix4fv", UniformCall },
+    { "GenBuffers", OtherCall },
+    { "DeleteBuffers", OtherCall },
+    { "BindBuffer", OtherCall },
+    { "BindBufferBase", OtherCall },
+    { "BufferData", OtherCall },
+    { "BufferSubData", OtherCall },
+    { "GetIntegerv", OtherCall },
+    { "GetString", OtherCall },
+    { "GetStringi", OtherCall },
+};
+
+struct State
+{
+    State() : inner(0), enabled(false), bound(0) {}
+    const GLDispatch* inner;
+    bool enabled;
+    GLuint bound;
+    uint64_t count[NumCalls];
+    uint64_t nanoseconds[NumCalls];
+    std::map<unsigned int, GLStats::ProgramStats> programs;
+};
+
+State&
+state()
+{
+    static State theState;
+    return theState;
+}
+
+// Times one call and charges it to the right place when it goes out of
+// scope.
+class Record
+{
+public:
+    Record(CallId id, GLuint program) :
+        id_(id),
+        program_(program),
+        wasBound_(state().bound),
+        start_(std::chrono::steady_clock::now()) {}
+    ~Record()
+    {
+        State& s(state());
+        uint64_t ns(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count());
+        s.count[id_]++;
+        s.nanoseconds[id_] += ns;
+
+        CallKind kind(callInfo[id_].kind);
+        GLuint program(kind == UniformCall ? wasBound_ : program_);
+        if (kind == BindCall)
+        {
+            s.bound = program_;
+        }
+        if (kind == OtherCall || program == 0)
+        {
+            return;
+        }
+        GLStats::ProgramStats& p(s.programs[program]);
+        p.calls++;
+        p.nanoseconds += ns;
+        switch (kind)
+        {
+        case BindCall:
+            p.binds++;
+            if (program == wasBound_)
+            {
+                p.redundantBinds++;
+            }
+            break;
+        case UniformCall:
+            p.uniformUploads++;
+            break;
+        case LocationCall:
+            p.locationQueries++;
+            break;
+        default:
+            break;
+        }
+    }
+
+private:
+    CallId id_;
+    GLuint program_;
+    GLuint wasBound_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// The program a call is about, if its first argument names one.
+template<typename... Args>
+GLuint
+programArg(CallId id, Args... args)
+{
+    if constexpr (sizeof...(Args) > 0)
+    {
+        typedef std::tuple_element_t<0, std::tuple<Args...> > First;
+        if constexpr (std::is_same_v<First, GLuint>)
+        {
+            if (callInfo[id].kind != OtherCall && callInfo[id].kind != UniformCall)
+            {
+                return std::get<0>(std::tuple<Args...>(args...));
+            }
+        }
+    }
+    return 0;
+}
+
+// A wrapper with the signature of the wrapped entry point, that records
+// the call and forwards it to the table that was current when the
+// statistics were enabled.
+template<typename F>
+struct Wrap;
+
+template<typename R, typename... Args>
+struct Wrap<R (*)(Args...)>
+{
+    template<R (*GLDispatch::*Member)(Args...), CallId Id>
+    static R call(Args... args)
+    {
+        Record record(Id, programArg(Id, args...));
+        return (state().inner->*Member)(args...);
+    }
+};
+
+const GLDispatch statsDispatch = {
+    .CreateShader = Wrap<decltype(GLDispatch::CreateShader)>::call<&GLDispatch::CreateShader, IdCreateShader>,
+    .ShaderSource = Wrap<decltype(GLDispatch::ShaderSource)>::call<&GLDispatch::ShaderSource, IdShaderSource>,
+    .CompileShader = Wrap<decltype(GLDispatch::CompileShader)>::call<&GLDispatch::CompileShader, IdCompileShader>,
+    .GetShaderiv = Wrap<decltype(GLDispatch::GetShaderiv)>::call<&GLDispatch::GetShaderiv, IdGetShaderiv>,
+    .GetShaderInfoLog = Wrap<decltype(GLDispatch::GetShaderInfoLog)>::call<&GLDispatch::GetShaderInfoLog, IdGetShaderInfoLog>,
+    .DeleteShader = Wrap<decltype(GLDispatch::DeleteShader)>::call<&GLDispatch::DeleteShader, IdDeleteShader>,
+    .CreateProgram = Wrap<decltype(GLDispatch::CreateProgram)>::call<&GLDispatch::CreateProgram, IdCreateProgram>,
+    .AttachShader = Wrap<decltype(GLDispatch::AttachShader)>::call<&GLDispatch::AttachShader, IdAttachShader>,
+    .LinkProgram = Wrap<decltype(GLDispatch::LinkProgram)>::call<&GLDispatch::LinkProgram, IdLinkProgram>,
+    .GetProgramiv = Wrap<decltype(GLDispatch::GetProgramiv)>::call<&GLDispatch::GetProgramiv, IdGetProgramiv>,
+    .GetProgramInfoLog = Wrap<decltype(GLDispatch::GetProgramInfoLog)>::call<&GLDispatch::GetProgramInfoLog, IdGetProgramInfoLog>,
+    .UseProgram = Wrap<decltype(GLDispatch::UseProgram)>::call<&GLDispatch::UseProgram, IdUseProgram>,
+    .DeleteProgram = Wrap<decltype(GLDispatch::DeleteProgram)>::call<&GLDispatch::DeleteProgram, IdDeleteProgram>,
+    .ProgramParameteri = Wrap<decltype(GLDispatch::ProgramParameteri)>::call<&GLDispatch::ProgramParameteri, IdProgramParameteri>,
+    .GetProgramBinary = Wrap<decltype(GLDispatch::GetProgramBinary)>::call<&GLDispatch::GetProgramBinary, IdGetProgramBinary>,
+    .ProgramBinary = Wrap<decltype(GLDispatch::ProgramBinary)>::call<&GLDispatch::ProgramBinary, IdProgramBinary>,
+    .GetAttribLocation = Wrap<decltype(GLDispatch::GetAttribLocation)>::call<&GLDispatch::GetAttribLocation, IdGetAttribLocation>,
+    .GetUniformLocation = Wrap<decltype(GLDispatch::GetUniformLocation)>::call<&GLDispatch::GetUniformLocation, IdGetUniformLocation>,
+    .GetActiveAttrib = Wrap<decltype(GLDispatch::GetActiveAttrib)>::call<&GLDispatch::GetActiveAttrib, IdGetActiveAttrib>,
+    .GetActiveUniform = Wrap<decltype(GLDispatch::GetActiveUniform)>::call<&GLDispatch::GetActiveUniform, IdGetActiveUniform>,
+    .GetUniformBlockIndex = Wrap<decltype(GLDispatch::GetUniformBlockIndex)>::call<&GLDispatch::GetUniformBlockIndex, IdGetUniformBlockIndex>,
+    .UniformBlockBinding = Wrap<decltype(GLDispatch::UniformBlockBinding)>::call<&GLDispatch::UniformBlockBinding, IdUniformBlockBinding>,
+    .Uniform1f = Wrap<decltype(GLDispatch::Uniform1f)>::call<&GLDispatch::Uniform1f, IdUniform1f>,
+    .Uniform1i = Wrap<decltype(GLDispatch::Uniform1i)>::call<&GLDispatch::Uniform1i, IdUniform1i>,
+    .Uniform1fv = Wrap<decltype(GLDispatch::Uniform1fv)>::call<&GLDispatch::Uniform1fv, IdUniform1fv>,
+    .Uniform2fv = Wrap<decltype(GLDispatch::Uniform2fv)>::call<&GLDispatch::Uniform2fv, IdUniform2fv>,
+    .Uniform3fv = Wrap<decltype(GLDispatch::Uniform3fv)>::call<&GLDispatch::Uniform3fv, IdUniform3fv>,
+    .Uniform4fv = Wrap<decltype(GLDispatch::Uniform4fv)>::call<&GLDispatch::Uniform4fv, IdUniform4fv>,
+    .Uniform1iv = Wrap<decltype(GLDispatch::Uniform1iv)>::call<&GLDispatch::Uniform1iv, IdUniform1iv>,
+    .UniformMatrix3fv = Wrap<decltype(GLDispatch::UniformMatrix3fv)>::call<&GLDispatch::UniformMatrix3fv, IdUniformMatrix3fv>,
+    .UniformMatrix4fv = Wrap<decltype(GLDispatch::UniformMatrix4fv)>::call<&GLDispatch::UniformMatrix4fv, IdUniformMatrix4fv>,
+    .GenBuffers = Wrap<decltype(GLDispatch::GenBuffers)>::call<&GLDispatch::GenBuffers, IdGenBuffers>,
+    .DeleteBuffers = Wrap<decltype(GLDispatch::DeleteBuffers)>::call<&GLDispatch::DeleteBuffers, IdDeleteBuffers>,
+    .BindBuffer = Wrap<decltype(GLDispatch::BindBuffer)>::call<&GLDispatch::BindBuffer, IdBindBuffer>,
+    .BindBufferBase = Wrap<decltype(GLDispatch::BindBufferBase)>::call<&GLDispatch::BindBufferBase, IdBindBufferBase>,
+    .BufferData = Wrap<decltype(GLDispatch::BufferData)>::call<&GLDispatch::BufferData, IdBufferData>,
+    .BufferSubData = Wrap<decltype(GLDispatch::BufferSubData)>::call<&GLDispatch::BufferSubData, IdBufferSubData>,
+    .GetIntegerv = Wrap<decltype(GLDispatch::GetIntegerv)>::call<&GLDispatch::GetIntegerv, IdGetIntegerv>,
+    .GetString = Wrap<decltype(GLDispatch::GetString)>::call<&GLDispatch::GetString, IdGetString>,
+    .GetStringi = Wrap<decltype(GLDispatch::GetStringi)>::call<&GLDispatch::GetStringi, IdGetStringi>,
+};
+
+} // anonymous namespace
+
+void
+GLStats::enable()
+{
+    State& s(state());
+    if (s.enabled)
+    {
+        return;
+    }
+    s.inner = &GLDispatch::get();
+    s.enabled = true;
+    // Uniform calls are charged to the bound program, so start from the
+    // one that is bound now.
+    GLint current(0);
+    s.inner->GetIntegerv(GL_CURRENT_PROGRAM, &current);
+    s.bound = current;
+    GLDispatch::set(&statsDispatch);
+}
+
+void
+GLStats::disable()
+{
+    State& s(state());
+    if (!s.enabled)
+    {
+        return;
+    }
+    // Leave alone a table that was installed in front of ours since; it
+    // may still forward to it.
+    if (&GLDispatch::get() == &statsDispatch)
+    {
+        GLDispatch::set(s.inner == &GLDispatch::system() ? 0 : s.inner);
+    }
+    s.enabled = false;
+}
+
+bool
+GLStats::enabled()
+{
+    return state().enabled;
+}
+
+void
+GLStats::reset()
+{
+    State& s(state());
+    for (unsigned int i = 0; i < NumCalls; i++)
+    {
+        s.count[i] = 0;
+        s.nanoseconds[i] = 0;
+    }
+    s.programs.clear();
+}
+
+GLStats::Snapshot
+GLStats::snapshot()
+{
+    const State& s(state());
+    Snapshot snap;
+    snap.totalCalls = 0;
+    snap.totalNanoseconds = 0;
+    for (unsigned int i = 0; i < NumCalls; i++)
+    {
+        if (s.count[i])
+        {
+            Call call = { callInfo[i].name, s.count[i], s.nanoseconds[i] };
+            snap.calls.push_back(call);
+            snap.totalCalls += s.count[i];
+            snap.totalNanoseconds += s.nanoseconds[i];
+        }
+    }
+    snap.programs = s.programs;
+    return snap;
+}
+
+void
+GLStats::Snapshot::print(std::ostream& out) const
+{
+    out << "GL calls: " << totalCalls << " in " << totalNanoseconds / 1000 << " us" << std::endl;
+    for (std::vector<Call>::const_iterator callIt = calls.begin(); callIt != calls.end(); callIt++)
+    {
+        out << "    gl" << std::left << std::setw(24) << callIt->name << std::right
+            << std::setw(10) << callIt->count
+            << std::setw(12) << callIt->nanoseconds / 1000 << " us" << std::endl;
+    }
+    for (std::map<unsigned int, ProgramStats>::const_iterator programIt = programs.begin(); programIt != programs.end(); programIt++)
+    {
+        const ProgramStats& p(programIt->second);
+        out << "Program " << programIt->first << ": " << p.calls << " calls in "
+            << p.nanoseconds / 1000 << " us, " << p.binds << " binds ("
+            << p.redundantBinds << " redundant), " << p.uniformUploads
+            << " uniform uploads, " << p.locationQueries << " location queries"
+            << std::endl;
+    }
+}
@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef GL_STATS_H_
+#define GL_STATS_H_
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+//
+// Optional instrumentation of the GL calls made by Program, Shader and
+// UniformBuffer.  While enabled, a wrapping GLDispatch table (see
+// gl-dispatch.h) sits in front of the one that was current, and counts and
+// times every call, both per entry point and per program.  Calls that set
+// uniforms are charged to the program bound at the time; calls that name a
+// program are charged to that program.
+//
+// When disabled, the wrapping table is simply not installed, so the cost
+// is nothing at all.
+//
+// A typical use is to take a snapshot, and reset the counters, once per
+// frame:
+//
+//     GLStats::enable();
+//     ...
+//     GLStats::Snapshot frame(GLStats::snapshot());
+//     GLStats::reset();
+//     frame.print(std::cout);
+//
+// Only one thread should make GL calls while the statistics are enabled.
+//
+struct GLStats
+{
+    // Counts for one GL entry point.
+    struct Call
+    {
+        std::string name;
+        uint64_t count;
+        uint64_t nanoseconds;
+    };
+
+    // Counts for one program (by GL handle, see Program::handle()).
+    struct ProgramStats
+    {
+        uint64_t calls;
+        uint64_t nanoseconds;
+        // glUseProgram calls, and those that bound the program that was
+        // already bound.
+        uint64_t binds;
+        uint64_t redundantBinds;
+        // glUniform* calls made while the program was bound.
+        uint64_t uniformUploads;
+        // glGetUniformLocation and glGetAttribLocation calls.
+        uint64_t locationQueries;
+    };
+
+    struct Snapshot
+    {
+        // Only entry points that were called are listed.
+        std::vector<Call> calls;
+        std::map<unsigned int, ProgramStats> programs;
+        uint64_t totalCalls;
+        uint64_t totalNanoseconds;
+
+        // Write the snapshot as a readable table.
+        void print(std::ostream& out) const;
+    };
+
+    // disable() puts back the table that was current at enable(), unless
+    // another has been installed in front of the wrapper since.
+    static void enable();
+    static void disable();
+    static bool enabled();
+
+    // Zero all of the counters.
+    static void reset();
+
+    // The counters since the last reset().
+    static Snapshot snapshot();
+};
+
+#endif // GL_STATS_H_
@@ -51,42 +51,29 @@ scale(float x, float y, float z)
 // |  z'  0  -x' |
 // | -y'  x'  0  |
 //
-// where x', y' and z' are the elements of u
+// where x', y' and z' are the elements of u.  Expanding that out gives
+// each element directly, without building the intermediate matrices.
 //
 mat4
 rotate(float angle, float x, float y, float z)
 {
     vec3 u(x, y, z);
     u.normalize();
-    mat3 uuT = outer(u, u);
-    mat3 s;   
-    s[0][0] = 0;
-    s[0][1] = -u.z();
-    s[0][2] = u.y();
-    s[1][0] = u.z();
-    s[1][1] = 0;
-    s[1][2] = -u.x();
-    s[2][0] = -u.y();
-    s[2][1] = u.x();
-    s[2][2] = 0;
-    mat3 i;
-    i -= uuT;
     // degrees to radians
     float angleRadians(angle * M_PI / 180.0);
-    i *= cos(angleRadians);
-    s *= sin(angleRadians);
-    i += s;
-    mat3 m = uuT + i;
+    float c(cos(angleRadians));
+    float s(sin(angleRadians));
+    float t(1 - c);
     mat4 r;
-    r[0][0] = m[0][0];
-    r[0][1] = m[0][1];
-    r[0][2] = m[0][2];
-    r[1][0] = m[1][0];
-    r[1][1] = m[1][1];
-    r[1][2] = m[1][2];
-    r[2][0] = m[2][0];
-    r[2][1] = m[2][1];
-    r[2][2] = m[2][2];
+    r[0][0] = (u.x() * u.x() * t) + c;
+    r[0][1] = (u.x() * u.y() * t) - (u.z() * s);
+    r[0][2] = (u.x() * u.z() * t) + (u.y() * s);
+    r[1][0] = (u.y() * u.x() * t) + (u.z() * s);
+    r[1][1] = (u.y() * u.y() * t) + c;
+    r[1][2] = (u.y() * u.z() * t) - (u.x() * s);
+    r[2][0] = (u.z() * u.x() * t) - (u.y() * s);
+    r[2][1] = (u.z() * u.y() * t) + (u.x() * s);
+    r[2][2] = (u.z() * u.z() * t) + c;
     return r;
 }
 
@@ -170,4 +157,67 @@ mat4 lookAt(float eyeX, float eyeY, float eyeZ,
 
 } // namespace Mat4
 
+namespace Affine4
+{
+
+affine4
+translate(float x, float y, float z)
+{
+    affine4 t;
+    t[0][3] = x;
+    t[1][3] = y;
+    t[2][3] = z;
+    return t;
+}
+
+affine4
+scale(float x, float y, float z)
+{
+    affine4 s;
+    s[0][0] = x;
+    s[1][1] = y;
+    s[2][2] = z;
+    return s;
+}
+
+affine4
+rotate(float angle, float x, float y, float z)
+{
+    return affine4(Mat4::rotate(angle, x, y, z));
+}
+
+//
+// Same as Mat4::lookAt(), but rather than multiplying in a translation
+// matrix, the translation is rotated into the basis directly.
+//
+affine4
+lookAt(float eyeX, float eyeY, float eyeZ,
+    float centerX, float centerY, float centerZ,
+    float upX, float upY, float upZ)
+{
+    vec3 f(centerX - eyeX, centerY - eyeY, centerZ - eyeZ);
+    f.normalize();
+    vec3 up(upX, upY, upZ);
+    vec3 s = vec3::cross(f, up);
+    vec3 u = vec3::cross(s, f);
+    s.normalize();
+    u.normalize();
+    affine4 la;
+    la[0][0] = s.x();
+    la[0][1] = s.y();
+    la[0][2] = s.z();
+    la[0][3] = -(s.x() * eyeX + s.y() * eyeY + s.z() * eyeZ);
+    la[1][0] = u.x();
+    la[1][1] = u.y();
+    la[1][2] = u.z();
+    la[1][3] = -(u.x() * eyeX + u.y() * eyeY + u.z() * eyeZ);
+    la[2][0] = -f.x();
+    la[2][1] = -f.y();
+    la[2][2] = -f.z();
+    la[2][3] = f.x() * eyeX + f.y() * eyeY + f.z() * eyeZ;
+    return la;
+}
+
+} // namespace Affine4
+
 } // namespace LibMatrix
@@ -15,6 +15,7 @@
 #include <iostream>
 #include <iomanip>
 #include "vec.h"
+#include "simd.h"
 #ifndef USE_EXCEPTIONS
 // If we're not throwing exceptions, we'll need the logger to make sure the
 // caller is informed of errors.
@@ -770,25 +771,49 @@ public:
     }
 
     // Compute the determinant of this and return it.
+    //
+    // This is the Laplace expansion of the determinant in terms of the 2x2
+    // sub-determinants of the top (s0-s5) and bottom (c0-c5) two rows.
     T determinant()
     {
-        tmat3<T> minor0(m_[5], m_[6], m_[7], m_[9], m_[10], m_[11], m_[13], m_[14], m_[15]);
-        tmat3<T> minor4(m_[1], m_[2], m_[3], m_[9], m_[10], m_[11], m_[13], m_[14], m_[15]);
-        tmat3<T> minor8(m_[1], m_[2], m_[3], m_[5], m_[6], m_[7], m_[13], m_[14], m_[15]);
-        tmat3<T> minor12(m_[1], m_[2], m_[3], m_[5], m_[6], m_[7], m_[9], m_[10], m_[11]);
-        return (m_[0] * minor0.determinant()) -
-               (m_[4] * minor4.determinant()) +
-               (m_[8] * minor8.determinant()) -
-               (m_[12] * minor12.determinant());
+        T s0((m_[0] * m_[5]) - (m_[4] * m_[1]));
+        T s1((m_[0] * m_[6]) - (m_[4] * m_[2]));
+        T s2((m_[0] * m_[7]) - (m_[4] * m_[3]));
+        T s3((m_[1] * m_[6]) - (m_[5] * m_[2]));
+        T s4((m_[1] * m_[7]) - (m_[5] * m_[3]));
+        T s5((m_[2] * m_[7]) - (m_[6] * m_[3]));
+        T c5((m_[10] * m_[15]) - (m_[14] * m_[11]));
+        T c4((m_[9] * m_[15]) - (m_[13] * m_[11]));
+        T c3((m_[9] * m_[14]) - (m_[13] * m_[10]));
+        T c2((m_[8] * m_[15]) - (m_[12] * m_[11]));
+        T c1((m_[8] * m_[14]) - (m_[12] * m_[10]));
+        T c0((m_[8] * m_[13]) - (m_[12] * m_[9]));
+        return (s0 * c5) - (s1 * c4) + (s2 * c3) + (s3 * c2) - (s4 * c1) + (s5 * c0);
     }
 
     // Invert this.  Return a reference to this.
     //
+    // Each of the cofactors is a 3x3 determinant, which is put together from
+    // the same twelve 2x2 sub-determinants used by determinant() rather than
+    // being expanded on its own.
+    //
     // NOTE: If this is non-invertible, we will
     //       throw to avoid undefined behavior.
     tmat4& inverse()
     {
-        T d(determinant());
+        T s0((m_[0] * m_[5]) - (m_[4] * m_[1]));
+        T s1((m_[0] * m_[6]) - (m_[4] * m_[2]));
+        T s2((m_[0] * m_[7]) - (m_[4] * m_[3]));
+        T s3((m_[1] * m_[6]) - (m_[5] * m_[2]));
+        T s4((m_[1] * m_[7]) - (m_[5] * m_[3]));
+        T s5((m_[2] * m_[7]) - (m_[6] * m_[3]));
+        T c5((m_[10] * m_[15]) - (m_[14] * m_[11]));
+        T c4((m_[9] * m_[15]) - (m_[13] * m_[11]));
+        T c3((m_[9] * m_[14]) - (m_[13] * m_[10]));
+        T c2((m_[8] * m_[15]) - (m_[12] * m_[11]));
+        T c1((m_[8] * m_[14]) - (m_[12] * m_[10]));
+        T c0((m_[8] * m_[13]) - (m_[12] * m_[9]));
+        T d((s0 * c5) - (s1 * c4) + (s2 * c3) + (s3 * c2) - (s4 * c1) + (s5 * c0));
         if (d == static_cast<T>(0))
         {
 #ifdef USE_EXCEPTIONS
@@ -798,44 +823,143 @@ public:
             return *this;
 #endif // USE_EXCEPTIONS
         }
-        tmat3<T> minor0(m_[5], m_[6], m_[7], m_[9], m_[10], m_[11], m_[13], m_[14], m_[15]);
-        tmat3<T> minor1(m_[1], m_[2], m_[3], m_[13], m_[14], m_[15], m_[9], m_[10], m_[11]);
-        tmat3<T> minor2(m_[1], m_[2], m_[3], m_[5], m_[6], m_[7], m_[13], m_[14], m_[15]);
-        tmat3<T> minor3(m_[1], m_[2], m_[3], m_[9], m_[10], m_[11], m_[5], m_[6], m_[7]);
-
-        tmat3<T> minor4(m_[4], m_[6], m_[7], m_[12], m_[14], m_[15], m_[8], m_[10], m_[11]);
-        tmat3<T> minor5(m_[0], m_[2], m_[3], m_[8], m_[10], m_[11], m_[12], m_[14], m_[15]);
-        tmat3<T> minor6(m_[0], m_[2], m_[3], m_[12], m_[14], m_[15], m_[4], m_[6], m_[7]);
-        tmat3<T> minor7(m_[0], m_[2], m_[3], m_[4], m_[6], m_[7], m_[8], m_[10], m_[11]);
-
-        tmat3<T> minor8(m_[4], m_[5], m_[7], m_[8], m_[9], m_[11], m_[12], m_[13], m_[15]);
-        tmat3<T> minor9(m_[0], m_[1], m_[3], m_[12], m_[13], m_[15], m_[8], m_[9], m_[11]);
-        tmat3<T> minor10(m_[0], m_[1], m_[3], m_[4], m_[5], m_[7], m_[12], m_[13], m_[15]);
-        tmat3<T> minor11(m_[0], m_[1], m_[3], m_[8], m_[9], m_[11], m_[4], m_[5], m_[7]);
-
-        tmat3<T> minor12(m_[4], m_[5], m_[6], m_[12], m_[13], m_[14], m_[8], m_[9], m_[10]);
-        tmat3<T> minor13(m_[0], m_[1], m_[2], m_[8], m_[9], m_[10], m_[12], m_[13], m_[14]);
-        tmat3<T> minor14(m_[0], m_[1], m_[2], m_[12], m_[13], m_[14], m_[4], m_[5], m_[6]);
-        tmat3<T> minor15(m_[0], m_[1], m_[2], m_[4], m_[5], m_[6], m_[8], m_[9], m_[10]);
-        m_[0] = minor0.determinant() / d;
-        m_[1] = minor1.determinant() / d;
-        m_[2] = minor2.determinant() / d;
-        m_[3] = minor3.determinant() / d;
-        m_[4] = minor4.determinant() / d;
-        m_[5] = minor5.determinant() / d;
-        m_[6] = minor6.determinant() / d;
-        m_[7] = minor7.determinant() / d;
-        m_[8] = minor8.determinant() / d;
-        m_[9] = minor9.determinant() / d;
-        m_[10] = minor10.determinant() / d;
-        m_[11] = minor11.determinant() / d;
-        m_[12] = minor12.determinant() / d;
-        m_[13] = minor13.determinant() / d;
-        m_[14] = minor14.determinant() / d;
-        m_[15] = minor15.determinant() / d;
+        T i0(((m_[5] * c5) - (m_[6] * c4) + (m_[7] * c3)) / d);
+        T i1((-(m_[1] * c5) + (m_[2] * c4) - (m_[3] * c3)) / d);
+        T i2(((m_[13] * s5) - (m_[14] * s4) + (m_[15] * s3)) / d);
+        T i3((-(m_[9] * s5) + (m_[10] * s4) - (m_[11] * s3)) / d);
+        T i4((-(m_[4] * c5) + (m_[6] * c2) - (m_[7] * c1)) / d);
+        T i5(((m_[0] * c5) - (m_[2] * c2) + (m_[3] * c1)) / d);
+        T i6((-(m_[12] * s5) + (m_[14] * s2) - (m_[15] * s1)) / d);
+        T i7(((m_[8] * s5) - (m_[10] * s2) + (m_[11] * s1)) / d);
+        T i8(((m_[4] * c4) - (m_[5] * c2) + (m_[7] * c0)) / d);
+        T i9((-(m_[0] * c4) + (m_[1] * c2) - (m_[3] * c0)) / d);
+        T i10(((m_[12] * s4) - (m_[13] * s2) + (m_[15] * s0)) / d);
+        T i11((-(m_[8] * s4) + (m_[9] * s2) - (m_[11] * s0)) / d);
+        T i12((-(m_[4] * c3) + (m_[5] * c1) - (m_[6] * c0)) / d);
+        T i13(((m_[0] * c3) - (m_[1] * c1) + (m_[2] * c0)) / d);
+        T i14((-(m_[12] * s3) + (m_[13] * s1) - (m_[14] * s0)) / d);
+        T i15(((m_[8] * s3) - (m_[9] * s1) + (m_[10] * s0)) / d);
+        m_[0] = i0;
+        m_[1] = i1;
+        m_[2] = i2;
+        m_[3] = i3;
+        m_[4] = i4;
+        m_[5] = i5;
+        m_[6] = i6;
+        m_[7] = i7;
+        m_[8] = i8;
+        m_[9] = i9;
+        m_[10] = i10;
+        m_[11] = i11;
+        m_[12] = i12;
+        m_[13] = i13;
+        m_[14] = i14;
+        m_[15] = i15;
+        return *this;
+    }
+
+    // Invert this, assuming it is an affine transform (i.e., the bottom row
+    // is (0, 0, 0, 1)).  The upper 3x3 is inverted on its own, and the
+    // translation carried back through it.  Return a reference to this.
+    //
+    // NOTE: If this is non-invertible, we will
+    //       throw to avoid undefined behavior.
+    tmat4& inverse_affine()
+    {
+        T r0c0((m_[5] * m_[10]) - (m_[6] * m_[9]));
+        T r0c1((m_[6] * m_[8]) - (m_[4] * m_[10]));
+        T r0c2((m_[4] * m_[9]) - (m_[5] * m_[8]));
+        T d((m_[0] * r0c0) + (m_[1] * r0c1) + (m_[2] * r0c2));
+        if (d == static_cast<T>(0))
+        {
+#ifdef USE_EXCEPTIONS
+            throw std::runtime_error("Matrix is noninvertible!!!!");
+#else // !USE_EXCEPTIONS
+            Log::error("Matrix is noninvertible!!!!\n");
+            return *this;
+#endif // USE_EXCEPTIONS
+        }
+        r0c0 /= d;
+        r0c1 /= d;
+        r0c2 /= d;
+        T r1c0(((m_[9] * m_[2]) - (m_[10] * m_[1])) / d);
+        T r1c1(((m_[10] * m_[0]) - (m_[8] * m_[2])) / d);
+        T r1c2(((m_[8] * m_[1]) - (m_[9] * m_[0])) / d);
+        T r2c0(((m_[1] * m_[6]) - (m_[2] * m_[5])) / d);
+        T r2c1(((m_[2] * m_[4]) - (m_[0] * m_[6])) / d);
+        T r2c2(((m_[0] * m_[5]) - (m_[1] * m_[4])) / d);
+        T tx(m_[12]);
+        T ty(m_[13]);
+        T tz(m_[14]);
+        m_[0] = r0c0;
+        m_[1] = r1c0;
+        m_[2] = r2c0;
+        m_[4] = r0c1;
+        m_[5] = r1c1;
+        m_[6] = r2c1;
+        m_[8] = r0c2;
+        m_[9] = r1c2;
+        m_[10] = r2c2;
+        m_[12] = -((r0c0 * tx) + (r0c1 * ty) + (r0c2 * tz));
+        m_[13] = -((r1c0 * tx) + (r1c1 * ty) + (r1c2 * tz));
+        m_[14] = -((r2c0 * tx) + (r2c1 * ty) + (r2c2 * tz));
         return *this;
     }
 
+    // Invert this, assuming it is a rigid transform (an orthonormal rotation
+    // followed by a translation), as produced by Mat4::rotate(), translate()
+    // and lookAt().  The inverse rotation is just the transpose, so this
+    // involves no division and cannot fail.  Return a reference to this.
+    tmat4& inverse_rigid()
+    {
+        T tmp_val = m_[1];
+        m_[1] = m_[4];
+        m_[4] = tmp_val;
+        tmp_val = m_[2];
+        m_[2] = m_[8];
+        m_[8] = tmp_val;
+        tmp_val = m_[6];
+        m_[6] = m_[9];
+        m_[9] = tmp_val;
+        T tx(m_[12]);
+        T ty(m_[13]);
+        T tz(m_[14]);
+        m_[12] = -((m_[0] * tx) + (m_[4] * ty) + (m_[8] * tz));
+        m_[13] = -((m_[1] * tx) + (m_[5] * ty) + (m_[9] * tz));
+        m_[14] = -((m_[2] * tx) + (m_[6] * ty) + (m_[10] * tz));
+        return *this;
+    }
+
+    // Compute the inverse transpose of the upper 3x3 of this, which is what
+    // transforms normals.  Its columns are the cross products of the
+    // columns of the upper 3x3, over the determinant.  Return the result.
+    //
+    // NOTE: If the upper 3x3 is non-invertible, we will throw to avoid
+    //       undefined behavior (or, without exceptions, return it as is).
+    const tmat3<T> inverse_transpose3x3() const
+    {
+        T c0r0((m_[5] * m_[10]) - (m_[6] * m_[9]));
+        T c0r1((m_[6] * m_[8]) - (m_[4] * m_[10]));
+        T c0r2((m_[4] * m_[9]) - (m_[5] * m_[8]));
+        T d((m_[0] * c0r0) + (m_[1] * c0r1) + (m_[2] * c0r2));
+        if (d == static_cast<T>(0))
+        {
+#ifdef USE_EXCEPTIONS
+            throw std::runtime_error("Matrix is noninvertible!!!!");
+#else // !USE_EXCEPTIONS
+            Log::error("Matrix is noninvertible!!!!\n");
+            return tmat3<T>(m_[0], m_[1], m_[2], m_[4], m_[5], m_[6], m_[8], m_[9], m_[10]);
+#endif // USE_EXCEPTIONS
+        }
+        return tmat3<T>(c0r0 / d, c0r1 / d, c0r2 / d,
+                        ((m_[9] * m_[2]) - (m_[10] * m_[1])) / d,
+                        ((m_[10] * m_[0]) - (m_[8] * m_[2])) / d,
+                        ((m_[8] * m_[1]) - (m_[9] * m_[0])) / d,
+                        ((m_[1] * m_[6]) - (m_[2] * m_[5])) / d,
+                        ((m_[2] * m_[4]) - (m_[0] * m_[6])) / d,
+                        ((m_[0] * m_[5]) - (m_[1] * m_[4])) / d);
+    }
+
     // Print the elements of the matrix to standard out.
     // Really only useful for debug and test.
     void print() const
@@ -1112,6 +1236,52 @@ private:
     T m_[16];
 };
 
+// Multiplication and inversion of single and double precision matrices are
+// the hot paths for concatenating transforms, so hand them to the vectorized
+// kernels (picked for the host CPU at startup) rather than relying on the
+// compiler to spot the column broadcasts and shared sub-determinants.
+template<>
+inline tmat4<float>& tmat4<float>::operator*=(const tmat4<float>& rhs)
+{
+    Simd::mat4_multiply(m_, m_, rhs.m_);
+    return *this;
+}
+
+template<>
+inline tmat4<double>& tmat4<double>::operator*=(const tmat4<double>& rhs)
+{
+    Simd::mat4_multiply(m_, m_, rhs.m_);
+    return *this;
+}
+
+template<>
+inline tmat4<float>& tmat4<float>::inverse()
+{
+    if (!Simd::mat4_inverse(m_, m_))
+    {
+#ifdef USE_EXCEPTIONS
+        throw std::runtime_error("Matrix is noninvertible!!!!");
+#else // !USE_EXCEPTIONS
+        Log::error("Matrix is noninvertible!!!!\n");
+#endif // USE_EXCEPTIONS
+    }
+    return *this;
+}
+
+template<>
+inline tmat4<double>& tmat4<double>::inverse()
+{
+    if (!Simd::mat4_inverse(m_, m_))
+    {
+#ifdef USE_EXCEPTIONS
+        throw std::runtime_error("Matrix is noninvertible!!!!");
+#else // !USE_EXCEPTIONS
+        Log::error("Matrix is noninvertible!!!!\n");
+#endif // USE_EXCEPTIONS
+    }
+    return *this;
+}
+
 // Multiply a scalar and a matrix just like the member operator, but allow
 // the scalar to be the left-hand operand.
 template<typename T>
@@ -1168,6 +1338,276 @@ const tmat4<T> outer(const tvec4<T>& a, const tvec4<T>& b)
     return product;
 }
 
+// A template class for an affine transform, stored as the top three rows of
+// a 4x4 matrix whose bottom row is implicitly (0, 0, 0, 1).  This covers
+// everything produced by Mat4::translate(), scale(), rotate() and lookAt(),
+// in 12 elements instead of 16.  Knowing the bottom row lets composition
+// skip a quarter of the work of tmat4 (36 multiplies rather than 64),
+// inversion reduce to a 3x3 inverse plus a translation, and points be
+// transformed without a w-divide.  Promote to a tmat4 with to_mat4() when
+// a full matrix is needed, e.g. for a mat4 uniform.
+//
+// Storage is column-major like the other matrix classes (four columns of
+// three elements), which is the layout GLSL expects for a mat4x3.
+template<typename T>
+class taffine4
+{
+public:
+    taffine4()
+    {
+        setIdentity();
+    }
+    // Take the top three rows of a 4x4 matrix.  The bottom row is assumed
+    // to be (0, 0, 0, 1) and is not checked.
+    explicit taffine4(const tmat4<T>& m)
+    {
+        for (int col = 0; col < 4; col++)
+        {
+            for (int row = 0; row < 3; row++)
+            {
+                m_[col * 3 + row] = m[row][col];
+            }
+        }
+    }
+    ~taffine4() {}
+
+    // Reset this to the identity transform.
+    void setIdentity()
+    {
+        m_[0] = 1;
+        m_[1] = 0;
+        m_[2] = 0;
+        m_[3] = 0;
+        m_[4] = 1;
+        m_[5] = 0;
+        m_[6] = 0;
+        m_[7] = 0;
+        m_[8] = 1;
+        m_[9] = 0;
+        m_[10] = 0;
+        m_[11] = 0;
+    }
+
+    // Return the equivalent 4x4 matrix.
+    const tmat4<T> to_mat4() const
+    {
+        tmat4<T> m;
+        for (int col = 0; col < 4; col++)
+        {
+            for (int row = 0; row < 3; row++)
+            {
+                m[row][col] = m_[col * 3 + row];
+            }
+        }
+        return m;
+    }
+
+    // Compute the determinant of this (that of the upper 3x3) and return it.
+    T determinant() const
+    {
+        return (m_[0] * ((m_[4] * m_[8]) - (m_[5] * m_[7]))) +
+               (m_[1] * ((m_[5] * m_[6]) - (m_[3] * m_[8]))) +
+               (m_[2] * ((m_[3] * m_[7]) - (m_[4] * m_[6])));
+    }
+
+    // Invert this.  Return a reference to this.
+    //
+    // The rows of the inverse of the upper 3x3 are the cross products of
+    // its columns over the determinant, and the inverse translation is the
+    // original one carried back through that.
+    //
+    // NOTE: If this is non-invertible, we will
+    //       throw to avoid undefined behavior.
+    taffine4& inverse()
+    {
+        T d(determinant());
+        if (d == static_cast<T>(0))
+        {
+#ifdef USE_EXCEPTIONS
+            throw std::runtime_error("Matrix is noninvertible!!!!");
+#else // !USE_EXCEPTIONS
+            Log::error("Matrix is noninvertible!!!!\n");
+            return *this;
+#endif // USE_EXCEPTIONS
+        }
+        T r0c0(((m_[4] * m_[8]) - (m_[5] * m_[7])) / d);
+        T r0c1(((m_[5] * m_[6]) - (m_[3] * m_[8])) / d);
+        T r0c2(((m_[3] * m_[7]) - (m_[4] * m_[6])) / d);
+        T r1c0(((m_[7] * m_[2]) - (m_[8] * m_[1])) / d);
+        T r1c1(((m_[8] * m_[0]) - (m_[6] * m_[2])) / d);
+        T r1c2(((m_[6] * m_[1]) - (m_[7] * m_[0])) / d);
+        T r2c0(((m_[1] * m_[5]) - (m_[2] * m_[4])) / d);
+        T r2c1(((m_[2] * m_[3]) - (m_[0] * m_[5])) / d);
+        T r2c2(((m_[0] * m_[4]) - (m_[1] * m_[3])) / d);
+        T tx(m_[9]);
+        T ty(m_[10]);
+        T tz(m_[11]);
+        m_[0] = r0c0;
+        m_[1] = r1c0;
+        m_[2] = r2c0;
+        m_[3] = r0c1;
+        m_[4] = r1c1;
+        m_[5] = r2c1;
+        m_[6] = r0c2;
+        m_[7] = r1c2;
+        m_[8] = r2c2;
+        m_[9] = -((r0c0 * tx) + (r0c1 * ty) + (r0c2 * tz));
+        m_[10] = -((r1c0 * tx) + (r1c1 * ty) + (r1c2 * tz));
+        m_[11] = -((r2c0 * tx) + (r2c1 * ty) + (r2c2 * tz));
+        return *this;
+    }
+
+    // Transform a point (implied w of 1) by this.
+    const tvec3<T> transform_point(const tvec3<T>& p) const
+    {
+        return tvec3<T>((m_[0] * p.x()) + (m_[3] * p.y()) + (m_[6] * p.z()) + m_[9],
+                        (m_[1] * p.x()) + (m_[4] * p.y()) + (m_[7] * p.z()) + m_[10],
+                        (m_[2] * p.x()) + (m_[5] * p.y()) + (m_[8] * p.z()) + m_[11]);
+    }
+
+    // Transform a direction (implied w of 0) by this.
+    const tvec3<T> transform_vector(const tvec3<T>& v) const
+    {
+        return tvec3<T>((m_[0] * v.x()) + (m_[3] * v.y()) + (m_[6] * v.z()),
+                        (m_[1] * v.x()) + (m_[4] * v.y()) + (m_[7] * v.z()),
+                        (m_[2] * v.x()) + (m_[5] * v.y()) + (m_[8] * v.z()));
+    }
+
+    // Print the elements of the matrix (including the implied bottom row)
+    // to standard out.  Really only useful for debug and test.
+    void print() const
+    {
+        to_mat4().print();
+    }
+
+    // Allow raw data access for API calls and the like.
+    // For example, it is valid to pass a taffine4<float> into a call to
+    // the OpenGL command "glUniformMatrix4x3fv()".
+    operator const T*() const { return &m_[0];}
+
+    // Test if 'rhs' is equal to this.
+    bool operator==(const taffine4& rhs) const
+    {
+        return m_[0] == rhs.m_[0] &&
+               m_[1] == rhs.m_[1] &&
+               m_[2] == rhs.m_[2] &&
+               m_[3] == rhs.m_[3] &&
+               m_[4] == rhs.m_[4] &&
+               m_[5] == rhs.m_[5] &&
+               m_[6] == rhs.m_[6] &&
+               m_[7] == rhs.m_[7] &&
+               m_[8] == rhs.m_[8] &&
+               m_[9] == rhs.m_[9] &&
+               m_[10] == rhs.m_[10] &&
+               m_[11] == rhs.m_[11];
+    }
+
+    // Test if 'rhs' is not equal to this.
+    bool operator!=(const taffine4& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    // Compose this with another affine transform (this = this * rhs).
+    // Return a reference to this.
+    taffine4& operator*=(const taffine4& rhs)
+    {
+        T c0r0((m_[0] * rhs.m_[0]) + (m_[3] * rhs.m_[1]) + (m_[6] * rhs.m_[2]));
+        T c0r1((m_[1] * rhs.m_[0]) + (m_[4] * rhs.m_[1]) + (m_[7] * rhs.m_[2]));
+        T c0r2((m_[2] * rhs.m_[0]) + (m_[5] * rhs.m_[1]) + (m_[8] * rhs.m_[2]));
+        T c1r0((m_[0] * rhs.m_[3]) + (m_[3] * rhs.m_[4]) + (m_[6] * rhs.m_[5]));
+        T c1r1((m_[1] * rhs.m_[3]) + (m_[4] * rhs.m_[4]) + (m_[7] * rhs.m_[5]));
+        T c1r2((m_[2] * rhs.m_[3]) + (m_[5] * rhs.m_[4]) + (m_[8] * rhs.m_[5]));
+        T c2r0((m_[0] * rhs.m_[6]) + (m_[3] * rhs.m_[7]) + (m_[6] * rhs.m_[8]));
+        T c2r1((m_[1] * rhs.m_[6]) + (m_[4] * rhs.m_[7]) + (m_[7] * rhs.m_[8]));
+        T c2r2((m_[2] * rhs.m_[6]) + (m_[5] * rhs.m_[7]) + (m_[8] * rhs.m_[8]));
+        T c3r0((m_[0] * rhs.m_[9]) + (m_[3] * rhs.m_[10]) + (m_[6] * rhs.m_[11]) + m_[9]);
+        T c3r1((m_[1] * rhs.m_[9]) + (m_[4] * rhs.m_[10]) + (m_[7] * rhs.m_[11]) + m_[10]);
+        T c3r2((m_[2] * rhs.m_[9]) + (m_[5] * rhs.m_[10]) + (m_[8] * rhs.m_[11]) + m_[11]);
+        m_[0] = c0r0;
+        m_[1] = c0r1;
+        m_[2] = c0r2;
+        m_[3] = c1r0;
+        m_[4] = c1r1;
+        m_[5] = c1r2;
+        m_[6] = c2r0;
+        m_[7] = c2r1;
+        m_[8] = c2r2;
+        m_[9] = c3r0;
+        m_[10] = c3r1;
+        m_[11] = c3r2;
+        return *this;
+    }
+
+    // Compose a copy of this with another affine transform.  Return the copy.
+    const taffine4 operator*(const taffine4& rhs) const
+    {
+        return taffine4(*this) *= rhs;
+    }
+
+    // Compose this with a translation (this = this * T(x, y, z)).  Only the
+    // translation column changes.  Return a reference to this.
+    taffine4& translate(const T& x, const T& y, const T& z)
+    {
+        m_[9] += (m_[0] * x) + (m_[3] * y) + (m_[6] * z);
+        m_[10] += (m_[1] * x) + (m_[4] * y) + (m_[7] * z);
+        m_[11] += (m_[2] * x) + (m_[5] * y) + (m_[8] * z);
+        return *this;
+    }
+
+    // Compose this with a scale (this = this * S(x, y, z)).  Each of the
+    // first three columns is just scaled.  Return a reference to this.
+    taffine4& scale(const T& x, const T& y, const T& z)
+    {
+        m_[0] *= x;
+        m_[1] *= x;
+        m_[2] *= x;
+        m_[3] *= y;
+        m_[4] *= y;
+        m_[5] *= y;
+        m_[6] *= z;
+        m_[7] *= z;
+        m_[8] *= z;
+        return *this;
+    }
+
+    // Use an instance of the ArrayProxy class to support double-indexed
+    // references to a matrix (i.e., m[1][1]).  Only rows 0 through 2 are
+    // stored.  See comments above the ArrayProxy definition for more
+    // details.
+    ArrayProxy<T, 3> operator[](int index)
+    {
+        return ArrayProxy<T, 3>(&m_[index]);
+    }
+    const ArrayProxy<T, 3> operator[](int index) const
+    {
+        return ArrayProxy<T, 3>(const_cast<T*>(&m_[index]));
+    }
+
+private:
+    T m_[12];
+};
+
+// Multiply a full matrix by an affine transform (e.g. a projection by a
+// modelview).  Return the resultant matrix.  The implied bottom row of
+// 'rhs' saves 16 of the multiplies of a general product.
+template<typename T>
+const tmat4<T> operator*(const tmat4<T>& lhs, const taffine4<T>& rhs)
+{
+    tmat4<T> product;
+    for (int row = 0; row < 4; row++)
+    {
+        for (int col = 0; col < 4; col++)
+        {
+            T sum((lhs[row][0] * rhs[0][col]) +
+                  (lhs[row][1] * rhs[1][col]) +
+                  (lhs[row][2] * rhs[2][col]));
+            product[row][col] = (col == 3) ? sum + lhs[row][3] : sum;
+        }
+    }
+    return product;
+}
+
 //
 // Convenience typedefs.  These are here to present a homogeneous view of these
 // objects with respect to shader source.
@@ -1175,10 +1615,12 @@ const tmat4<T> outer(const tvec4<T>& a, const tvec4<T>& b)
 typedef tmat2<float> mat2;
 typedef tmat3<float> mat3;
 typedef tmat4<float> mat4;
+typedef taffine4<float> affine4;
 
 typedef tmat2<double> dmat2;
 typedef tmat3<double> dmat3;
 typedef tmat4<double> dmat4;
+typedef taffine4<double> daffine4;
 
 typedef tmat2<int> imat2;
 typedef tmat3<int> imat3;
@@ -1208,5 +1650,19 @@ mat4 perspective(float fovy, float aspect, float zNear, float zFar);
 mat4 lookAt(float eyeX, float eyeY, float eyeZ, float centerX, float centerY, float centerZ, float upX, float upY, float upZ);
 
 } // namespace Mat4
+
+namespace Affine4
+{
+
+//
+// Counterparts of the Mat4 functions above that only ever produce affine
+// transforms.
+//
+affine4 translate(float x, float y, float z);
+affine4 scale(float x, float y, float z);
+affine4 rotate(float angle, float x, float y, float z);
+affine4 lookAt(float eyeX, float eyeY, float eyeZ, float centerX, float centerY, float centerZ, float upX, float upY, float upZ);
+
+} // namespace Affine4
 } // namespace LibMatrix
 #endif // MAT_H_
@@ -10,12 +10,17 @@
 //     Jesse Barker - original implementation.
 //
 #include <string>
+#include <cstring>
 #include <vector>
+#include <algorithm>
 #include <sstream>
 #include <fstream>
 #include <iostream>
-#include "gl-if.h"
+#include <iomanip>
+#include <filesystem>
+#include "gl-dispatch.h"
 #include "program.h"
+#include "util.h"
 
 using std::string;
 using LibMatrix::mat4;
@@ -24,24 +29,32 @@ using LibMatrix::vec2;
 using LibMatrix::vec3;
 using LibMatrix::vec4;
 
+// All GL calls go through the current dispatch table (see gl-dispatch.h).
+static inline const GLDispatch&
+gl()
+{
+    return GLDispatch::get();
+}
+
 Shader::Shader(unsigned int type, const string& source) :
     handle_(0),
     type_(type),
     source_(source),
+    submitted_(false),
     ready_(false),
     valid_(false)
 {
     // Create our shader and setup the source code.
-    handle_ = glCreateShader(type);
+    handle_ = gl().CreateShader(type);
     if (!handle_)
     {
         message_ = string("Failed to create the new shader.");
         return;
     }
     const GLchar* shaderSource = source_.c_str();
-    glShaderSource(handle_, 1, &shaderSource, NULL);
+    gl().ShaderSource(handle_, 1, &shaderSource, NULL);
     GLint param = 0;
-    glGetShaderiv(handle_, GL_SHADER_SOURCE_LENGTH, &param);
+    gl().GetShaderiv(handle_, GL_SHADER_SOURCE_LENGTH, &param);
     if (static_cast<unsigned int>(param) != source_.length() + 1)
     {
         std::ostringstream o(string("Expected shader source length "));
@@ -68,14 +81,18 @@ Shader::compile()
     {
         return;
     }
-    glCompileShader(handle_);
+    if (!submitted_)
+    {
+        gl().CompileShader(handle_);
+    }
+    submitted_ = false;
     GLint param = 0;
-    glGetShaderiv(handle_, GL_COMPILE_STATUS, &param);
+    gl().GetShaderiv(handle_, GL_COMPILE_STATUS, &param);
     if (param == GL_FALSE)
     {
-        glGetShaderiv(handle_, GL_INFO_LOG_LENGTH, &param);
+        gl().GetShaderiv(handle_, GL_INFO_LOG_LENGTH, &param);
         GLchar* infoLog = new GLchar[param + 1];
-        glGetShaderInfoLog(handle_, param + 1, NULL, infoLog);
+        gl().GetShaderInfoLog(handle_, param + 1, NULL, infoLog);
         message_ = infoLog;
         delete [] infoLog;
         return;
@@ -83,15 +100,27 @@ Shader::compile()
     ready_ = true;
 }
 
+void
+Shader::submit()
+{
+    if (!valid_ || ready_ || submitted_)
+    {
+        return;
+    }
+    gl().CompileShader(handle_);
+    submitted_ = true;
+}
+
 void
 Shader::attach(unsigned int program)
 {
-    // Shader must be valid and compiled to be attached to a program.
-    if (!valid_ || !ready_)
+    // Shader must be valid and compiled (or at least submitted for
+    // compilation) to be attached to a program.
+    if (!valid_ || !(ready_ || submitted_))
     {
         return;
     }
-    glAttachShader(program, handle_);
+    gl().AttachShader(program, handle_);
 }
 
 void
@@ -99,21 +128,37 @@ Shader::release()
 {
     if (handle_)
     {
-        glDeleteShader(handle_);
+        gl().DeleteShader(handle_);
     }
     handle_ = 0;
     type_ = 0;
+    submitted_ = false;
     ready_ = false;
     valid_ = false;
 }
 
 Program::Program() :
     handle_(0),
+    numSymbols_(0),
+    namePoolUsed_(0),
+    namePoolSize_(0),
+    fromBinaryCache_(false),
+    async_(false),
+    linkPending_(false),
+    pendingKey_(0),
+    pendingUseCache_(false),
+    parallelCompile_(-1),
     ready_(false),
     valid_(false)
 {
 }
 
+Program::Program(Program&& program) noexcept :
+    Program()
+{
+    moveFrom(program);
+}
+
 Program::~Program()
 {
     // First release all of the shader resources attached to us and clean up
@@ -121,10 +166,53 @@ Program::~Program()
     release();
 }
 
+Program&
+Program::operator=(Program&& program) noexcept
+{
+    if (this != &program)
+    {
+        release();
+        moveFrom(program);
+    }
+    return *this;
+}
+
+// Take over everything from another program, leaving it empty.  The symbol
+// blocks and name pool chunks are moved as a whole, so the symbols (and
+// references to them) stay where they are.
+void
+Program::moveFrom(Program& program)
+{
+    handle_ = std::exchange(program.handle_, 0);
+    symbolBlocks_ = std::move(program.symbolBlocks_);
+    numSymbols_ = std::exchange(program.numSymbols_, 0);
+    namePool_ = std::move(program.namePool_);
+    namePoolUsed_ = std::exchange(program.namePoolUsed_, 0);
+    namePoolSize_ = std::exchange(program.namePoolSize_, 0);
+    symbolIndex_ = std::move(program.symbolIndex_);
+    stagedSlot_ = std::move(program.stagedSlot_);
+    staged_ = std::move(program.staged_);
+    stagedLocations_ = std::move(program.stagedLocations_);
+    staging_ = std::move(program.staging_);
+    flushing_ = std::move(program.flushing_);
+    shaders_ = std::move(program.shaders_);
+    binaryCache_ = std::move(program.binaryCache_);
+    sources_ = std::move(program.sources_);
+    fromBinaryCache_ = std::exchange(program.fromBinaryCache_, false);
+    async_ = std::exchange(program.async_, false);
+    linkPending_ = std::exchange(program.linkPending_, false);
+    pendingKey_ = std::exchange(program.pendingKey_, 0);
+    pendingUseCache_ = std::exchange(program.pendingUseCache_, false);
+    parallelCompile_ = std::exchange(program.parallelCompile_, -1);
+    message_ = std::move(program.message_);
+    ready_ = std::exchange(program.ready_, false);
+    valid_ = std::exchange(program.valid_, false);
+}
+
 void
 Program::init()
 {
-    handle_ = glCreateProgram();
+    handle_ = gl().CreateProgram();
     if (!handle_)
     {
         message_ = string("Failed to create the new program");
@@ -149,16 +237,33 @@ Program::release()
     // Clear out the error string to make sure we don't return anything stale.
     message_.clear();
 
-    // Release all of the symbol map resources.
-    for (std::map<string, Symbol*>::iterator symbolIt = symbols_.begin(); symbolIt != symbols_.end(); symbolIt++)
-    {
-        delete (*symbolIt).second;
-    }
-    symbols_.clear();
+    // Release all of the symbol resources.  This frees whole blocks and
+    // pool chunks, not individual symbols.
+    symbolBlocks_.clear();
+    numSymbols_ = 0;
+    namePool_.clear();
+    namePoolUsed_ = 0;
+    namePoolSize_ = 0;
+    symbolIndex_.clear();
+    sources_.clear();
+    fromBinaryCache_ = false;
+    linkPending_ = false;
+    parallelCompile_ = -1;
+    stagedSlot_.clear();
+    staged_.clear();
+    stagedLocations_.clear();
+    staging_ = StagingBuffer();
+    flushing_ = StagingBuffer();
 
     if (handle_)
     {
-        glDeleteProgram(handle_);
+        // The name may be reused by the next program created, which must
+        // not be taken for already bound.
+        if (binding_.program == handle_)
+        {
+            binding_.program = NoBinding;
+        }
+        gl().DeleteProgram(handle_);
     }
     handle_ = 0;
     ready_ = false;
@@ -172,6 +277,19 @@ Program::addShader(unsigned int type, const string& source)
         return;
     }
 
+    if (async_ || !binaryCache_.empty())
+    {
+        // Compilation waits for the build, which may not need it at all.
+        sources_.push_back(std::make_pair(type, source));
+        return;
+    }
+
+    compileShader(type, source);
+}
+
+void
+Program::compileShader(unsigned int type, const string& source)
+{
     Shader shader(type, source);
     if (!shader.valid())
     {
@@ -197,30 +315,476 @@ Program::addShader(unsigned int type, const string& source)
 void
 Program::build()
 {
-    if (!valid_ || ready_)
+    uint64_t key(0);
+    bool useCache(false);
+    if (!startBuild(key, useCache))
     {
         return;
     }
 
-    if (shaders_.empty())
+    for (std::vector<std::pair<unsigned int, string> >::const_iterator sourceIt = sources_.begin(); sourceIt != sources_.end(); sourceIt++)
+    {
+        compileShader(sourceIt->first, sourceIt->second);
+        if (!valid_)
+        {
+            return;
+        }
+    }
+
+    gl().LinkProgram(handle_);
+    finishBuild(key, useCache);
+}
+
+void
+Program::buildAsync()
+{
+    if (linkPending_)
     {
-        message_ = string("There are no shaders attached to this program");
         return;
     }
 
-    glLinkProgram(handle_);
+    uint64_t key(0);
+    bool useCache(false);
+    if (!startBuild(key, useCache))
+    {
+        return;
+    }
+
+    // Queue up every compile and the link without checking any status, as
+    // any query would wait for the driver to finish.
+    for (std::vector<std::pair<unsigned int, string> >::const_iterator sourceIt = sources_.begin(); sourceIt != sources_.end(); sourceIt++)
+    {
+        Shader shader(sourceIt->first, sourceIt->second);
+        if (!shader.valid())
+        {
+            message_ = shader.errorMessage();
+            valid_ = false;
+            return;
+        }
+        shader.submit();
+        shader.attach(handle_);
+        shaders_.push_back(std::move(shader));
+    }
+
+    gl().LinkProgram(handle_);
+    linkPending_ = true;
+    pendingKey_ = key;
+    pendingUseCache_ = useCache;
+}
+
+Program::BuildStatus
+Program::poll()
+{
+    if (linkPending_)
+    {
+        if (parallelCompile())
+        {
+            GLint param = GL_FALSE;
+            gl().GetProgramiv(handle_, GL_COMPLETION_STATUS_KHR, &param);
+            if (param == GL_FALSE)
+            {
+                return BuildPending;
+            }
+        }
+        linkPending_ = false;
+        finishBuild(pendingKey_, pendingUseCache_);
+    }
+    return ready_ ? BuildReady : BuildFailed;
+}
+
+//
+// The common start of build() and buildAsync().  Returns true if the
+// shaders still need to be compiled and linked, or false if there is
+// nothing more to do (either the program is finished, loaded from the
+// binary cache, or cannot be built).
+//
+bool
+Program::startBuild(uint64_t& key, bool& useCache)
+{
+    if (!valid_ || ready_)
+    {
+        return false;
+    }
+
+    if (shaders_.empty() && sources_.empty())
+    {
+        message_ = string("There are no shaders attached to this program");
+        return false;
+    }
+
+    // With the binary cache enabled, try to load a previously linked
+    // program, and only compile the shaders if that fails.
+    if (!binaryCache_.empty())
+    {
+        GLint formats(0);
+        gl().GetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        useCache = formats > 0;
+        if (useCache)
+        {
+            key = binaryKey();
+            if (loadBinary(key))
+            {
+                fromBinaryCache_ = true;
+                ready_ = true;
+                reflect();
+                return false;
+            }
+            gl().ProgramParameteri(handle_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+    }
+    return true;
+}
+
+//
+// Collect the results of a link (and, for an async build, the compiles
+// before it).
+//
+void
+Program::finishBuild(uint64_t key, bool useCache)
+{
+    // A shader that failed to compile gives a more useful message than the
+    // link failure it causes.
+    for (std::vector<Shader>::iterator shaderIt = shaders_.begin(); shaderIt != shaders_.end(); shaderIt++)
+    {
+        shaderIt->compile();
+        if (!shaderIt->ready())
+        {
+            message_ = shaderIt->errorMessage();
+            valid_ = false;
+            return;
+        }
+    }
+
     GLint param = 1;
-    glGetProgramiv(handle_, GL_LINK_STATUS, &param);
+    gl().GetProgramiv(handle_, GL_LINK_STATUS, &param);
     if (param == GL_FALSE)
     {
-        glGetProgramiv(handle_, GL_INFO_LOG_LENGTH, &param);
+        gl().GetProgramiv(handle_, GL_INFO_LOG_LENGTH, &param);
         GLchar* infoLog = new GLchar[param + 1];
-        glGetProgramInfoLog(handle_, param + 1, NULL, infoLog);
+        gl().GetProgramInfoLog(handle_, param + 1, NULL, infoLog);
         message_ = infoLog;
         delete [] infoLog;
         return;
     }
     ready_ = true;
+    if (useCache)
+    {
+        saveBinary(key);
+    }
+    reflect();
+}
+
+//
+// GL_KHR_parallel_shader_compile (or its ARB twin) adds the completion
+// status query that lets poll() avoid blocking.
+//
+bool
+Program::parallelCompile()
+{
+    if (parallelCompile_ < 0)
+    {
+        parallelCompile_ = 0;
+        GLint count(0);
+        gl().GetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++)
+        {
+            const char* name = reinterpret_cast<const char*>(gl().GetStringi(GL_EXTENSIONS, i));
+            if (name && (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0 ||
+                         std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0))
+            {
+                parallelCompile_ = 1;
+                break;
+            }
+        }
+    }
+    return parallelCompile_ == 1;
+}
+
+void
+Program::setBinaryCache(const string& directory)
+{
+    binaryCache_ = directory;
+}
+
+//
+// The cache key covers the driver identity as well as the shader sources,
+// so that a driver update (which may change or invalidate the binary
+// format) simply misses the cache rather than loading a stale binary.
+//
+uint64_t
+Program::binaryKey() const
+{
+    uint64_t key(Util::hash("libmatrix program binary"));
+    const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        const GLubyte* value = gl().GetString(names[i]);
+        if (value)
+        {
+            key = Util::hash(reinterpret_cast<const char*>(value), key);
+        }
+        key = Util::hash(string(1, '\0'), key);
+    }
+    for (std::vector<std::pair<unsigned int, string> >::const_iterator sourceIt = sources_.begin(); sourceIt != sources_.end(); sourceIt++)
+    {
+        key = Util::hash(Util::toString(sourceIt->first) + string(1, '\0'), key);
+        key = Util::hash(sourceIt->second + string(1, '\0'), key);
+    }
+    return key;
+}
+
+string
+Program::binaryPath(uint64_t key) const
+{
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return (std::filesystem::path(binaryCache_) / name.str()).string();
+}
+
+//
+// A cache file holds a small header followed by the binary returned by
+// glGetProgramBinary():
+//
+//     char     magic[4]       "LMPB"
+//     uint64_t key            the cache key, repeated as a check
+//     uint32_t format         the binary format
+//     uint32_t length         the length of the binary in bytes
+//
+static const char binaryMagic[4] = { 'L', 'M', 'P', 'B' };
+
+bool
+Program::loadBinary(uint64_t key)
+{
+    string path(binaryPath(key));
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    char magic[4];
+    uint64_t fileKey(0);
+    uint32_t format(0);
+    uint32_t length(0);
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&fileKey), sizeof(fileKey));
+    file.read(reinterpret_cast<char*>(&format), sizeof(format));
+    file.read(reinterpret_cast<char*>(&length), sizeof(length));
+    std::vector<char> binary;
+    if (file && std::memcmp(magic, binaryMagic, sizeof(magic)) == 0 &&
+        fileKey == key && length > 0)
+    {
+        binary.resize(length);
+        file.read(&binary[0], length);
+    }
+    file.close();
+
+    if (!binary.empty() && file)
+    {
+        gl().ProgramBinary(handle_, format, &binary[0], length);
+        GLint param = 0;
+        gl().GetProgramiv(handle_, GL_LINK_STATUS, &param);
+        if (param == GL_TRUE)
+        {
+            return true;
+        }
+    }
+
+    // Truncated, corrupt or rejected by the driver; get rid of it so that
+    // it is replaced after the program is built from source.
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return false;
+}
+
+void
+Program::saveBinary(uint64_t key)
+{
+    GLint length(0);
+    gl().GetProgramiv(handle_, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return;
+    }
+    std::vector<char> binary(length);
+    GLenum format(0);
+    gl().GetProgramBinary(handle_, length, &length, &format, &binary[0]);
+    if (length <= 0)
+    {
+        return;
+    }
+
+    // Write to a temporary file and rename it into place, so that another
+    // process never sees a partial cache entry.
+    std::error_code ec;
+    std::filesystem::create_directories(binaryCache_, ec);
+    string path(binaryPath(key));
+    string tmpPath(path + ".tmp" + Util::toString(Util::get_timestamp_us()));
+    std::ofstream file(tmpPath.c_str(), std::ios::binary);
+    uint32_t fileFormat(format);
+    uint32_t fileLength(length);
+    file.write(binaryMagic, sizeof(binaryMagic));
+    file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+    file.write(reinterpret_cast<const char*>(&fileFormat), sizeof(fileFormat));
+    file.write(reinterpret_cast<const char*>(&fileLength), sizeof(fileLength));
+    file.write(&binary[0], length);
+    file.close();
+    if (!file)
+    {
+        std::filesystem::remove(tmpPath, ec);
+        return;
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tmpPath, ec);
+    }
+}
+
+//
+// Record every active attribute and uniform of the newly linked program,
+// so that later lookups never have to go back to GL.  Arrays are reported
+// as "name[0]"; they are entered under the plain name as well.  Each
+// uniform of a type we know how to set also gets its slot in the staging
+// block here, along with the location of each of its elements: these
+// need not be consecutive, so each is looked up by its own name.
+//
+void
+Program::reflect()
+{
+    GLint count(0);
+    GLint maxLength(0);
+    gl().GetProgramiv(handle_, GL_ACTIVE_ATTRIBUTES, &count);
+    gl().GetProgramiv(handle_, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+    std::vector<GLchar> nameBuf(maxLength + 1);
+    for (GLint i = 0; i < count; i++)
+    {
+        GLsizei length(0);
+        GLint size(0);
+        GLenum type(0);
+        gl().GetActiveAttrib(handle_, i, nameBuf.size(), &length, &size, &type, &nameBuf[0]);
+        string name(&nameBuf[0], length);
+        GLint location = gl().GetAttribLocation(handle_, name.c_str());
+        addSymbol(name, location, Symbol::Attribute, type, size);
+    }
+
+    gl().GetProgramiv(handle_, GL_ACTIVE_UNIFORMS, &count);
+    gl().GetProgramiv(handle_, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    nameBuf.resize(maxLength + 1);
+    for (GLint i = 0; i < count; i++)
+    {
+        GLsizei length(0);
+        GLint size(0);
+        GLenum type(0);
+        gl().GetActiveUniform(handle_, i, nameBuf.size(), &length, &size, &type, &nameBuf[0]);
+        string name(&nameBuf[0], length);
+        GLint location = gl().GetUniformLocation(handle_, name.c_str());
+        unsigned int symbolHandle = addSymbol(name, location, Symbol::Uniform, type, size);
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+        {
+            // The pooled name, without the "[0]".
+            std::string_view pooled((*this)[symbolHandle].name());
+            symbolIndex_.insert(std::make_pair(pooled.substr(0, pooled.size() - 3), symbolHandle));
+        }
+        StagedUniform staged = { symbolHandle, type, 0, 0, static_cast<unsigned int>(size), 0, 0 };
+        switch (type)
+        {
+        case GL_FLOAT:
+            staged.components = 1;
+            break;
+        case GL_FLOAT_VEC2:
+            staged.components = 2;
+            break;
+        case GL_FLOAT_VEC3:
+            staged.components = 3;
+            break;
+        case GL_FLOAT_VEC4:
+            staged.components = 4;
+            break;
+        case GL_FLOAT_MAT3:
+            staged.components = 9;
+            break;
+        case GL_FLOAT_MAT4:
+            staged.components = 16;
+            break;
+        case GL_INT:
+        case GL_BOOL:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+            staged.type = GL_INT;
+            staged.components = 1;
+            break;
+        default:
+            // Not a type that can be set through a Symbol.
+            continue;
+        }
+        if (staged.type == GL_INT)
+        {
+            staged.offset = staging_.ints.size();
+            staging_.ints.resize(staged.offset + staged.elements);
+        }
+        else
+        {
+            staged.offset = staging_.floats.size();
+            staging_.floats.resize(staged.offset + staged.elements * staged.components);
+        }
+        staged.locations = stagedLocations_.size();
+        stagedLocations_.push_back(location);
+        if (staged.elements > 1)
+        {
+            string base(name);
+            if (base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0)
+            {
+                base.resize(base.size() - 3);
+            }
+            for (unsigned int element = 1; element < staged.elements; element++)
+            {
+                string elementName(base + "[" + std::to_string(element) + "]");
+                stagedLocations_.push_back(gl().GetUniformLocation(handle_, elementName.c_str()));
+            }
+        }
+        staged.dirtyMask = staging_.dirtyMasks.size();
+        staging_.dirtyMasks.resize(staged.dirtyMask + (staged.elements + 63) / 64);
+        stagedSlot_[symbolHandle] = staged_.size();
+        staged_.push_back(staged);
+    }
+    flushing_ = staging_;
+}
+
+unsigned int
+Program::addSymbol(std::string_view name, int location, Symbol::SymbolType type,
+                   unsigned int dataType, int count)
+{
+    unsigned int symbolHandle = numSymbols_;
+    if (symbolHandle % SymbolBlockSize == 0)
+    {
+        // Full blocks are never grown, so symbols never move.
+        symbolBlocks_.push_back(std::vector<Symbol>());
+        symbolBlocks_.back().reserve(SymbolBlockSize);
+    }
+    std::string_view pooled(poolName(name));
+    symbolBlocks_.back().emplace_back(pooled, location, type, dataType, count);
+    numSymbols_++;
+    stagedSlot_.push_back(-1);
+    symbolIndex_.insert(std::make_pair(pooled, symbolHandle));
+    return symbolHandle;
+}
+
+std::string_view
+Program::poolName(std::string_view name)
+{
+    if (namePool_.empty() || namePoolUsed_ + name.size() > namePoolSize_)
+    {
+        // Chunks are never reallocated, so pooled names never move.
+        namePoolSize_ = std::max(NamePoolChunk, name.size());
+        namePool_.push_back(std::make_unique<char[]>(namePoolSize_));
+        namePoolUsed_ = 0;
+    }
+    char* pooled(namePool_.back().get() + namePoolUsed_);
+    std::copy(name.begin(), name.end(), pooled);
+    namePoolUsed_ += name.size();
+    return std::string_view(pooled, name.size());
 }
 
 void
@@ -230,20 +794,44 @@ Program::start()
     {
         return;
     }
-    glUseProgram(handle_);
+    bind(handle_);
+    flush();
 }
 
 void
 Program::stop()
 {
-    glUseProgram(0);
+    if (binding_.lazyUnbind)
+    {
+        return;
+    }
+    bind(0);
+}
+
+void
+Program::unbind()
+{
+    bind(0);
+}
+
+void
+Program::bind(unsigned int handle)
+{
+    if (binding_.program == handle)
+    {
+        binding_.skipped++;
+        return;
+    }
+    gl().UseProgram(handle);
+    binding_.program = handle;
+    binding_.issued++;
 }
 
 
 int
 Program::getUniformLocation(const string& name)
 {
-    GLint location = glGetUniformLocation(handle_, name.c_str());
+    GLint location = gl().GetUniformLocation(handle_, name.c_str());
     if (location < 0)
     {
         message_ = string("Failed to get uniform location for \"") + name +
@@ -255,7 +843,7 @@ Program::getUniformLocation(const string& name)
 int
 Program::getAttribIndex(const string& name)
 {
-    GLint index = glGetAttribLocation(handle_, name.c_str());
+    GLint index = gl().GetAttribLocation(handle_, name.c_str());
     if (index < 0)
     {
         message_ = string("Failed to get attribute location for \"") + name +
@@ -264,13 +852,34 @@ Program::getAttribIndex(const string& name)
     return index;
 }
 
+//
+// Compare a value against the last one uploaded for this symbol.  If it
+// differs, it becomes the new shadow copy and true is returned.  The
+// comparison is bitwise, which is exact for our purposes: equal bits mean
+// GL would be given the same value.
+//
+bool
+Program::Symbol::changed(ValueType type, const void* value, size_t size)
+{
+    if (shadowType_ == type && std::memcmp(shadow_, value, size) == 0)
+    {
+        skipped_++;
+        return false;
+    }
+    std::memcpy(shadow_, value, size);
+    shadowType_ = type;
+    issued_++;
+    return true;
+}
+
 Program::Symbol&
 Program::Symbol::operator=(const mat4& m)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform &&
+        changed(Mat4Value, static_cast<const float*>(m), 16 * sizeof(float)))
     {
         // Our matrix representation is column-major, so transpose is false here.
-        glUniformMatrix4fv(location_, 1, GL_FALSE, m);
+        gl().UniformMatrix4fv(location_, 1, GL_FALSE, m);
     }
     return *this;
 }
@@ -278,10 +887,11 @@ Program::Symbol::operator=(const mat4& m)
 Program::Symbol&
 Program::Symbol::operator=(const mat3& m)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform &&
+        changed(Mat3Value, static_cast<const float*>(m), 9 * sizeof(float)))
     {
         // Our matrix representation is column-major, so transpose is false here.
-        glUniformMatrix3fv(location_, 1, GL_FALSE, m);
+        gl().UniformMatrix3fv(location_, 1, GL_FALSE, m);
     }
     return *this;
 }
@@ -289,9 +899,10 @@ Program::Symbol::operator=(const mat3& m)
 Program::Symbol&
 Program::Symbol::operator=(const vec2& v)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform &&
+        changed(Vec2Value, static_cast<const float*>(v), 2 * sizeof(float)))
     {
-        glUniform2fv(location_, 1, v);
+        gl().Uniform2fv(location_, 1, v);
     }
     return *this;
 }
@@ -299,9 +910,10 @@ Program::Symbol::operator=(const vec2& v)
 Program::Symbol&
 Program::Symbol::operator=(const vec3& v)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform &&
+        changed(Vec3Value, static_cast<const float*>(v), 3 * sizeof(float)))
     {
-        glUniform3fv(location_, 1, v);
+        gl().Uniform3fv(location_, 1, v);
     }
     return *this;
 }
@@ -309,9 +921,10 @@ Program::Symbol::operator=(const vec3& v)
 Program::Symbol&
 Program::Symbol::operator=(const vec4& v)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform &&
+        changed(Vec4Value, static_cast<const float*>(v), 4 * sizeof(float)))
     {
-        glUniform4fv(location_, 1, v);
+        gl().Uniform4fv(location_, 1, v);
     }
     return *this;
 }
@@ -319,9 +932,9 @@ Program::Symbol::operator=(const vec4& v)
 Program::Symbol&
 Program::Symbol::operator=(const float& f)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform && changed(FloatValue, &f, sizeof(float)))
     {
-        glUniform1f(location_, f);
+        gl().Uniform1f(location_, f);
     }
     return *this;
 }
@@ -329,32 +942,300 @@ Program::Symbol::operator=(const float& f)
 Program::Symbol&
 Program::Symbol::operator=(const int& i)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform && changed(IntValue, &i, sizeof(int)))
     {
-        glUniform1i(location_, i);
+        gl().Uniform1i(location_, i);
     }
     return *this;
 }
 
+unsigned int
+Program::getHandle(const string& name)
+{
+    std::unordered_map<std::string_view, unsigned int>::iterator indexIt = symbolIndex_.find(name);
+    if (indexIt != symbolIndex_.end())
+    {
+        return (*indexIt).second;
+    }
+
+    // Not found at link time (or the program is not built yet), so fall
+    // back to asking GL directly.
+    Program::Symbol::SymbolType type(Program::Symbol::Attribute);
+    int location = getAttribIndex(name);
+    if (location < 0)
+    {
+        // No attribute found by that name.  Let's try a uniform...
+        type = Program::Symbol::Uniform;
+        location = getUniformLocation(name);
+        if (location < 0)
+        {
+            type = Program::Symbol::None;
+        }
+    }
+    return addSymbol(name, location, type);
+}
+
 Program::Symbol&
 Program::operator[](const std::string& name)
 {
-    std::map<std::string, Symbol*>::iterator mapIt = symbols_.find(name);
-    if (mapIt == symbols_.end())
+    return (*this)[getHandle(name)];
+}
+
+Program::StagedUniform*
+Program::stagedUniform(unsigned int handle, unsigned int element, unsigned int type)
+{
+    if (handle >= stagedSlot_.size() || stagedSlot_[handle] < 0)
     {
-        Program::Symbol::SymbolType type(Program::Symbol::Attribute);
-        int location = getAttribIndex(name);
-        if (location < 0)
+        return 0;
+    }
+    StagedUniform& staged(staged_[stagedSlot_[handle]]);
+    if (staged.type != type || element >= staged.elements)
+    {
+        return 0;
+    }
+    return &staged;
+}
+
+// Called with stagingLock_ held.
+void
+Program::markStaged(const StagedUniform& staged, unsigned int element)
+{
+    std::vector<uint64_t>::iterator mask(staging_.dirtyMasks.begin() + staged.dirtyMask);
+    std::vector<uint64_t>::iterator maskEnd(mask + (staged.elements + 63) / 64);
+    if (std::find_if(mask, maskEnd, [](uint64_t bits) { return bits != 0; }) == maskEnd)
+    {
+        // First change since the last flush.
+        staging_.dirty.push_back(&staged - &staged_[0]);
+    }
+    mask[element / 64] |= uint64_t(1) << (element % 64);
+}
+
+bool
+Program::elementStaged(const StagingBuffer& buffer, const StagedUniform& staged,
+                       unsigned int element)
+{
+    return buffer.dirtyMasks[staged.dirtyMask + element / 64] & (uint64_t(1) << (element % 64));
+}
+
+void
+Program::stageFloats(unsigned int handle, unsigned int element, unsigned int type,
+                     const float* value, unsigned int components)
+{
+    StagedUniform* staged = stagedUniform(handle, element, type);
+    if (!staged)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(stagingLock_);
+    std::copy(value, value + components,
+              staging_.floats.begin() + staged->offset + element * components);
+    markStaged(*staged, element);
+}
+
+void
+Program::stage(unsigned int handle, const mat4& m, unsigned int element)
+{
+    stageFloats(handle, element, GL_FLOAT_MAT4, m, 16);
+}
+
+void
+Program::stage(unsigned int handle, const mat3& m, unsigned int element)
+{
+    stageFloats(handle, element, GL_FLOAT_MAT3, m, 9);
+}
+
+void
+Program::stage(unsigned int handle, const vec2& v, unsigned int element)
+{
+    stageFloats(handle, element, GL_FLOAT_VEC2, v, 2);
+}
+
+void
+Program::stage(unsigned int handle, const vec3& v, unsigned int element)
+{
+    stageFloats(handle, element, GL_FLOAT_VEC3, v, 3);
+}
+
+void
+Program::stage(unsigned int handle, const vec4& v, unsigned int element)
+{
+    stageFloats(handle, element, GL_FLOAT_VEC4, v, 4);
+}
+
+void
+Program::stage(unsigned int handle, float f, unsigned int element)
+{
+    stageFloats(handle, element, GL_FLOAT, &f, 1);
+}
+
+void
+Program::stage(unsigned int handle, int i, unsigned int element)
+{
+    StagedUniform* staged = stagedUniform(handle, element, GL_INT);
+    if (!staged)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(stagingLock_);
+    staging_.ints[staged->offset + element] = i;
+    markStaged(*staged, element);
+}
+
+void
+Program::uploadStaged(const StagedUniform& staged, GLint location,
+                      unsigned int first, GLsizei count)
+{
+    const float* values(flushing_.floats.data() + staged.offset + first * staged.components);
+    switch (staged.type)
+    {
+    case GL_FLOAT:
+        gl().Uniform1fv(location, count, values);
+        break;
+    case GL_FLOAT_VEC2:
+        gl().Uniform2fv(location, count, values);
+        break;
+    case GL_FLOAT_VEC3:
+        gl().Uniform3fv(location, count, values);
+        break;
+    case GL_FLOAT_VEC4:
+        gl().Uniform4fv(location, count, values);
+        break;
+    case GL_FLOAT_MAT3:
+        gl().UniformMatrix3fv(location, count, GL_FALSE, values);
+        break;
+    case GL_FLOAT_MAT4:
+        gl().UniformMatrix4fv(location, count, GL_FALSE, values);
+        break;
+    case GL_INT:
+        gl().Uniform1iv(location, count, &flushing_.ints[staged.offset + first]);
+        break;
+    }
+}
+
+//
+// Only the elements staged since the last flush are sent, so that values
+// set some other way (through a Symbol, or by an initializer in the
+// shader) are left alone.  Each run of staged elements whose locations
+// follow on from one another goes in one call.
+//
+// The buffers are swapped first, so that staging can go on (into the other
+// buffer) while the values are sent.
+//
+void
+Program::flush()
+{
+    {
+        std::lock_guard<std::mutex> lock(stagingLock_);
+        std::swap(staging_, flushing_);
+    }
+    for (std::vector<unsigned int>::iterator dirtyIt = flushing_.dirty.begin();
+         dirtyIt != flushing_.dirty.end();
+         dirtyIt++)
+    {
+        const StagedUniform& staged(staged_[*dirtyIt]);
+        const GLint* locations(&stagedLocations_[staged.locations]);
+        unsigned int element(0);
+        while (element < staged.elements)
         {
-            // No attribute found by that name.  Let's try a uniform...
-            type = Program::Symbol::Uniform;
-            location = getUniformLocation(name);
-            if (location < 0)
+            if (!elementStaged(flushing_, staged, element))
             {
-                type = Program::Symbol::None;
+                element++;
+                continue;
             }
+            unsigned int first(element);
+            do
+            {
+                element++;
+            } while (element < staged.elements && elementStaged(flushing_, staged, element) &&
+                     locations[element] == locations[first] + GLint(element - first));
+            uploadStaged(staged, locations[first], first, element - first);
         }
-        mapIt = symbols_.insert(mapIt, std::make_pair(name, new Symbol(name, location, type)));
+        std::fill_n(flushing_.dirtyMasks.begin() + staged.dirtyMask, (staged.elements + 63) / 64, 0);
+        // The symbol's record of the last value it uploaded is now stale.
+        (*this)[staged.symbol].invalidate();
+    }
+    flushing_.dirty.clear();
+}
+
+void
+Program::bindUniformBlock(const string& name, unsigned int binding)
+{
+    if (!valid_ || !ready_)
+    {
+        return;
+    }
+    GLuint index = gl().GetUniformBlockIndex(handle_, name.c_str());
+    if (index == GL_INVALID_INDEX)
+    {
+        message_ = string("Failed to get uniform block index for \"") + name +
+            string("\"");
+        return;
+    }
+    gl().UniformBlockBinding(handle_, index, binding);
+}
+
+UniformBuffer::UniformBuffer() :
+    size_(0),
+    current_(0)
+{
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    release();
+}
+
+void
+UniformBuffer::init(unsigned int size, unsigned int copies)
+{
+    release();
+    if (!size || !copies)
+    {
+        return;
+    }
+    handles_.resize(copies);
+    gl().GenBuffers(copies, &handles_[0]);
+    for (std::vector<unsigned int>::iterator handleIt = handles_.begin(); handleIt != handles_.end(); handleIt++)
+    {
+        gl().BindBuffer(GL_UNIFORM_BUFFER, *handleIt);
+        gl().BufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+    }
+    gl().BindBuffer(GL_UNIFORM_BUFFER, 0);
+    size_ = size;
+    current_ = 0;
+}
+
+void
+UniformBuffer::release()
+{
+    if (!handles_.empty())
+    {
+        gl().DeleteBuffers(handles_.size(), &handles_[0]);
+    }
+    handles_.clear();
+    size_ = 0;
+    current_ = 0;
+}
+
+void
+UniformBuffer::update(const void* data)
+{
+    if (handles_.empty())
+    {
+        return;
+    }
+    current_ = (current_ + 1) % handles_.size();
+    gl().BindBuffer(GL_UNIFORM_BUFFER, handles_[current_]);
+    gl().BufferSubData(GL_UNIFORM_BUFFER, 0, size_, data);
+    gl().BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void
+UniformBuffer::bind(unsigned int binding) const
+{
+    if (handles_.empty())
+    {
+        return;
     }
-    return *(*mapIt).second;
+    gl().BindBufferBase(GL_UNIFORM_BUFFER, binding, handles_[current_]);
 }
@@ -12,10 +12,14 @@
 #ifndef PROGRAM_H_
 #define PROGRAM_H_
 
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
+#include <unordered_map>
 #include <utility>
+#include <stdint.h>
 #include "mat.h"
 
 // Simple shader container.  Abstracts all of the OpenGL bits, but leaves
@@ -27,6 +31,7 @@ public:
     Shader() :
         handle_(0),
         type_(0),
+        submitted_(false),
         ready_(false),
         valid_(false) {}
     Shader(const Shader& shader) :
@@ -34,6 +39,7 @@ public:
         type_(shader.type_),
         source_(shader.source_),
         message_(shader.message_),
+        submitted_(shader.submitted_),
         ready_(shader.ready_),
         valid_(shader.valid_) {}
     Shader(Shader&& shader) noexcept:
@@ -41,6 +47,7 @@ public:
         type_(std::exchange(shader.type_, 0)),
         source_(std::move(shader.source_)),
         message_(std::move(shader.message_)),
+        submitted_(std::exchange(shader.submitted_, false)),
         ready_(std::exchange(shader.ready_, false)),
         valid_(std::exchange(shader.valid_, false)) {}
     Shader(unsigned int type, const std::string& source);
@@ -52,10 +59,17 @@ public:
     // Make sure the shader is "valid" before calling this one.
     void compile();
 
+    // Starts compiling the shader source without waiting for the result,
+    // so that the driver can work on several shaders at once.  A later
+    // call to compile() collects the result.
+    //
+    // Make sure the shader is "valid" before calling this one.
+    void submit();
+
     // Attaches a compiled shader to a program in preparation for
     // linking.
     //
-    // Make sure the shader is "ready" before calling this one.
+    // Make sure the shader is "ready" (or submitted) before calling this one.
     void attach(unsigned int program);
 
     // Release any resources associated with this shader back to
@@ -75,6 +89,7 @@ private:
     unsigned int type_;
     std::string source_;
     std::string message_;
+    bool submitted_;
     bool ready_;
     bool valid_;
 };
@@ -85,7 +100,11 @@ class Program
 {
 public:
     Program();
+    Program(Program&& program) noexcept;
+    Program(const Program&) = delete;
     ~Program();
+    Program& operator=(Program&& program) noexcept;
+    Program& operator=(const Program&) = delete;
 
     // Initialize the program object for use.
     void init();
@@ -94,6 +113,44 @@ public:
     // OpenGL
     void release();
 
+    // Keep linked program binaries in the given directory, and reuse them
+    // instead of compiling the shaders when the same sources are built
+    // again on the same driver.  With the cache enabled, addShader() only
+    // records the source, and compilation is left to build(), which falls
+    // back to it whenever there is no usable cached binary.
+    //
+    // Call this before adding any shaders.
+    void setBinaryCache(const std::string& directory);
+
+    // Whether the last build() was satisfied from the binary cache.
+    bool fromBinaryCache() const { return fromBinaryCache_; }
+
+    // Build without blocking.  With async builds enabled, addShader() only
+    // records the source.  buildAsync() then submits every shader for
+    // compilation and the program for linking in one go, without waiting
+    // for any of it, and poll() reports on progress.  Where the driver
+    // supports GL_KHR_parallel_shader_compile, poll() never blocks, and
+    // the compiles of many programs proceed in parallel; otherwise the
+    // first poll() waits for the driver to finish.
+    //
+    //     program.setAsyncBuild(true);
+    //     program.addShader(GL_VERTEX_SHADER, vtx);
+    //     program.addShader(GL_FRAGMENT_SHADER, frg);
+    //     program.buildAsync();
+    //     ...
+    //     if (program.poll() == Program::BuildReady) ...
+    //
+    // Call setAsyncBuild() before adding any shaders.
+    enum BuildStatus
+    {
+        BuildPending,
+        BuildReady,
+        BuildFailed
+    };
+    void setAsyncBuild(bool async) { async_ = async; }
+    void buildAsync();
+    BuildStatus poll();
+
     // Create a new shader of the given type and source, compile it and
     // attach it to the program.
     //
@@ -108,15 +165,39 @@ public:
     void build();
 
     // Bind the program for use by the rendering context (i.e. actually
-    // run it).
+    // run it).  Any staged uniform values are flushed.  If the program is
+    // already bound, no GL call is made.
     //
     // Make sure the program is "ready" before calling this one.
     void start();
 
     // Unbind the program from use by the rendering context (i.e. stop
-    // using it).
+    // using it).  With lazy unbinding, the program is left bound, and
+    // only replaced by the next program started (or by unbind()).
     void stop();
 
+    // Tracking of the bound program.  Programs remember which of them is
+    // bound in the calling thread (i.e. in its current context), so that
+    // starting the same program for many draws binds it only once:
+    //
+    //     Program::setLazyUnbind(true);
+    //     for (...)
+    //     {
+    //         program.start();        // glUseProgram only the first time
+    //         ...
+    //         program.stop();         // no GL call
+    //     }
+    //     Program::unbind();          // before drawing without a program
+    //
+    // Code that calls glUseProgram itself, or makes a different context
+    // current, must call forgetBinding() afterwards.
+    static void setLazyUnbind(bool lazy) { binding_.lazyUnbind = lazy; }
+    static void unbind();
+    static void forgetBinding() { binding_.program = NoBinding; }
+    static unsigned int issuedBinds() { return binding_.issued; }
+    static unsigned int skippedBinds() { return binding_.skipped; }
+    static void resetBindCounts() { binding_.issued = binding_.skipped = 0; }
+
     class Symbol
     {
 public:
@@ -126,13 +207,32 @@ public:
             Attribute,
             Uniform
         };
-        Symbol(const std::string& name, int location, SymbolType type) :
+        Symbol(std::string_view name, int location, SymbolType type,
+               unsigned int dataType = 0, int count = 1) :
             type_(type),
             location_(location),
-            name_(name) {}
+            name_(name),
+            dataType_(dataType),
+            count_(count),
+            shadowType_(NoValue),
+            issued_(0),
+            skipped_(0) {}
         int location() const { return location_; }
+        // The name is kept in the program's name pool, and is valid for as
+        // long as the symbol is.
+        std::string_view name() const { return name_; }
+        SymbolType symbolType() const { return type_; }
+        // The GL data type (e.g. GL_FLOAT_MAT4) and array size reported by
+        // the linker.  The type is 0 for symbols that were not active at
+        // link time.
+        unsigned int dataType() const { return dataType_; }
+        int count() const { return count_; }
         // These members cause data to be bound to program variables, so
         // the program must be bound for use for these to be effective.
+        //
+        // Uniform values are part of the program object, so each symbol
+        // keeps a copy of the last value it uploaded and skips the GL call
+        // when asked to load the same value again.
         Symbol& operator=(const LibMatrix::mat4& m);
         Symbol& operator=(const LibMatrix::mat3& m);
         Symbol& operator=(const LibMatrix::vec2& v);
@@ -140,17 +240,100 @@ public:
         Symbol& operator=(const LibMatrix::vec4& v);
         Symbol& operator=(const float& f);
         Symbol& operator=(const int& i);
+        // Forget the last uploaded value, so that the next assignment is
+        // always sent to GL.  Needed if the uniform has been changed by
+        // other means (e.g. a direct glUniform call).
+        void invalidate() { shadowType_ = NoValue; }
+        // The number of assignments that were sent to GL, and the number
+        // that were skipped because the value had not changed.
+        unsigned int issuedUploads() const { return issued_; }
+        unsigned int skippedUploads() const { return skipped_; }
 private:
+        enum ValueType
+        {
+            NoValue,
+            Mat4Value,
+            Mat3Value,
+            Vec2Value,
+            Vec3Value,
+            Vec4Value,
+            FloatValue,
+            IntValue
+        };
         Symbol();
+        bool changed(ValueType type, const void* value, size_t size);
         SymbolType type_;
         GLint location_;
-        std::string name_;
+        std::string_view name_;
+        unsigned int dataType_;
+        int count_;
+        // Large enough for the biggest value type (mat4).
+        float shadow_[16];
+        ValueType shadowType_;
+        unsigned int issued_;
+        unsigned int skipped_;
     };
     // Get the handle to a named program input (the location in OpenGL
     // vernacular).  Typically used in conjunction with various VertexAttrib
     // interfaces.  Equality operators are used to load uniform data.
     Symbol& operator[](const std::string& name);
 
+    // All of the active uniforms and attributes are recorded when the
+    // program is built, and each is given a small integer handle that
+    // stays valid until the program is released.  Looking a symbol up by
+    // handle is just an array index, so hot code should get the handles
+    // once, after build(), and use them from then on:
+    //
+    //     unsigned int mvp(program.getHandle("ModelViewProjection"));
+    //     ...
+    //     program[mvp] = stack.getModelViewProjection();
+    //
+    // Names that are not active still get a handle, to a symbol of type
+    // None, so that assignments through it are ignored.
+    unsigned int getHandle(const std::string& name);
+    Symbol& operator[](unsigned int handle)
+    {
+        return symbolBlocks_[handle / SymbolBlockSize][handle % SymbolBlockSize];
+    }
+    unsigned int numSymbols() const { return numSymbols_; }
+
+    // Deferred uniform updates.  Unlike assignment through a Symbol, these
+    // make no GL calls and do not need the program to be bound, so they
+    // can be made from a thread without a GL context.  The values are
+    // kept in a staging block and sent to GL, all together, by the next
+    // start() or flush().  Elements of a uniform array may be staged one
+    // at a time; only the elements that changed are flushed, with one
+    // glUniform*v call for each run of them at consecutive locations.
+    //
+    // Only uniforms that were active when the program was built can be
+    // staged, and the value must match the uniform's declared type.
+    // Anything else is ignored.
+    //
+    // Staging may carry on while another thread renders with the program:
+    // values are staged into one buffer while flush() sends those of the
+    // other, and the two are swapped (under a lock) at the start of each
+    // flush.  A value staged before a flush starts is sent by it, and one
+    // staged later by the next flush.  Staging must not overlap building,
+    // moving or releasing the program.
+    void stage(unsigned int handle, const LibMatrix::mat4& m, unsigned int element = 0);
+    void stage(unsigned int handle, const LibMatrix::mat3& m, unsigned int element = 0);
+    void stage(unsigned int handle, const LibMatrix::vec2& v, unsigned int element = 0);
+    void stage(unsigned int handle, const LibMatrix::vec3& v, unsigned int element = 0);
+    void stage(unsigned int handle, const LibMatrix::vec4& v, unsigned int element = 0);
+    void stage(unsigned int handle, float f, unsigned int element = 0);
+    void stage(unsigned int handle, int i, unsigned int element = 0);
+
+    // Send all staged uniform values to GL.
+    //
+    // Make sure the program is bound (i.e. started) before calling this one.
+    void flush();
+
+    // Connect the named uniform block in the program to a uniform buffer
+    // binding point (see UniformBuffer::bind()).
+    //
+    // Make sure the program is "ready" before calling this one.
+    void bindUniformBlock(const std::string& name, unsigned int binding);
+
     // If "valid" then the program has successfully been created.
     // If "ready" then the program has successfully been built.
     // If either is false, then additional information can be obtained
@@ -159,15 +342,136 @@ private:
     bool ready() const { return ready_; }
     const std::string& errorMessage() const { return message_; }
 
+    // The GL program object (e.g. to find this program in GLStats).
+    unsigned int handle() const { return handle_; }
+
 private:
     int getAttribIndex(const std::string& name);
     int getUniformLocation(const std::string& name);
+    // Where a uniform's values live in a staging buffer, and where its
+    // element locations (in stagedLocations_) and the mask of elements
+    // staged since the last flush (one bit per element) start.
+    struct StagedUniform
+    {
+        unsigned int symbol;
+        unsigned int type;
+        unsigned int offset;
+        unsigned int components;
+        unsigned int elements;
+        unsigned int locations;
+        unsigned int dirtyMask;
+    };
+    // The staged values, the masks of staged elements, and the uniforms
+    // (indices into staged_) with any element staged.
+    struct StagingBuffer
+    {
+        std::vector<float> floats;
+        std::vector<int> ints;
+        std::vector<uint64_t> dirtyMasks;
+        std::vector<unsigned int> dirty;
+    };
+    void compileShader(unsigned int type, const std::string& source);
+    bool startBuild(uint64_t& key, bool& useCache);
+    void finishBuild(uint64_t key, bool useCache);
+    bool parallelCompile();
+    uint64_t binaryKey() const;
+    std::string binaryPath(uint64_t key) const;
+    bool loadBinary(uint64_t key);
+    void saveBinary(uint64_t key);
+    void moveFrom(Program& program);
+    void reflect();
+    unsigned int addSymbol(std::string_view name, int location, Symbol::SymbolType type,
+                           unsigned int dataType = 0, int count = 1);
+    std::string_view poolName(std::string_view name);
+    StagedUniform* stagedUniform(unsigned int handle, unsigned int element,
+                                 unsigned int type);
+    void markStaged(const StagedUniform& staged, unsigned int element);
+    static bool elementStaged(const StagingBuffer& buffer, const StagedUniform& staged,
+                              unsigned int element);
+    void uploadStaged(const StagedUniform& staged, int location,
+                      unsigned int first, int count);
+    void stageFloats(unsigned int handle, unsigned int element, unsigned int type,
+                     const float* value, unsigned int components);
+    static void bind(unsigned int handle);
+    // The program bound in this thread, or NoBinding if not known.
+    static const unsigned int NoBinding = ~0u;
+    struct Binding
+    {
+        unsigned int program;
+        bool lazyUnbind;
+        unsigned int issued;
+        unsigned int skipped;
+    };
+    static inline thread_local Binding binding_ = { NoBinding, false, 0, 0 };
     unsigned int handle_;
-    std::map<std::string, Symbol*> symbols_;
+    // Symbols are stored by value in blocks of SymbolBlockSize, so that
+    // neither their handles nor their addresses change as more are added,
+    // and their names are copied into a pool of NamePoolChunk sized chunks.
+    // The index refers to names in the pool.
+    static const unsigned int SymbolBlockSize = 32;
+    static const size_t NamePoolChunk = 1024;
+    std::vector<std::vector<Symbol> > symbolBlocks_;
+    unsigned int numSymbols_;
+    std::vector<std::unique_ptr<char[]> > namePool_;
+    size_t namePoolUsed_;
+    size_t namePoolSize_;
+    std::unordered_map<std::string_view, unsigned int> symbolIndex_;
+    // Index into staged_ for each symbol, or -1 if it cannot be staged.
+    std::vector<int> stagedSlot_;
+    std::vector<StagedUniform> staged_;
+    std::vector<int> stagedLocations_;
+    // stage() fills staging_, and flush() swaps it with flushing_ and
+    // sends that.  stagingLock_ guards staging_ and the swap.
+    StagingBuffer staging_;
+    StagingBuffer flushing_;
+    std::mutex stagingLock_;
     std::vector<Shader> shaders_;
+    std::string binaryCache_;
+    std::vector<std::pair<unsigned int, std::string> > sources_;
+    bool fromBinaryCache_;
+    bool async_;
+    bool linkPending_;
+    uint64_t pendingKey_;
+    bool pendingUseCache_;
+    // -1 until checked, then whether GL_KHR_parallel_shader_compile is
+    // supported.
+    int parallelCompile_;
     std::string message_;
     bool ready_;
     bool valid_;
 };
 
+// Uniform buffer object for a block of uniforms packed on the CPU (see
+// UniformBlock in uniform-block.h).  The buffer is replicated, and each
+// update() writes the whole block into the next copy in turn, so that a
+// write never has to wait for the GPU to finish with the copy used by the
+// previous draw.
+class UniformBuffer
+{
+public:
+    UniformBuffer();
+    ~UniformBuffer();
+
+    // Create 'copies' buffer objects of 'size' bytes each.
+    void init(unsigned int size, unsigned int copies = 2);
+
+    // Release the buffer objects back to OpenGL.
+    void release();
+
+    // Copy a complete block of 'size' bytes into the next copy of the
+    // buffer, which becomes the current one.
+    void update(const void* data);
+
+    // Bind the current copy to a uniform buffer binding point.
+    void bind(unsigned int binding) const;
+
+    unsigned int size() const { return size_; }
+    bool valid() const { return !handles_.empty(); }
+
+private:
+    std::vector<unsigned int> handles_;
+    unsigned int size_;
+    unsigned int current_;
+};
+
 #endif // PROGRAM_H_
@@ -0,0 +1,164 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <algorithm>
+#include <stdexcept>
+#include <math.h>
+#include "quat.h"
+#include "log.h"
+
+namespace LibMatrix
+{
+namespace
+{
+
+size_t
+checked_count(size_t a, size_t b, size_t dst)
+{
+    size_t count(std::min(std::min(a, b), dst));
+    if (a != b || dst < a)
+    {
+#ifdef USE_EXCEPTIONS
+        throw std::invalid_argument("Quaternion arrays differ in length");
+#else // !USE_EXCEPTIONS
+        Log::error("Quaternion arrays differ in length (%zu, %zu -> %zu)\n",
+                   a, b, dst);
+#endif // USE_EXCEPTIONS
+    }
+    return count;
+}
+
+//
+// Coefficients of Eberly's slerp approximation.  With x = cos(theta), the
+// weight sin(t * theta) / sin(theta) is
+//
+//   t * (1 + b[0] * (1 + b[1] * (1 + ... (1 + b[n-1]))))
+//
+// where b[i] = (u[i] * t^2 - v[i]) * (x - 1), u[i] = 1 / (i * (2i + 1)) and
+// v[i] = i / (2i + 1) (counting i from 1).  The series is cut off after
+// 16 terms, with the last term scaled up to make up for the rest; the
+// scale was fitted to keep the weights within 3e-8 of exact over the whole
+// range of t and of angles up to 90 degrees (the interpolation always goes
+// the short way around, so no more is needed).
+//
+constexpr int slerp_terms(16);
+constexpr float slerp_tail_scale(1.903f);
+
+struct SlerpCoefficients
+{
+    float u[slerp_terms];
+    float v[slerp_terms];
+
+    constexpr SlerpCoefficients() : u(), v()
+    {
+        for (int i = 0; i < slerp_terms; i++)
+        {
+            float n(i + 1);
+            u[i] = 1.0f / (n * (2.0f * n + 1.0f));
+            v[i] = n / (2.0f * n + 1.0f);
+        }
+        u[slerp_terms - 1] *= slerp_tail_scale;
+        v[slerp_terms - 1] *= slerp_tail_scale;
+    }
+};
+
+constexpr SlerpCoefficients slerp_coefficients;
+
+inline float
+slerp_weight(float t, float xm1)
+{
+    float t2(t * t);
+    float r(1.0f);
+    for (int i = slerp_terms - 1; i >= 0; i--)
+    {
+        r = 1.0f + ((slerp_coefficients.u[i] * t2) - slerp_coefficients.v[i]) * xm1 * r;
+    }
+    return t * r;
+}
+
+template<typename Parameter>
+void
+slerp_batch(quat* dst, const quat* a, const quat* b, size_t count,
+            Parameter param)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        const quat qa(a[i]);
+        const quat qb(b[i]);
+        float x(quat::dot(qa, qb));
+        // Take the short way around by flipping b when the angle is obtuse.
+        float sign(x < 0.0f ? -1.0f : 1.0f);
+        float xm1((x * sign) - 1.0f);
+        float t(param(i));
+        float wa(slerp_weight(1.0f - t, xm1));
+        float wb(slerp_weight(t, xm1) * sign);
+        dst[i] = quat((qa.x() * wa) + (qb.x() * wb),
+                      (qa.y() * wa) + (qb.y() * wb),
+                      (qa.z() * wa) + (qb.z() * wb),
+                      (qa.w() * wa) + (qb.w() * wb));
+    }
+}
+
+} // anonymous namespace
+
+namespace Quat
+{
+
+quat
+rotate(float angle, float x, float y, float z)
+{
+    vec3 u(x, y, z);
+    u.normalize();
+    // degrees to radians, halved
+    float halfAngle(angle * M_PI / 360.0);
+    float s(sin(halfAngle));
+    return quat(u.x() * s, u.y() * s, u.z() * s, cos(halfAngle));
+}
+
+void
+slerp(std::span<quat> dst, std::span<const quat> a,
+      std::span<const quat> b, float t)
+{
+    size_t count(checked_count(a.size(), b.size(), dst.size()));
+    slerp_batch(dst.data(), a.data(), b.data(), count,
+                [t](size_t) { return t; });
+}
+
+void
+slerp(std::span<quat> dst, std::span<const quat> a,
+      std::span<const quat> b, std::span<const float> t)
+{
+    size_t count(checked_count(a.size(), b.size(), dst.size()));
+    count = checked_count(count, t.size(), count);
+    const float* tp(t.data());
+    slerp_batch(dst.data(), a.data(), b.data(), count,
+                [tp](size_t i) { return tp[i]; });
+}
+
+void
+nlerp(std::span<quat> dst, std::span<const quat> a,
+      std::span<const quat> b, float t)
+{
+    size_t count(checked_count(a.size(), b.size(), dst.size()));
+    for (size_t i = 0; i < count; i++)
+    {
+        const quat qa(a[i]);
+        const quat qb(b[i]);
+        float wa(1.0f - t);
+        float wb(quat::dot(qa, qb) < 0.0f ? -t : t);
+        quat q((qa.x() * wa) + (qb.x() * wb),
+               (qa.y() * wa) + (qb.y() * wb),
+               (qa.z() * wa) + (qb.z() * wb),
+               (qa.w() * wa) + (qb.w() * wb));
+        float l(quat::dot(q, q));
+        dst[i] = l > 0.0f ? q * (1.0f / sqrtf(l)) : q;
+    }
+}
+
+} // namespace Quat
+} // namespace LibMatrix
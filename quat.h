@@ -0,0 +1,564 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef QUAT_H_
+#define QUAT_H_
+
+#include <algorithm>
+#include <span>
+#include <math.h>
+#include "mat.h"
+
+namespace LibMatrix
+{
+// A template class for creating, managing and operating on a quaternion,
+// primarily as a representation of a 3D rotation.  The components are
+// stored in x, y, z, w order (vector part first), which is also how a
+// quaternion is usually passed to a shader as a vec4.
+//
+// Multiplication follows the matrix convention: the rotation of a * b is
+// that of b followed by that of a, so to_mat3(a * b) == to_mat3(a) *
+// to_mat3(b).
+template<typename T>
+class tquat
+{
+public:
+    tquat()
+    {
+        setIdentity();
+    }
+    tquat(const T& x, const T& y, const T& z, const T& w)
+    {
+        q_[0] = x;
+        q_[1] = y;
+        q_[2] = z;
+        q_[3] = w;
+    }
+    // Extract the rotation from the upper 3x3 of a matrix, which must be
+    // orthonormal.  This picks the largest of the four components to solve
+    // for first, to stay accurate for all rotation angles.
+    explicit tquat(const tmat3<T>& m)
+    {
+        from_rows(m[0][0], m[0][1], m[0][2],
+                  m[1][0], m[1][1], m[1][2],
+                  m[2][0], m[2][1], m[2][2]);
+    }
+    explicit tquat(const tmat4<T>& m)
+    {
+        from_rows(m[0][0], m[0][1], m[0][2],
+                  m[1][0], m[1][1], m[1][2],
+                  m[2][0], m[2][1], m[2][2]);
+    }
+    explicit tquat(const taffine4<T>& m)
+    {
+        from_rows(m[0][0], m[0][1], m[0][2],
+                  m[1][0], m[1][1], m[1][2],
+                  m[2][0], m[2][1], m[2][2]);
+    }
+    ~tquat() {}
+
+    // Reset this to the identity rotation.
+    void setIdentity()
+    {
+        q_[0] = 0;
+        q_[1] = 0;
+        q_[2] = 0;
+        q_[3] = 1;
+    }
+
+    // Get and set access members for the individual components.
+    const T x() const { return q_[0]; }
+    const T y() const { return q_[1]; }
+    const T z() const { return q_[2]; }
+    const T w() const { return q_[3]; }
+
+    void x(const T& val) { q_[0] = val; }
+    void y(const T& val) { q_[1] = val; }
+    void z(const T& val) { q_[2] = val; }
+    void w(const T& val) { q_[3] = val; }
+
+    // Compute the dot product of two quaternions.
+    static T dot(const tquat& a, const tquat& b)
+    {
+        return (a.q_[0] * b.q_[0]) + (a.q_[1] * b.q_[1]) +
+               (a.q_[2] * b.q_[2]) + (a.q_[3] * b.q_[3]);
+    }
+
+    // Compute the length of this and return it.
+    T length() const
+    {
+        return sqrt(dot(*this, *this));
+    }
+
+    // Make this a unit quaternion.  Return a reference to this.
+    tquat& normalize()
+    {
+        T l(length());
+        if (l != 0 && l != 1)
+        {
+            *this *= static_cast<T>(1) / l;
+        }
+        return *this;
+    }
+
+    // Negate the vector part of this.  For a unit quaternion, this is the
+    // inverse rotation.  Return a reference to this.
+    tquat& conjugate()
+    {
+        q_[0] = -q_[0];
+        q_[1] = -q_[1];
+        q_[2] = -q_[2];
+        return *this;
+    }
+
+    // Invert this.  Return a reference to this.
+    //
+    // NOTE: If this is zero, we will
+    //       throw to avoid undefined behavior.
+    tquat& inverse()
+    {
+        T n(dot(*this, *this));
+        if (n == static_cast<T>(0))
+        {
+#ifdef USE_EXCEPTIONS
+            throw std::runtime_error("Quaternion is noninvertible!!!!");
+#else // !USE_EXCEPTIONS
+            Log::error("Quaternion is noninvertible!!!!\n");
+            return *this;
+#endif // USE_EXCEPTIONS
+        }
+        conjugate();
+        return *this *= static_cast<T>(1) / n;
+    }
+
+    // Rotate a vector by this (which must be a unit quaternion).
+    const tvec3<T> rotate(const tvec3<T>& v) const
+    {
+        // v + 2w(q x v) + 2(q x (q x v)), with t = 2(q x v)
+        T tx(2 * ((q_[1] * v.z()) - (q_[2] * v.y())));
+        T ty(2 * ((q_[2] * v.x()) - (q_[0] * v.z())));
+        T tz(2 * ((q_[0] * v.y()) - (q_[1] * v.x())));
+        return tvec3<T>(v.x() + (q_[3] * tx) + ((q_[1] * tz) - (q_[2] * ty)),
+                        v.y() + (q_[3] * ty) + ((q_[2] * tx) - (q_[0] * tz)),
+                        v.z() + (q_[3] * tz) + ((q_[0] * ty) - (q_[1] * tx)));
+    }
+
+    // Return the rotation matrix of this (which must be a unit quaternion).
+    const tmat3<T> to_mat3() const
+    {
+        T x2(q_[0] + q_[0]);
+        T y2(q_[1] + q_[1]);
+        T z2(q_[2] + q_[2]);
+        T xx(q_[0] * x2);
+        T yy(q_[1] * y2);
+        T zz(q_[2] * z2);
+        T xy(q_[0] * y2);
+        T xz(q_[0] * z2);
+        T yz(q_[1] * z2);
+        T wx(q_[3] * x2);
+        T wy(q_[3] * y2);
+        T wz(q_[3] * z2);
+        return tmat3<T>(1 - (yy + zz), xy + wz, xz - wy,
+                        xy - wz, 1 - (xx + zz), yz + wx,
+                        xz + wy, yz - wx, 1 - (xx + yy));
+    }
+
+    const tmat4<T> to_mat4() const
+    {
+        tmat3<T> r(to_mat3());
+        tmat4<T> m;
+        for (int row = 0; row < 3; row++)
+        {
+            for (int col = 0; col < 3; col++)
+            {
+                m[row][col] = r[row][col];
+            }
+        }
+        return m;
+    }
+
+    const taffine4<T> to_affine4() const
+    {
+        tmat3<T> r(to_mat3());
+        taffine4<T> m;
+        for (int row = 0; row < 3; row++)
+        {
+            for (int col = 0; col < 3; col++)
+            {
+                m[row][col] = r[row][col];
+            }
+        }
+        return m;
+    }
+
+    // Print the components to standard out.
+    // Really only useful for debug and test.
+    void print() const
+    {
+        std::cout << "( " << q_[0] << " " << q_[1] << " " << q_[2] << " | "
+                  << q_[3] << " )" << std::endl;
+    }
+
+    // Allow raw data access for API calls and the like.
+    operator const T*() const { return &q_[0];}
+
+    // Test if 'rhs' is equal to this.
+    bool operator==(const tquat& rhs) const
+    {
+        return q_[0] == rhs.q_[0] &&
+               q_[1] == rhs.q_[1] &&
+               q_[2] == rhs.q_[2] &&
+               q_[3] == rhs.q_[3];
+    }
+
+    // Test if 'rhs' is not equal to this.
+    bool operator!=(const tquat& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    // Add another quaternion to this.  Return a reference to this.
+    tquat& operator+=(const tquat& rhs)
+    {
+        q_[0] += rhs.q_[0];
+        q_[1] += rhs.q_[1];
+        q_[2] += rhs.q_[2];
+        q_[3] += rhs.q_[3];
+        return *this;
+    }
+
+    // Add another quaternion to a copy of this.  Return the copy.
+    const tquat operator+(const tquat& rhs) const
+    {
+        return tquat(*this) += rhs;
+    }
+
+    // Return a negated copy of this (the same rotation).
+    const tquat operator-() const
+    {
+        return tquat(-q_[0], -q_[1], -q_[2], -q_[3]);
+    }
+
+    // Multiply this by another quaternion (Hamilton product).  Return a
+    // reference to this.
+    tquat& operator*=(const tquat& rhs)
+    {
+        T x((q_[3] * rhs.q_[0]) + (q_[0] * rhs.q_[3]) + (q_[1] * rhs.q_[2]) - (q_[2] * rhs.q_[1]));
+        T y((q_[3] * rhs.q_[1]) - (q_[0] * rhs.q_[2]) + (q_[1] * rhs.q_[3]) + (q_[2] * rhs.q_[0]));
+        T z((q_[3] * rhs.q_[2]) + (q_[0] * rhs.q_[1]) - (q_[1] * rhs.q_[0]) + (q_[2] * rhs.q_[3]));
+        T w((q_[3] * rhs.q_[3]) - (q_[0] * rhs.q_[0]) - (q_[1] * rhs.q_[1]) - (q_[2] * rhs.q_[2]));
+        q_[0] = x;
+        q_[1] = y;
+        q_[2] = z;
+        q_[3] = w;
+        return *this;
+    }
+
+    // Multiply a copy of this by another quaternion.  Return the copy.
+    const tquat operator*(const tquat& rhs) const
+    {
+        return tquat(*this) *= rhs;
+    }
+
+    // Multiply this by a scalar.  Return a reference to this.
+    tquat& operator*=(const T& rhs)
+    {
+        q_[0] *= rhs;
+        q_[1] *= rhs;
+        q_[2] *= rhs;
+        q_[3] *= rhs;
+        return *this;
+    }
+
+    // Multiply a copy of this by a scalar.  Return the copy.
+    const tquat operator*(const T& rhs) const
+    {
+        return tquat(*this) *= rhs;
+    }
+
+private:
+    void from_rows(T m00, T m01, T m02, T m10, T m11, T m12, T m20, T m21, T m22)
+    {
+        T trace(m00 + m11 + m22);
+        if (trace > 0)
+        {
+            T s(sqrt(trace + 1) * 2);
+            q_[0] = (m21 - m12) / s;
+            q_[1] = (m02 - m20) / s;
+            q_[2] = (m10 - m01) / s;
+            q_[3] = s / 4;
+        }
+        else if (m00 > m11 && m00 > m22)
+        {
+            T s(sqrt(1 + m00 - m11 - m22) * 2);
+            q_[0] = s / 4;
+            q_[1] = (m01 + m10) / s;
+            q_[2] = (m02 + m20) / s;
+            q_[3] = (m21 - m12) / s;
+        }
+        else if (m11 > m22)
+        {
+            T s(sqrt(1 + m11 - m00 - m22) * 2);
+            q_[0] = (m01 + m10) / s;
+            q_[1] = s / 4;
+            q_[2] = (m12 + m21) / s;
+            q_[3] = (m02 - m20) / s;
+        }
+        else
+        {
+            T s(sqrt(1 + m22 - m00 - m11) * 2);
+            q_[0] = (m02 + m20) / s;
+            q_[1] = (m12 + m21) / s;
+            q_[2] = s / 4;
+            q_[3] = (m10 - m01) / s;
+        }
+    }
+
+    T q_[4];
+};
+
+// Multiplication and normalization of single precision quaternions go
+// through the vectorized kernels, as tmat4 multiplication does.
+template<>
+inline tquat<float>& tquat<float>::operator*=(const tquat<float>& rhs)
+{
+    Simd::quat_multiply(q_, q_, rhs.q_, 1);
+    return *this;
+}
+
+template<>
+inline tquat<float>& tquat<float>::normalize()
+{
+    Simd::quat_normalize(q_, q_, 1);
+    return *this;
+}
+
+// Normalized linear interpolation between two unit quaternions, taking the
+// shorter way around.  Cheaper than slerp(), but the angular speed is not
+// constant over 't'.
+template<typename T>
+const tquat<T> nlerp(const tquat<T>& a, const tquat<T>& b, const T& t)
+{
+    T tb(tquat<T>::dot(a, b) < 0 ? -t : t);
+    tquat<T> q((a * (1 - t)) + (b * tb));
+    return q.normalize();
+}
+
+// Spherical linear interpolation between two unit quaternions, taking the
+// shorter way around.
+template<typename T>
+const tquat<T> slerp(const tquat<T>& a, const tquat<T>& b, const T& t)
+{
+    T d(tquat<T>::dot(a, b));
+    T sign(1);
+    if (d < 0)
+    {
+        d = -d;
+        sign = -1;
+    }
+    // Nearly parallel: sin(theta) is too small to divide by, and the arc is
+    // indistinguishable from the chord.
+    if (d > static_cast<T>(0.9995))
+    {
+        return nlerp(a, b, t);
+    }
+    T theta(acos(d));
+    T s(sin(theta));
+    T wa(sin((1 - t) * theta) / s);
+    T wb(sign * sin(t * theta) / s);
+    return (a * wa) + (b * wb);
+}
+
+// A template class for a dual quaternion, representing a rigid transform
+// (rotation followed by translation).  Blending dual quaternions, unlike
+// blending matrices, gives rigid transforms, which is why they are used for
+// skinning.
+template<typename T>
+class tdualquat
+{
+public:
+    tdualquat() : real_(), dual_(0, 0, 0, 0) {}
+    tdualquat(const tquat<T>& real, const tquat<T>& dual) : real_(real), dual_(dual) {}
+    // A rotation (which must be a unit quaternion) followed by a translation.
+    tdualquat(const tquat<T>& rotation, const tvec3<T>& translation) :
+        real_(rotation),
+        dual_(tquat<T>(translation.x(), translation.y(), translation.z(), 0) * rotation * static_cast<T>(0.5))
+    {
+    }
+    // Take the rotation and translation of a rigid transform matrix.
+    explicit tdualquat(const tmat4<T>& m) :
+        tdualquat(tquat<T>(m), tvec3<T>(m[0][3], m[1][3], m[2][3])) {}
+    explicit tdualquat(const taffine4<T>& m) :
+        tdualquat(tquat<T>(m), tvec3<T>(m[0][3], m[1][3], m[2][3])) {}
+    ~tdualquat() {}
+
+    const tquat<T>& real() const { return real_; }
+    const tquat<T>& dual() const { return dual_; }
+
+    // Return the rotation part of this.
+    const tquat<T>& rotation() const { return real_; }
+
+    // Return the translation part of this.
+    const tvec3<T> translation() const
+    {
+        tquat<T> t(dual_ * tquat<T>(real_).conjugate());
+        return tvec3<T>(2 * t.x(), 2 * t.y(), 2 * t.z());
+    }
+
+    // Make the real part a unit quaternion, and the dual part orthogonal to
+    // it, so that this is a rigid transform again (e.g. after blending).
+    // Return a reference to this.
+    tdualquat& normalize()
+    {
+        T l(real_.length());
+        if (l == 0)
+        {
+            return *this;
+        }
+        real_ *= static_cast<T>(1) / l;
+        dual_ *= static_cast<T>(1) / l;
+        dual_ += real_ * -tquat<T>::dot(real_, dual_);
+        return *this;
+    }
+
+    // Invert this rigid transform.  Return a reference to this.
+    tdualquat& inverse()
+    {
+        real_.conjugate();
+        dual_.conjugate();
+        return *this;
+    }
+
+    // Transform a point by this.
+    const tvec3<T> transform_point(const tvec3<T>& p) const
+    {
+        tvec3<T> r(real_.rotate(p));
+        tvec3<T> t(translation());
+        return tvec3<T>(r.x() + t.x(), r.y() + t.y(), r.z() + t.z());
+    }
+
+    // Transform a direction by this (only the rotation applies).
+    const tvec3<T> transform_vector(const tvec3<T>& v) const
+    {
+        return real_.rotate(v);
+    }
+
+    const taffine4<T> to_affine4() const
+    {
+        taffine4<T> m(real_.to_affine4());
+        tvec3<T> t(translation());
+        m[0][3] = t.x();
+        m[1][3] = t.y();
+        m[2][3] = t.z();
+        return m;
+    }
+
+    const tmat4<T> to_mat4() const
+    {
+        return to_affine4().to_mat4();
+    }
+
+    // Compose this with another rigid transform (this = this * rhs, so rhs
+    // applies first).  Return a reference to this.
+    tdualquat& operator*=(const tdualquat& rhs)
+    {
+        dual_ = (real_ * rhs.dual_) + (dual_ * rhs.real_);
+        real_ *= rhs.real_;
+        return *this;
+    }
+
+    // Compose a copy of this with another rigid transform.  Return the copy.
+    const tdualquat operator*(const tdualquat& rhs) const
+    {
+        return tdualquat(*this) *= rhs;
+    }
+
+    bool operator==(const tdualquat& rhs) const
+    {
+        return real_ == rhs.real_ && dual_ == rhs.dual_;
+    }
+
+    bool operator!=(const tdualquat& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+private:
+    tquat<T> real_;
+    tquat<T> dual_;
+};
+
+// The three quaternion products of a single precision composition go to
+// the kernels as one batch.
+template<>
+inline tdualquat<float>& tdualquat<float>::operator*=(const tdualquat<float>& rhs)
+{
+    float a[12];
+    float b[12];
+    float r[12];
+    std::copy_n(static_cast<const float*>(real_), 4, a);
+    std::copy_n(static_cast<const float*>(dual_), 4, a + 4);
+    std::copy_n(static_cast<const float*>(real_), 4, a + 8);
+    std::copy_n(static_cast<const float*>(rhs.dual_), 4, b);
+    std::copy_n(static_cast<const float*>(rhs.real_), 4, b + 4);
+    std::copy_n(static_cast<const float*>(rhs.real_), 4, b + 8);
+    Simd::quat_multiply(r, a, b, 3);
+    dual_ = tquat<float>(r[0] + r[4], r[1] + r[5], r[2] + r[6], r[3] + r[7]);
+    real_ = tquat<float>(r[8], r[9], r[10], r[11]);
+    return *this;
+}
+
+// Blend two rigid transforms linearly and renormalize ("dual quaternion
+// linear blending"), taking the shorter way around.
+template<typename T>
+const tdualquat<T> nlerp(const tdualquat<T>& a, const tdualquat<T>& b, const T& t)
+{
+    T tb(tquat<T>::dot(a.real(), b.real()) < 0 ? -t : t);
+    tdualquat<T> q((a.real() * (1 - t)) + (b.real() * tb),
+                   (a.dual() * (1 - t)) + (b.dual() * tb));
+    return q.normalize();
+}
+
+//
+// Convenience typedefs.
+//
+typedef tquat<float> quat;
+typedef tquat<double> dquat;
+typedef tdualquat<float> dualquat;
+typedef tdualquat<double> ddualquat;
+
+namespace Quat
+{
+
+// Generate a rotation of 'angle' degrees about the axis (x, y, z), to match
+// Mat4::rotate().
+quat rotate(float angle, float x, float y, float z);
+
+//
+// Batched interpolation for blending many rotations at once (e.g. the bones
+// of a skeleton).  dst[i] is the interpolation of a[i] and b[i], by 't' or
+// by t[i].  The destination may be the same array as either input.  Only
+// as many elements as are in the shortest array are processed (or an
+// exception is thrown when built with USE_EXCEPTIONS).
+//
+// These avoid the branches and trigonometry of slerp() with a polynomial
+// approximation (Eberly, "A Fast and Accurate Algorithm for Computing
+// SLERP"), so that the loop vectorizes; the result is accurate to within
+// a few float ulps.
+//
+void slerp(std::span<quat> dst, std::span<const quat> a,
+           std::span<const quat> b, float t);
+void slerp(std::span<quat> dst, std::span<const quat> a,
+           std::span<const quat> b, std::span<const float> t);
+void nlerp(std::span<quat> dst, std::span<const quat> a,
+           std::span<const quat> b, float t);
+
+} // namespace Quat
+} // namespace LibMatrix
+
+#endif // QUAT_H_
@@ -0,0 +1,247 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+#include "shader-permutations.h"
+#include "util.h"
+
+/**
+ * Adds an axis of values for a preprocessor define.
+ *
+ * "#define name value" is added at global scope (see ShaderSource::add()).
+ *
+ * @param name the name of the define
+ * @param values the values it takes
+ */
+void
+ShaderPermutations::add_define(const std::string &name,
+                               const std::vector<std::string> &values)
+{
+    add_axis(values.size(), [name, values](ShaderSource &source, size_t i) {
+        source.add("#define " + name + " " + values[i] + "\n");
+    });
+}
+
+/**
+ * Adds an axis of values for a float constant.
+ *
+ * @param name the name of the constant
+ * @param values the values it takes
+ * @param function if not empty, the function to put the definition in
+ */
+void
+ShaderPermutations::add_const(const std::string &name,
+                              const std::vector<float> &values,
+                              const std::string &function)
+{
+    add_axis(values.size(), [name, values, function](ShaderSource &source, size_t i) {
+        source.add_const(name, values[i], function);
+    });
+}
+
+/**
+ * Adds an axis of replacements for a string in the base source.
+ *
+ * @param remove the string to replace
+ * @param values the strings to replace it with
+ */
+void
+ShaderPermutations::add_replace(const std::string &remove,
+                                const std::vector<std::string> &values)
+{
+    Axis axis;
+    axis.count = values.size();
+    axis.replace = replaces_.size();
+    axes_.push_back(axis);
+    replaces_.push_back(std::make_pair(remove, values));
+}
+
+/**
+ * Adds an axis of precisions.
+ *
+ * @param values the precisions to use
+ */
+void
+ShaderPermutations::add_precision(const std::vector<ShaderSource::Precision> &values)
+{
+    add_axis(values.size(), [values](ShaderSource &source, size_t i) {
+        source.precision(values[i]);
+    });
+}
+
+/**
+ * Adds an axis of arbitrary edits.
+ *
+ * The function is called from several threads at once (each with its
+ * own source), so it must not change shared state.
+ *
+ * @param count the number of values on the axis
+ * @param apply applies value i to a source
+ */
+void
+ShaderPermutations::add_axis(size_t count,
+                             const std::function<void(ShaderSource &, size_t)> &apply)
+{
+    Axis axis;
+    axis.count = count;
+    axis.replace = -1;
+    axis.apply = apply;
+    axes_.push_back(axis);
+}
+
+/**
+ * Gets the number of permutations (the product of the sizes of the axes).
+ *
+ * @return the number of permutations
+ */
+size_t
+ShaderPermutations::size() const
+{
+    size_t size = 1;
+
+    for (std::vector<Axis>::const_iterator axis = axes_.begin();
+         axis != axes_.end();
+         axis++)
+    {
+        size *= axis->count;
+    }
+
+    return size;
+}
+
+/**
+ * Gets the number of a permutation from its choice on each axis.
+ *
+ * @param choices the index of the value on each axis, in the order the
+ *                axes were added
+ *
+ * @return the permutation, or size() if the choices are not valid
+ */
+size_t
+ShaderPermutations::permutation(const std::vector<unsigned int> &choices) const
+{
+    if (choices.size() != axes_.size())
+        return size();
+
+    size_t permutation = 0;
+
+    for (size_t i = 0; i < axes_.size(); i++) {
+        if (choices[i] >= axes_[i].count)
+            return size();
+        permutation = permutation * axes_[i].count + choices[i];
+    }
+
+    return permutation;
+}
+
+/**
+ * Builds the source of one permutation.
+ *
+ * @param permutation the permutation
+ *
+ * @return the source (see ShaderSource::str())
+ */
+std::string
+ShaderPermutations::build(size_t permutation) const
+{
+    std::vector<size_t> choices(axes_.size());
+
+    for (size_t i = axes_.size(); i-- > 0; ) {
+        choices[i] = permutation % axes_[i].count;
+        permutation /= axes_[i].count;
+    }
+
+    ShaderSource source(base_);
+
+    if (!replaces_.empty()) {
+        std::vector<std::pair<std::string, std::string> > replacements;
+        replacements.reserve(replaces_.size());
+        for (size_t i = 0; i < axes_.size(); i++) {
+            if (axes_[i].replace < 0)
+                continue;
+            const std::pair<std::string, std::vector<std::string> > &replace(replaces_[axes_[i].replace]);
+            replacements.push_back(std::make_pair(replace.first, replace.second[choices[i]]));
+        }
+        source.replace_all(replacements);
+    }
+
+    for (size_t i = 0; i < axes_.size(); i++) {
+        if (axes_[i].replace < 0)
+            axes_[i].apply(source, choices[i]);
+    }
+
+    return source.str();
+}
+
+/**
+ * Builds all of the permutations, and sorts them into variants.
+ *
+ * Permutations are handed out to the threads one at a time, so that a
+ * few slow ones don't hold up the rest.  Sources are told apart by their
+ * hash, and compared in full only when the hashes match.
+ *
+ * @param threads the number of threads to use (0 for one per processor)
+ */
+void
+ShaderPermutations::expand(unsigned int threads)
+{
+    size_t count = size();
+    std::vector<std::string> built(count);
+    std::vector<uint64_t> hashes(count);
+    std::atomic<size_t> next(0);
+
+    std::function<void()> work([&]() {
+        size_t permutation;
+        while ((permutation = next.fetch_add(1)) < count) {
+            built[permutation] = build(permutation);
+            hashes[permutation] = Util::hash(built[permutation]);
+        }
+    });
+
+    if (threads == 0)
+        threads = Util::get_num_processors();
+    if (threads > count)
+        threads = count;
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < threads; i++)
+        workers.emplace_back(work);
+    work();
+    for (std::vector<std::thread>::iterator worker = workers.begin();
+         worker != workers.end();
+         worker++)
+    {
+        worker->join();
+    }
+
+    /* Number the distinct sources in permutation order */
+    std::unordered_multimap<uint64_t, unsigned int> by_hash;
+    variants_.assign(count, 0);
+    sources_.clear();
+
+    for (size_t permutation = 0; permutation < count; permutation++) {
+        typedef std::unordered_multimap<uint64_t, unsigned int>::const_iterator Iterator;
+        std::pair<Iterator, Iterator> same(by_hash.equal_range(hashes[permutation]));
+        Iterator found = same.first;
+        while (found != same.second && sources_[found->second] != built[permutation])
+            found++;
+
+        if (found != same.second) {
+            variants_[permutation] = found->second;
+        }
+        else {
+            unsigned int variant = sources_.size();
+            by_hash.insert(std::make_pair(hashes[permutation], variant));
+            sources_.push_back(std::move(built[permutation]));
+            variants_[permutation] = variant;
+        }
+    }
+}
@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef SHADER_PERMUTATIONS_H_
+#define SHADER_PERMUTATIONS_H_
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "shader-source.h"
+
+/**
+ * Generates the permutations of a shader.
+ *
+ * A permutation is one choice of value on each of a set of axes (defines,
+ * constants, replacements and precisions), applied to a copy of a base
+ * ShaderSource.  expand() builds all of them, spread over several
+ * threads, and folds permutations whose sources come out the same into
+ * one variant:
+ *
+ *     ShaderPermutations perms(base);
+ *     perms.add_define("LIGHTS", {"1", "2", "4"});
+ *     perms.add_const("Shininess", {8.0f, 32.0f});
+ *     perms.expand();
+ *     ...
+ *     unsigned int v = perms.variant(perms.permutation({2, 0}));
+ *     program.addShader(GL_FRAGMENT_SHADER, perms.variant_source(v));
+ *
+ * Permutations are numbered with the first axis varying slowest.  Variant
+ * IDs are handed out in order of the first permutation producing each
+ * source, so they do not depend on the number of threads or on timing.
+ */
+class ShaderPermutations
+{
+public:
+    ShaderPermutations(const ShaderSource &base) : base_(base) {}
+
+    /*
+     * Axes, in the order they are applied.  Replacements are applied
+     * first (all together, see ShaderSource::replace_all()), so that they
+     * only affect the base source; the others are applied in the order
+     * they were added.
+     */
+    void add_define(const std::string &name, const std::vector<std::string> &values);
+    void add_const(const std::string &name, const std::vector<float> &values,
+                   const std::string &function = "");
+    void add_replace(const std::string &remove, const std::vector<std::string> &values);
+    void add_precision(const std::vector<ShaderSource::Precision> &values);
+    void add_axis(size_t count,
+                  const std::function<void(ShaderSource &, size_t)> &apply);
+
+    size_t size() const;
+    size_t permutation(const std::vector<unsigned int> &choices) const;
+
+    void expand(unsigned int threads = 0);
+
+    /* Results of the last expand() */
+    unsigned int variant(size_t permutation) const { return variants_[permutation]; }
+    unsigned int num_variants() const { return sources_.size(); }
+    const std::string &variant_source(unsigned int variant) const { return sources_[variant]; }
+
+private:
+    struct Axis
+    {
+        size_t count;
+        /* The replace axis this is, or -1 */
+        int replace;
+        std::function<void(ShaderSource &, size_t)> apply;
+    };
+
+    std::string build(size_t permutation) const;
+
+    ShaderSource base_;
+    std::vector<Axis> axes_;
+    /* The strings to replace, and their values, for replace axes */
+    std::vector<std::pair<std::string, std::vector<std::string> > > replaces_;
+    std::vector<unsigned int> variants_;
+    std::vector<std::string> sources_;
+};
+
+#endif // SHADER_PERMUTATIONS_H_
@@ -10,8 +10,11 @@
 //     Alexandros Frantzis <alexandros.frantzis@linaro.org>
 //     Jesse Barker <jesse.barker@linaro.org>
 //
+#include <algorithm>
+#include <charconv>
 #include <istream>
 #include <memory>
+#include <queue>
 
 #include "shader-source.h"
 #include "log.h"
@@ -46,6 +49,228 @@ bool is_valid_shader_type(ShaderSource::ShaderType shader_type)
     }
 }
 
+/**
+ * Appends a float as a GLSL float literal.
+ *
+ * This is the shortest string that reads back as the same float, with
+ * ".0" added if it would otherwise be an integer literal.
+ */
+void append_float(std::string &str, float f)
+{
+    char buf[32];
+    char *end = std::to_chars(buf, buf + sizeof(buf), f).ptr;
+    std::string_view literal(buf, end - buf);
+
+    str += literal;
+    if (literal.find_first_of(".en") == std::string_view::npos)
+        str += ".0";
+}
+
+/**
+ * Aho-Corasick automaton matching all of the strings to be replaced by
+ * ShaderSource::replace_all() in a single pass over the source.
+ *
+ * The automaton is a complete DFA over classes of characters (one for
+ * each character used in the patterns, and one for all others), so
+ * matching takes one table lookup per character of the source.
+ */
+class ReplaceAutomaton
+{
+public:
+    ReplaceAutomaton(std::span<const std::pair<std::string, std::string> > replacements);
+
+    bool matches(std::span<const std::pair<std::string, std::string> > replacements) const;
+    bool apply(const std::string &source,
+               std::span<const std::pair<std::string, std::string> > replacements,
+               std::string &result) const;
+
+private:
+    /* A match of a pattern (by index) starting at a position */
+    struct Match
+    {
+        size_t start;
+        int pattern;
+    };
+
+    unsigned int add_state();
+
+    std::vector<std::string> patterns_;
+    unsigned char classes_[256];
+    unsigned int num_classes_;
+    /* Next state for each state and character class */
+    std::vector<int> next_;
+    /* The pattern (by index) that ends at each state, or -1 */
+    std::vector<int> terminal_;
+    /* The next state on the failure chain that ends a pattern, or -1 */
+    std::vector<int> output_;
+    /* The matches found by apply(), kept to reuse the storage */
+    mutable std::vector<Match> matches_;
+};
+
+ReplaceAutomaton::ReplaceAutomaton(std::span<const std::pair<std::string, std::string> > replacements) :
+    num_classes_(1)
+{
+    std::fill(classes_, classes_ + 256, 0);
+
+    for (size_t i = 0; i < replacements.size(); i++) {
+        const std::string &pattern(replacements[i].first);
+        patterns_.push_back(pattern);
+        for (size_t c = 0; c < pattern.size(); c++) {
+            unsigned char &cls(classes_[static_cast<unsigned char>(pattern[c])]);
+            if (!cls)
+                cls = num_classes_++;
+        }
+    }
+
+    /* Build the trie (-1 marks a missing transition) */
+    add_state();
+    for (size_t i = 0; i < patterns_.size(); i++) {
+        const std::string &pattern(patterns_[i]);
+        if (pattern.empty())
+            continue;
+
+        unsigned int state = 0;
+        for (size_t c = 0; c < pattern.size(); c++) {
+            size_t index = state * num_classes_ + classes_[static_cast<unsigned char>(pattern[c])];
+            if (next_[index] < 0) {
+                /* Adding a state grows next_, so don't hold on to it */
+                int next = add_state();
+                next_[index] = next;
+            }
+            state = next_[index];
+        }
+        if (terminal_[state] < 0)
+            terminal_[state] = i;
+    }
+
+    /*
+     * Turn it into a DFA, breadth first: a missing transition goes where
+     * the failure state (the longest proper suffix in the trie) goes.
+     */
+    std::vector<int> fail(terminal_.size(), 0);
+    std::queue<unsigned int> states;
+    states.push(0);
+    while (!states.empty()) {
+        unsigned int state = states.front();
+        states.pop();
+        for (unsigned int cls = 0; cls < num_classes_; cls++) {
+            int &next(next_[state * num_classes_ + cls]);
+            int fallback = state ? next_[fail[state] * num_classes_ + cls] : 0;
+            if (next < 0) {
+                next = fallback;
+                continue;
+            }
+            fail[next] = fallback;
+            output_[next] = terminal_[fallback] >= 0 ? fallback : output_[fallback];
+            states.push(next);
+        }
+    }
+}
+
+unsigned int
+ReplaceAutomaton::add_state()
+{
+    next_.resize(next_.size() + num_classes_, -1);
+    terminal_.push_back(-1);
+    output_.push_back(-1);
+    return terminal_.size() - 1;
+}
+
+/**
+ * Whether the automaton matches the strings to be replaced by a set of
+ * replacements (the strings to replace them with may differ).
+ */
+bool
+ReplaceAutomaton::matches(std::span<const std::pair<std::string, std::string> > replacements) const
+{
+    if (replacements.size() != patterns_.size())
+        return false;
+
+    for (size_t i = 0; i < patterns_.size(); i++) {
+        if (replacements[i].first != patterns_[i])
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Applies a set of replacements to a source.
+ *
+ * Matches are replaced left to right without overlapping, and text that
+ * has been put in is not searched again.  Of the matches starting at the
+ * same place, the longest wins (and of equal ones, the first).
+ *
+ * @param source the source
+ * @param replacements the replacements, with the patterns the automaton
+ *                     was built for
+ * @param result set to the source after replacement
+ *
+ * @return whether anything was replaced (result is only set if so)
+ */
+bool
+ReplaceAutomaton::apply(const std::string &source,
+                        std::span<const std::pair<std::string, std::string> > replacements,
+                        std::string &result) const
+{
+    std::vector<Match> &matches(matches_);
+    unsigned int state = 0;
+
+    matches.clear();
+    for (size_t i = 0; i < source.size(); i++) {
+        state = next_[state * num_classes_ + classes_[static_cast<unsigned char>(source[i])]];
+        int found = terminal_[state] >= 0 ? state : output_[state];
+        for (; found >= 0; found = output_[found]) {
+            int pattern = terminal_[found];
+            matches.push_back(Match{i + 1 - patterns_[pattern].size(), pattern});
+        }
+    }
+
+    if (matches.empty())
+        return false;
+
+    /*
+     * Matches are found in order of where they end: put them in order of
+     * where they start, longest (then first) first, and drop those that
+     * overlap one already taken.
+     */
+    std::sort(matches.begin(), matches.end(), [this](const Match &a, const Match &b) {
+        if (a.start != b.start)
+            return a.start < b.start;
+        if (patterns_[a.pattern].size() != patterns_[b.pattern].size())
+            return patterns_[a.pattern].size() > patterns_[b.pattern].size();
+        return a.pattern < b.pattern;
+    });
+    size_t taken = 0;
+    size_t end = 0;
+    for (size_t m = 0; m < matches.size(); m++) {
+        if (matches[m].start < end)
+            continue;
+        end = matches[m].start + patterns_[matches[m].pattern].size();
+        matches[taken++] = matches[m];
+    }
+    matches.resize(taken);
+
+    /* Work out the size first, so that the result is allocated once */
+    size_t size = source.size();
+    for (size_t m = 0; m < matches.size(); m++) {
+        size -= patterns_[matches[m].pattern].size();
+        size += replacements[matches[m].pattern].second.size();
+    }
+
+    result.clear();
+    result.reserve(size);
+    size_t pos = 0;
+    for (size_t m = 0; m < matches.size(); m++) {
+        result.append(source, pos, matches[m].start - pos);
+        result += replacements[matches[m].pattern].second;
+        pos = matches[m].start + patterns_[matches[m].pattern].size();
+    }
+    result.append(source, pos, std::string::npos);
+
+    return true;
+}
+
 }
 
 /**
@@ -55,6 +280,205 @@ bool is_valid_shader_type(ShaderSource::ShaderType shader_type)
 std::vector<ShaderSource::Precision>
 ShaderSource::default_precision_(ShaderSource::ShaderTypeUnknown + 1);
 
+/**
+ * Makes sure a piece starts at a position in the text.
+ *
+ * @param pos the position
+ *
+ * @return the index of the piece starting at pos (the number of pieces,
+ *         if pos is the end of the text)
+ */
+size_t
+ShaderSource::Text::split(size_t pos)
+{
+    size_t offset = 0;
+
+    for (size_t i = 0; i < pieces_.size(); i++) {
+        if (offset == pos)
+            return i;
+
+        size_t end = offset + pieces_[i].length;
+        if (pos < end) {
+            Piece tail = { pieces_[i].start + (pos - offset), end - pos };
+            pieces_[i].length = pos - offset;
+            pieces_.insert(pieces_.begin() + i + 1, tail);
+            return i + 1;
+        }
+        offset = end;
+    }
+
+    return pieces_.size();
+}
+
+/**
+ * Inserts a string into the text.
+ *
+ * @param pos the position to insert at (clamped to the end of the text)
+ * @param str the string to insert
+ */
+void
+ShaderSource::Text::insert(size_t pos, std::string_view str)
+{
+    if (str.empty())
+        return;
+
+    /*
+     * Finding a position gets slower as the pieces multiply, and text that
+     * has been removed stays in the buffer, so every so often start afresh.
+     */
+    if (pieces_.size() > 1024 || buffer_.size() > 2 * size_ + 4096) {
+        buffer_ = this->str();
+        pieces_.assign(1, Piece{0, size_});
+        if (!size_)
+            pieces_.clear();
+    }
+
+    pos = std::min(pos, size_);
+    size_t start = buffer_.size();
+    buffer_.append(str);
+
+    size_t i = split(pos);
+    /* Repeated appends just extend the piece before */
+    if (i > 0 && pieces_[i - 1].start + pieces_[i - 1].length == start) {
+        pieces_[i - 1].length += str.size();
+    }
+    else {
+        Piece piece = { start, str.size() };
+        pieces_.insert(pieces_.begin() + i, piece);
+    }
+
+    size_ += str.size();
+    flat_valid_ = false;
+}
+
+/**
+ * Replaces the whole text.
+ *
+ * @param str the new text, which is taken over
+ */
+void
+ShaderSource::Text::assign(std::string &&str)
+{
+    buffer_ = std::move(str);
+    size_ = buffer_.size();
+    pieces_.clear();
+    if (size_)
+        pieces_.push_back(Piece{0, size_});
+    flat_valid_ = false;
+}
+
+/**
+ * Finds the first occurrence of a string in the text.
+ *
+ * @param str the string to look for
+ * @param pos the position to start looking from
+ *
+ * @return the position of the string, or std::string::npos
+ */
+size_t
+ShaderSource::Text::find(std::string_view str, size_t pos) const
+{
+    /* Many small pieces are quicker to search put together */
+    if (flat_valid_ || pieces_.size() > 32)
+        return this->str().find(str, pos);
+
+    if (str.empty())
+        return pos <= size_ ? pos : std::string::npos;
+
+    /*
+     * Search each piece in place.  A match that straddles pieces is found
+     * by searching the end of the text before a piece (at most
+     * str.size() - 1 characters, kept in 'carry') joined to its start.
+     */
+    std::string_view buffer(buffer_);
+    std::string carry;
+    std::string window;
+    size_t carry_pos = pos;
+    size_t offset = 0;
+
+    for (std::vector<Piece>::const_iterator piece = pieces_.begin();
+         piece != pieces_.end();
+         piece++)
+    {
+        size_t end = offset + piece->length;
+        if (end <= pos) {
+            offset = end;
+            continue;
+        }
+
+        size_t skip = pos > offset ? pos - offset : 0;
+        std::string_view text(buffer.substr(piece->start + skip, piece->length - skip));
+
+        if (!carry.empty()) {
+            window.assign(carry);
+            window.append(text.substr(0, str.size() - 1));
+            size_t found = window.find(str);
+            if (found != std::string::npos && found < carry.size())
+                return carry_pos + found;
+        }
+
+        size_t found = text.find(str);
+        if (found != std::string::npos)
+            return offset + skip + found;
+
+        carry.append(text);
+        if (carry.size() >= str.size()) {
+            carry.erase(0, carry.size() - (str.size() - 1));
+        }
+        carry_pos = end - carry.size();
+        offset = end;
+    }
+
+    return std::string::npos;
+}
+
+/**
+ * Finds the last occurrence of a string in the text.
+ *
+ * @param str the string to look for
+ *
+ * @return the position of the string, or std::string::npos
+ */
+size_t
+ShaderSource::Text::rfind(std::string_view str) const
+{
+    if (flat_valid_ || pieces_.size() > 32)
+        return this->str().rfind(str);
+
+    size_t last = std::string::npos;
+    size_t pos = 0;
+
+    while ((pos = find(str, pos)) != std::string::npos) {
+        last = pos;
+        pos++;
+    }
+
+    return last;
+}
+
+/**
+ * Gets the whole text.
+ *
+ * @return the text, valid until the next change
+ */
+const std::string&
+ShaderSource::Text::str() const
+{
+    if (!flat_valid_) {
+        flat_.clear();
+        flat_.reserve(size_);
+        for (std::vector<Piece>::const_iterator piece = pieces_.begin();
+             piece != pieces_.end();
+             piece++)
+        {
+            flat_.append(buffer_, piece->start, piece->length);
+        }
+        flat_valid_ = true;
+    }
+
+    return flat_;
+}
+
 /**
  * Loads the contents of a file into a string.
  *
@@ -92,7 +516,8 @@ ShaderSource::load_file(const std::string& filename, std::string& str)
 void
 ShaderSource::append(const std::string &str)
 {
-    source_ << str;
+    forget_anchors();
+    source_.append(str);
 }
 
 /**
@@ -105,28 +530,90 @@ ShaderSource::append_file(const std::string &filename)
 {
     std::string source;
     if (load_file(filename, source))
-        source_ << source;
+        append(source);
 }
 
 /**
  * Replaces a string in the source with another string.
  *
+ * Occurrences are replaced left to right, and the text put in is not
+ * searched again.
+ *
  * @param remove the string to replace
  * @param insert the string to replace with
  */
 void
 ShaderSource::replace(const std::string &remove, const std::string &insert)
 {
-    std::string::size_type pos = 0;
-    std::string str(source_.str());
+    if (remove.empty())
+        return;
 
-    while ((pos = str.find(remove, pos)) != std::string::npos) {
-        str.replace(pos, remove.size(), insert);
-        pos++;
+    const std::string &source(source_.str());
+    size_t pos = source.find(remove);
+    if (pos == std::string::npos)
+        return;
+
+    /* Count the matches first, so that the result is allocated once */
+    size_t count = 0;
+    for (size_t p = pos; p != std::string::npos; p = source.find(remove, p + remove.size()))
+        count++;
+
+    std::string result;
+    result.reserve(source.size() - count * remove.size() + count * insert.size());
+    size_t start = 0;
+    for (; pos != std::string::npos; pos = source.find(remove, start)) {
+        result.append(source, start, pos - start);
+        result += insert;
+        start = pos + remove.size();
     }
+    result.append(source, start, std::string::npos);
 
-    source_.clear();
-    source_.str(str);
+    forget_anchors();
+    source_.assign(std::move(result));
+}
+
+/**
+ * Replaces several strings in the source at once.
+ *
+ * The source is scanned once, left to right, for all of the strings to
+ * replace, and the text put in is not scanned again.  Where several of
+ * the strings match at the same place, the longest is replaced.
+ *
+ * The matchers built for the last few sets of strings to replace are
+ * kept, so calling this repeatedly with the same strings (e.g. for each
+ * permutation of a shader) only builds one once per thread, even if calls
+ * with other strings come in between.
+ *
+ * @param replacements pairs of the string to replace and the string to
+ *                     replace it with
+ */
+void
+ShaderSource::replace_all(std::span<const std::pair<std::string, std::string> > replacements)
+{
+    /* Most recently used first */
+    static thread_local std::vector<std::unique_ptr<ReplaceAutomaton> > automata;
+    static const size_t max_automata = 8;
+
+    size_t found = 0;
+    while (found < automata.size() && !automata[found]->matches(replacements))
+        found++;
+
+    if (found == automata.size()) {
+        if (automata.size() == max_automata)
+            automata.pop_back();
+        automata.insert(automata.begin(),
+                        std::unique_ptr<ReplaceAutomaton>(new ReplaceAutomaton(replacements)));
+    }
+    else if (found) {
+        std::rotate(automata.begin(), automata.begin() + found, automata.begin() + found + 1);
+    }
+
+    const std::unique_ptr<ReplaceAutomaton> &automaton(automata.front());
+    std::string result;
+    if (automaton->apply(source_.str(), replacements, result)) {
+        forget_anchors();
+        source_.assign(std::move(result));
+    }
 }
 
 /**
@@ -153,36 +640,48 @@ ShaderSource::replace_with_file(const std::string &remove, const std::string &fi
  */
 void
 ShaderSource::add_global(const std::string &str)
+{
+    if (global_anchor_ == std::string::npos)
+        global_anchor_ = global_position();
+
+    insert_at(global_anchor_, str);
+}
+
+/**
+ * Finds where add_global() adds strings: at the start of the line after
+ * the last precision qualifier (or the #endif of the preprocessor block
+ * containing it), or at the start of the source if there is none.
+ *
+ * @return the position, or std::string::npos if the line does not end
+ */
+size_t
+ShaderSource::global_position() const
 {
     std::string::size_type pos = 0;
-    std::string source(source_.str());
 
     /* Find the last precision qualifier */
-    pos = source.rfind("precision");
+    pos = source_.rfind("precision");
 
     if (pos != std::string::npos) {
         /*
          * Find the next #endif line of a preprocessor block that contains
          * the precision qualifier.
          */
-        std::string::size_type pos_if = source.find("#if", pos);
-        std::string::size_type pos_endif = source.find("#endif", pos);
+        std::string::size_type pos_if = source_.find("#if", pos);
+        std::string::size_type pos_endif = source_.find("#endif", pos);
 
         if (pos_endif != std::string::npos && pos_endif < pos_if)
             pos = pos_endif;
 
         /* Go to the next line */
-        pos = source.find("\n", pos);
+        pos = source_.find("\n", pos);
         if (pos != std::string::npos)
             pos++;
     }
     else
         pos = 0;
 
-    source.insert(pos, str);
-
-    source_.clear();
-    source_.str(source);
+    return pos;
 }
 
 /**
@@ -196,23 +695,105 @@ ShaderSource::add_global(const std::string &str)
  */
 void
 ShaderSource::add_local(const std::string &str, const std::string &function)
+{
+    std::map<std::string, size_t>::iterator anchor = local_anchors_.find(function);
+    if (anchor == local_anchors_.end())
+        anchor = local_anchors_.insert(std::make_pair(function, local_position(function))).first;
+
+    insert_at(anchor->second, str);
+}
+
+/**
+ * Finds where add_local() adds strings to a function: at the start of the
+ * line after the first '{' following the function's name.
+ *
+ * @param function the function
+ *
+ * @return the position, or std::string::npos if there is no such line
+ */
+size_t
+ShaderSource::local_position(const std::string &function) const
 {
     std::string::size_type pos = 0;
-    std::string source(source_.str());
 
     /* Find the function */
-    pos = source.find(function);
-    pos = source.find('{', pos);
+    pos = source_.find(function);
+    pos = source_.find("{", pos);
 
     /* Go to the next line */
-    pos = source.find("\n", pos);
+    pos = source_.find("\n", pos);
     if (pos != std::string::npos)
         pos++;
 
-    source.insert(pos, str);
+    return pos;
+}
+
+/**
+ * Inserts a string added by add_global() or add_local(), and updates the
+ * insertion points they have found.
+ *
+ * An insertion point is found by searching the source, which is slow for
+ * large sources, so it is kept for as long as the insertions can't have
+ * changed what the searches would find.  Insertion points start lines
+ * (or the source), so that is the case if the string ends a line (no
+ * match can span its ends) and does not contain any of the strings
+ * searched for.  Otherwise the insertion point is forgotten, and found
+ * again next time.
+ *
+ * @param pos the position to insert at, or std::string::npos if none was
+ *            found, in which case the string is appended
+ * @param str the string to insert
+ */
+void
+ShaderSource::insert_at(size_t pos, const std::string &str)
+{
+    if (pos == std::string::npos) {
+        forget_anchors();
+        source_.append(str);
+        return;
+    }
+
+    source_.insert(pos, str);
 
-    source_.clear();
-    source_.str(source);
+    bool ends_line = !str.empty() && str[str.size() - 1] == '\n';
+
+    if (global_anchor_ != std::string::npos) {
+        if (!ends_line ||
+            str.find("precision") != std::string::npos ||
+            str.find("#if") != std::string::npos ||
+            str.find("#endif") != std::string::npos)
+        {
+            global_anchor_ = std::string::npos;
+        }
+        else if (pos < global_anchor_) {
+            global_anchor_ += str.size();
+        }
+    }
+
+    std::map<std::string, size_t>::iterator anchor = local_anchors_.begin();
+    while (anchor != local_anchors_.end()) {
+        if (!ends_line ||
+            str.find(anchor->first) != std::string::npos ||
+            str.find('{') != std::string::npos)
+        {
+            anchor = local_anchors_.erase(anchor);
+            continue;
+        }
+        if (pos < anchor->second)
+            anchor->second += str.size();
+        anchor++;
+    }
+}
+
+/**
+ * Forgets the insertion points found by add_global() and add_local(),
+ * after an edit that may have moved them.
+ */
+void
+ShaderSource::forget_anchors()
+{
+    global_anchor_ = std::string::npos;
+    local_anchors_.clear();
 }
 
 /**
@@ -244,11 +825,28 @@ void
 ShaderSource::add_const(const std::string &name, float f,
                         const std::string &function)
 {
-    std::stringstream ss;
+    add(const_definition(name, f), function);
+}
+
+/**
+ * Formats a float constant definition.
+ *
+ * @param name the name of the constant
+ * @param f the value of the constant
+ *
+ * @return the definition
+ */
+std::string
+ShaderSource::const_definition(const std::string &name, float f)
+{
+    std::string str("const float ");
 
-    ss << "const float " << name << " = " << std::fixed << f << ";" << std::endl;
+    str += name;
+    str += " = ";
+    append_float(str, f);
+    str += ";\n";
 
-    add(ss.str(), function);
+    return str;
 }
 
 /**
@@ -265,21 +863,54 @@ void
 ShaderSource::add_const(const std::string &name, std::vector<float> &array,
                         const std::string &function)
 {
-    std::stringstream ss;
+    add(const_definition(name, array), function);
+}
 
-    ss << "const float " << name << "[" << array.size() << "] = {" << std::fixed;
-    for(std::vector<float>::const_iterator iter = array.begin();
-        iter != array.end();
-        iter++)
-    {
-        ss << *iter;
-        if (iter + 1 != array.end())
-            ss << ", " << std::endl;
-    }
+/**
+ * Adds a float array constant definition.
+ *
+ * This is the same as add_const() with a vector, but for arrays held
+ * elsewhere (e.g. large lookup tables).
+ *
+ * @param name the name of the constant
+ * @param array the value of the constant
+ * @param function if not empty, the function to put the definition in
+ */
+void
+ShaderSource::add_const(const std::string &name, std::span<const float> array,
+                        const std::string &function)
+{
+    add(const_definition(name, array), function);
+}
 
-    ss << "};" << std::endl;
+/**
+ * Formats a float array constant definition.
+ *
+ * @param name the name of the constant
+ * @param array the value of the constant
+ *
+ * @return the definition
+ */
+std::string
+ShaderSource::const_definition(const std::string &name, std::span<const float> array)
+{
+    std::string str;
+
+    /* Room for the longest float literals, and the separators */
+    str.reserve(name.size() + 32 + array.size() * 18);
+    str += "const float ";
+    str += name;
+    str += "[";
+    str += std::to_string(array.size());
+    str += "] = {";
+    for (size_t i = 0; i < array.size(); i++) {
+        append_float(str, array[i]);
+        if (i + 1 != array.size())
+            str += ", \n";
+    }
+    str += "};\n";
 
-    add(ss.str(), function);
+    return str;
 }
 
 /**
@@ -293,12 +924,30 @@ void
 ShaderSource::add_const(const std::string &name, const LibMatrix::vec2 &v,
                         const std::string &function)
 {
-    std::stringstream ss;
+    add(const_definition(name, v), function);
+}
 
-    ss << "const vec2 " << name << " = vec2(" << std::fixed;
-    ss << v.x() << ", " << v.y() << ");" << std::endl;
+/**
+ * Formats a vec2 constant definition.
+ *
+ * @param name the name of the constant
+ * @param v the value of the constant
+ *
+ * @return the definition
+ */
+std::string
+ShaderSource::const_definition(const std::string &name, const LibMatrix::vec2 &v)
+{
+    std::string str("const vec2 ");
 
-    add(ss.str(), function);
+    str += name;
+    str += " = vec2(";
+    append_float(str, v.x());
+    str += ", ";
+    append_float(str, v.y());
+    str += ");\n";
+
+    return str;
 }
 
 /**
@@ -312,12 +961,32 @@ void
 ShaderSource::add_const(const std::string &name, const LibMatrix::vec3 &v,
                         const std::string &function)
 {
-    std::stringstream ss;
-
-    ss << "const vec3 " << name << " = vec3(" << std::fixed;
-    ss << v.x() << ", " << v.y() << ", " << v.z() << ");" << std::endl;
+    add(const_definition(name, v), function);
+}
 
-    add(ss.str(), function);
+/**
+ * Formats a vec3 constant definition.
+ *
+ * @param name the name of the constant
+ * @param v the value of the constant
+ *
+ * @return the definition
+ */
+std::string
+ShaderSource::const_definition(const std::string &name, const LibMatrix::vec3 &v)
+{
+    std::string str("const vec3 ");
+
+    str += name;
+    str += " = vec3(";
+    append_float(str, v.x());
+    str += ", ";
+    append_float(str, v.y());
+    str += ", ";
+    append_float(str, v.z());
+    str += ");\n";
+
+    return str;
 }
 
 /**
@@ -331,12 +1000,34 @@ void
 ShaderSource::add_const(const std::string &name, const LibMatrix::vec4 &v,
                         const std::string &function)
 {
-    std::stringstream ss;
-
-    ss << "const vec4 " << name << " = vec4(" << std::fixed;
-    ss << v.x() << ", " << v.y() << ", " << v.z() << ", " << v.w() << ");" << std::endl;
+    add(const_definition(name, v), function);
+}
 
-    add(ss.str(), function);
+/**
+ * Formats a vec4 constant definition.
+ *
+ * @param name the name of the constant
+ * @param v the value of the constant
+ *
+ * @return the definition
+ */
+std::string
+ShaderSource::const_definition(const std::string &name, const LibMatrix::vec4 &v)
+{
+    std::string str("const vec4 ");
+
+    str += name;
+    str += " = vec4(";
+    append_float(str, v.x());
+    str += ", ";
+    append_float(str, v.y());
+    str += ", ";
+    append_float(str, v.z());
+    str += ", ";
+    append_float(str, v.w());
+    str += ");\n";
+
+    return str;
 }
 
 /**
@@ -350,15 +1041,36 @@ void
 ShaderSource::add_const(const std::string &name, const LibMatrix::mat3 &m,
                         const std::string &function)
 {
-    std::stringstream ss;
+    add(const_definition(name, m), function);
+}
 
-    ss << "const mat3 " << name << " = mat3(" << std::fixed;
-    ss << m[0][0] << ", " << m[1][0] << ", " << m[2][0] << "," << std::endl;
-    ss << m[0][1] << ", " << m[1][1] << ", " << m[2][1] << "," << std::endl;
-    ss << m[0][2] << ", " << m[1][2] << ", " << m[2][2] << std::endl;
-    ss << ");" << std::endl;
+/**
+ * Formats a mat3 constant definition.
+ *
+ * @param name the name of the constant
+ * @param v the value of the constant
+ *
+ * @return the definition
+ */
+std::string
+ShaderSource::const_definition(const std::string &name, const LibMatrix::mat3 &m)
+{
+    std::string str("const mat3 ");
+
+    str += name;
+    str += " = mat3(";
+    /* One column per line */
+    for (unsigned int c = 0; c < 3; c++) {
+        for (unsigned int r = 0; r < 3; r++) {
+            append_float(str, m[r][c]);
+            if (r < 2)
+                str += ", ";
+        }
+        str += c < 2 ? ",\n" : "\n";
+    }
+    str += ");\n";
 
-    add(ss.str(), function);
+    return str;
 }
 
 /**
@@ -373,27 +1085,48 @@ void
 ShaderSource::add_array(const std::string &name, std::vector<float> &array,
                         const std::string &init_function,
                         const std::string &decl_function)
+{
+    add_array(name, std::span<const float>(array), init_function, decl_function);
+}
+
+/**
+ * Adds a float array declaration and initialization.
+ *
+ * This is the same as add_array() with a vector, but for arrays held
+ * elsewhere (e.g. large lookup tables).
+ *
+ * @param name the name of the array
+ * @param array the array values
+ * @param init_function the function to put the initialization in
+ * @param decl_function if not empty, the function to put the declaration in
+ */
+void
+ShaderSource::add_array(const std::string &name, std::span<const float> array,
+                        const std::string &init_function,
+                        const std::string &decl_function)
 {
     if (init_function.empty() || name.empty())
         return;
 
-    std::stringstream ss;
-    ss << "float " << name << "[" << array.size() << "];" << std::endl;
-
-    std::string decl(ss.str());
-
-    ss.clear();
-    ss.str("");
-    ss << std::fixed;
-
-    for(std::vector<float>::const_iterator iter = array.begin();
-        iter != array.end();
-        iter++)
-    {
-        ss << name << "[" << iter - array.begin() << "] = " << *iter << ";" << std::endl;
+    std::string size(std::to_string(array.size()));
+    std::string decl("float " + name + "[" + size + "];\n");
+
+    std::string init;
+    /* Room for the longest float literals and indices, and the rest */
+    init.reserve(array.size() * (name.size() + size.size() + 24));
+    for (size_t i = 0; i < array.size(); i++) {
+        char index[24];
+        char *end = std::to_chars(index, index + sizeof(index), i).ptr;
+
+        init += name;
+        init += "[";
+        init.append(index, end);
+        init += "] = ";
+        append_float(init, array[i]);
+        init += ";\n";
     }
 
-    add(ss.str(), init_function);
+    add(init, init_function);
 
     add(decl, decl_function);
 }
@@ -411,11 +1144,9 @@ ShaderSource::type()
 {
     /* Try to infer the type from the source contents */
     if (type_ == ShaderSource::ShaderTypeUnknown) {
-        std::string source(source_.str());
-
-        if (source.find("gl_FragColor") != std::string::npos)
+        if (source_.find("gl_FragColor") != std::string::npos)
             type_ = ShaderSource::ShaderTypeFragment;
-        else if (source.find("gl_Position") != std::string::npos)
+        else if (source_.find("gl_Position") != std::string::npos)
             type_ = ShaderSource::ShaderTypeVertex;
         else
             Log::debug("Cannot infer shader type from contents. Leaving it Unknown.\n");
@@ -10,7 +10,13 @@
 //     Alexandros Frantzis <alexandros.frantzis@linaro.org>
 //     Jesse Barker <jesse.barker@linaro.org>
 //
+#ifndef SHADER_SOURCE_H_
+#define SHADER_SOURCE_H_
+
+#include <map>
+#include <span>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <vector>
 #include "vec.h"
@@ -29,14 +35,17 @@ public:
     };
 
     ShaderSource(ShaderType type = ShaderTypeUnknown) :
+        global_anchor_(std::string::npos),
         precision_has_been_set_(false), type_(type) {}
     ShaderSource(const std::string &filename, ShaderType type = ShaderTypeUnknown) :
+        global_anchor_(std::string::npos),
         precision_has_been_set_(false), type_(type) { append_file(filename); }
 
     void append(const std::string &str);
     void append_file(const std::string &filename);
 
     void replace(const std::string &remove, const std::string &insert);
+    void replace_all(std::span<const std::pair<std::string, std::string> > replacements);
     void replace_with_file(const std::string &remove, const std::string &filename);
 
     void add(const std::string &str, const std::string &function = "");
@@ -45,6 +54,8 @@ public:
                    const std::string &function = "");
     void add_const(const std::string &name, std::vector<float> &f,
                    const std::string &function = "");
+    void add_const(const std::string &name, std::span<const float> f,
+                   const std::string &function = "");
     void add_const(const std::string &name, const LibMatrix::vec2 &v,
                    const std::string &function = "");
     void add_const(const std::string &name, const LibMatrix::vec3 &v,
@@ -57,6 +68,21 @@ public:
     void add_array(const std::string &name, std::vector<float> &array,
                    const std::string &init_function,
                    const std::string &decl_function = "");
+    void add_array(const std::string &name, std::span<const float> array,
+                   const std::string &init_function,
+                   const std::string &decl_function = "");
+
+    static std::string const_definition(const std::string &name, float f);
+    static std::string const_definition(const std::string &name,
+                                        std::span<const float> array);
+    static std::string const_definition(const std::string &name,
+                                        const LibMatrix::vec2 &v);
+    static std::string const_definition(const std::string &name,
+                                        const LibMatrix::vec3 &v);
+    static std::string const_definition(const std::string &name,
+                                        const LibMatrix::vec4 &v);
+    static std::string const_definition(const std::string &name,
+                                        const LibMatrix::mat3 &m);
 
     ShaderType type();
     std::string str();
@@ -88,16 +114,66 @@ public:
     static const Precision& default_precision(ShaderType type);
 
 private:
+    friend class ShaderTemplate;
+
+    /**
+     * Piece table holding the source text.
+     *
+     * The text is a sequence of pieces, each a range of an append-only
+     * buffer, so an insertion or removal only appends to the buffer and
+     * splits or trims pieces: its cost depends on the number of pieces
+     * (about one per edit), not on the size of the text.  Searches work
+     * on the pieces in place, and the whole text is only put together
+     * (and then cached) when asked for.
+     */
+    class Text
+    {
+    public:
+        Text() : size_(0), flat_valid_(true) {}
+
+        void append(std::string_view str) { insert(size_, str); }
+        void insert(size_t pos, std::string_view str);
+        void assign(std::string &&str);
+
+        size_t find(std::string_view str, size_t pos = 0) const;
+        size_t rfind(std::string_view str) const;
+        size_t size() const { return size_; }
+        const std::string& str() const;
+
+    private:
+        struct Piece
+        {
+            size_t start;
+            size_t length;
+        };
+        size_t split(size_t pos);
+
+        std::string buffer_;
+        std::vector<Piece> pieces_;
+        size_t size_;
+        mutable std::string flat_;
+        mutable bool flat_valid_;
+    };
+
     void add_global(const std::string &str);
     void add_local(const std::string &str, const std::string &function);
+    size_t global_position() const;
+    size_t local_position(const std::string &function) const;
+    void insert_at(size_t pos, const std::string &str);
+    void forget_anchors();
     bool load_file(const std::string& filename, std::string& str);
     void emit_precision(std::stringstream& ss, ShaderSource::PrecisionValue val,
                         const std::string& type_str);
 
-    std::stringstream source_;
+    Text source_;
+    /* Insertion points of add_global() and add_local() (by function) */
+    size_t global_anchor_;
+    std::map<std::string, size_t> local_anchors_;
     Precision precision_;
     bool precision_has_been_set_;
     ShaderType type_;
 
     static std::vector<Precision> default_precision_;
 };
+
+#endif // SHADER_SOURCE_H_
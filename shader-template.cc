@@ -0,0 +1,294 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <algorithm>
+
+#include "shader-template.h"
+#include "log.h"
+
+/**
+ * Makes a template from a shader source.
+ *
+ * @param source the source, as it would be before any additions
+ * @param functions the functions that strings may be added to
+ * @param placeholders the strings that may be set to a value
+ */
+ShaderTemplate::ShaderTemplate(const ShaderSource &source,
+                               const std::vector<std::string> &functions,
+                               const std::vector<std::string> &placeholders) :
+    source_(source.source_.str()),
+    type_(ShaderSource(source).type()),
+    precision_has_been_set_(source.precision_has_been_set_),
+    precision_(source.precision_),
+    functions_(functions),
+    placeholders_(placeholders)
+{
+    /* Where the source is cut, and what goes in the cut */
+    struct Cut
+    {
+        size_t pos;
+        size_t length;
+        int slot;
+    };
+    std::vector<Cut> cuts;
+
+    size_t pos = source.global_position();
+    cuts.push_back(Cut{std::min(pos, source_.size()), 0, 0});
+
+    for (size_t i = 0; i < functions_.size(); i++) {
+        pos = source.local_position(functions_[i]);
+        cuts.push_back(Cut{std::min(pos, source_.size()), 0, static_cast<int>(i + 1)});
+    }
+
+    for (size_t i = 0; i < placeholders_.size(); i++) {
+        const std::string &placeholder(placeholders_[i]);
+        if (placeholder.empty())
+            continue;
+
+        int slot = functions_.size() + 1 + i;
+        for (pos = source_.find(placeholder);
+             pos != std::string::npos;
+             pos = source_.find(placeholder, pos + placeholder.size()))
+        {
+            cuts.push_back(Cut{pos, placeholder.size(), slot});
+        }
+    }
+
+    /* At the same position, insertion points go first, globals first */
+    std::stable_sort(cuts.begin(), cuts.end(), [](const Cut &a, const Cut &b) {
+        return a.pos < b.pos;
+    });
+
+    size_t start = 0;
+    for (std::vector<Cut>::const_iterator cut = cuts.begin();
+         cut != cuts.end();
+         cut++)
+    {
+        /* Placeholders that overlap earlier ones are left alone */
+        if (cut->pos < start && cut->length)
+            continue;
+
+        pos = std::max(cut->pos, start);
+        segments_.push_back(Segment{start, pos - start, cut->slot});
+        start = pos + cut->length;
+    }
+    segments_.push_back(Segment{start, source_.size() - start, -1});
+}
+
+/**
+ * Gets the insertion point of a function.
+ *
+ * @param function the function, or "" for global scope
+ *
+ * @return the slot of the insertion point, or -1 if the function was not
+ *         given to the template
+ */
+int
+ShaderTemplate::slot(const std::string &function) const
+{
+    if (function.empty())
+        return 0;
+
+    std::vector<std::string>::const_iterator found =
+        std::find(functions_.begin(), functions_.end(), function);
+    if (found == functions_.end())
+        return -1;
+
+    return found - functions_.begin() + 1;
+}
+
+/**
+ * Gets the index of a placeholder.
+ *
+ * @param placeholder the placeholder
+ *
+ * @return the index, or -1 if the placeholder was not given to the
+ *         template
+ */
+int
+ShaderTemplate::placeholder(const std::string &placeholder) const
+{
+    std::vector<std::string>::const_iterator found =
+        std::find(placeholders_.begin(), placeholders_.end(), placeholder);
+    if (found == placeholders_.end())
+        return -1;
+
+    return found - placeholders_.begin();
+}
+
+/**
+ * Makes an instance with nothing added, and the placeholders unchanged.
+ *
+ * @param tmpl the template, which must outlive the instance
+ */
+ShaderTemplate::Instance::Instance(const ShaderTemplate &tmpl) :
+    template_(tmpl),
+    added_(tmpl.functions_.size() + 1),
+    values_(tmpl.placeholders_),
+    header_(tmpl.type_)
+{
+    if (tmpl.precision_has_been_set_)
+        header_.precision(tmpl.precision_);
+}
+
+/**
+ * Adds a string (see ShaderSource::add()).
+ *
+ * @param str the string to add
+ * @param function if not empty, the function to add the string into,
+ *                 which must be one given to the template
+ */
+void
+ShaderTemplate::Instance::add(const std::string &str, const std::string &function)
+{
+    int slot = template_.slot(function);
+    if (slot < 0) {
+        Log::error("Function \"%s\" is not in the shader template\n", function.c_str());
+        return;
+    }
+
+    added_[slot].push_back(str);
+}
+
+/**
+ * Adds a float constant definition (see ShaderSource::add_const()).
+ */
+void
+ShaderTemplate::Instance::add_const(const std::string &name, float f,
+                                    const std::string &function)
+{
+    add(ShaderSource::const_definition(name, f), function);
+}
+
+/**
+ * Adds a float array constant definition (see ShaderSource::add_const()).
+ */
+void
+ShaderTemplate::Instance::add_const(const std::string &name, const std::vector<float> &f,
+                                    const std::string &function)
+{
+    add(ShaderSource::const_definition(name, f), function);
+}
+
+/**
+ * Adds a vec2 constant definition (see ShaderSource::add_const()).
+ */
+void
+ShaderTemplate::Instance::add_const(const std::string &name, const LibMatrix::vec2 &v,
+                                    const std::string &function)
+{
+    add(ShaderSource::const_definition(name, v), function);
+}
+
+/**
+ * Adds a vec3 constant definition (see ShaderSource::add_const()).
+ */
+void
+ShaderTemplate::Instance::add_const(const std::string &name, const LibMatrix::vec3 &v,
+                                    const std::string &function)
+{
+    add(ShaderSource::const_definition(name, v), function);
+}
+
+/**
+ * Adds a vec4 constant definition (see ShaderSource::add_const()).
+ */
+void
+ShaderTemplate::Instance::add_const(const std::string &name, const LibMatrix::vec4 &v,
+                                    const std::string &function)
+{
+    add(ShaderSource::const_definition(name, v), function);
+}
+
+/**
+ * Adds a mat3 constant definition (see ShaderSource::add_const()).
+ */
+void
+ShaderTemplate::Instance::add_const(const std::string &name, const LibMatrix::mat3 &m,
+                                    const std::string &function)
+{
+    add(ShaderSource::const_definition(name, m), function);
+}
+
+/**
+ * Sets the value of a placeholder.
+ *
+ * @param placeholder the placeholder, which must be one given to the
+ *                    template
+ * @param value the string to put in its place
+ */
+void
+ShaderTemplate::Instance::set(const std::string &placeholder, const std::string &value)
+{
+    int index = template_.placeholder(placeholder);
+    if (index < 0) {
+        Log::error("Placeholder \"%s\" is not in the shader template\n", placeholder.c_str());
+        return;
+    }
+
+    values_[index] = value;
+}
+
+/**
+ * Sets the precision (see ShaderSource::precision()).
+ *
+ * @param precision the precision to set
+ */
+void
+ShaderTemplate::Instance::precision(const ShaderSource::Precision &precision)
+{
+    header_.precision(precision);
+}
+
+/**
+ * Gets a string containing the complete shader source.
+ *
+ * @return the shader source
+ */
+std::string
+ShaderTemplate::Instance::str() const
+{
+    /* With no text, the ShaderSource gives just the precision statements */
+    std::string header(ShaderSource(header_).str());
+    const std::string &source(template_.source_);
+    size_t num_points = added_.size();
+
+    size_t size = header.size() + source.size();
+    for (size_t i = 0; i < num_points; i++) {
+        for (size_t j = 0; j < added_[i].size(); j++)
+            size += added_[i][j].size();
+    }
+    for (size_t i = 0; i < values_.size(); i++)
+        size += values_[i].size();
+
+    std::string str;
+    str.reserve(size);
+    str += header;
+
+    for (std::vector<Segment>::const_iterator segment = template_.segments_.begin();
+         segment != template_.segments_.end();
+         segment++)
+    {
+        str.append(source, segment->start, segment->length);
+        if (segment->slot < 0)
+            continue;
+
+        size_t slot = segment->slot;
+        if (slot < num_points) {
+            /* Later additions go first, as with ShaderSource */
+            const std::vector<std::string> &added(added_[slot]);
+            for (size_t j = added.size(); j-- > 0; )
+                str += added[j];
+        }
+        else {
+            str += values_[slot - num_points];
+        }
+    }
+
+    return str;
+}
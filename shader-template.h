@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef SHADER_TEMPLATE_H_
+#define SHADER_TEMPLATE_H_
+
+#include <string>
+#include <vector>
+#include "shader-source.h"
+
+/**
+ * A shader source parsed once, for making many variants of it.
+ *
+ * The places a ShaderSource would add strings (at global scope, and at
+ * the top of each of a given set of functions) and the occurrences of a
+ * given set of placeholder strings are found when the template is made,
+ * which splits the source into segments.  An Instance collects the
+ * strings to add and the placeholder values for one variant, and str()
+ * just joins the segments up with them, so the cost of a variant depends
+ * on what is added to it rather than on the size of the shader:
+ *
+ *     ShaderTemplate tmpl(ShaderSource("light.frag"), {"main"}, {"$LIGHTS$"});
+ *     ShaderTemplate::Instance variant(tmpl.instantiate());
+ *     variant.add_const("Shininess", 32.0f);
+ *     variant.add_const("Ambient", ambient, "main");
+ *     variant.set("$LIGHTS$", "4");
+ *     std::string source(variant.str());
+ *
+ * The result is what the same calls on a copy of the ShaderSource would
+ * give (with replace() for set()), as long as added strings end lines
+ * and neither they nor the placeholder values change where a
+ * ShaderSource would add strings (e.g. by adding precision statements).
+ */
+class ShaderTemplate
+{
+public:
+    ShaderTemplate(const ShaderSource &source,
+                   const std::vector<std::string> &functions = std::vector<std::string>(),
+                   const std::vector<std::string> &placeholders = std::vector<std::string>());
+
+    class Instance
+    {
+    public:
+        void add(const std::string &str, const std::string &function = "");
+
+        void add_const(const std::string &name, float f,
+                       const std::string &function = "");
+        void add_const(const std::string &name, const std::vector<float> &f,
+                       const std::string &function = "");
+        void add_const(const std::string &name, const LibMatrix::vec2 &v,
+                       const std::string &function = "");
+        void add_const(const std::string &name, const LibMatrix::vec3 &v,
+                       const std::string &function = "");
+        void add_const(const std::string &name, const LibMatrix::vec4 &v,
+                       const std::string &function = "");
+        void add_const(const std::string &name, const LibMatrix::mat3 &m,
+                       const std::string &function = "");
+
+        void set(const std::string &placeholder, const std::string &value);
+        void precision(const ShaderSource::Precision &precision);
+
+        std::string str() const;
+
+    private:
+        friend class ShaderTemplate;
+        Instance(const ShaderTemplate &tmpl);
+
+        const ShaderTemplate &template_;
+        /* The strings added at each insertion point, in the order added */
+        std::vector<std::vector<std::string> > added_;
+        /* The value of each placeholder */
+        std::vector<std::string> values_;
+        ShaderSource header_;
+    };
+
+    Instance instantiate() const { return Instance(*this); }
+
+private:
+    /*
+     * A piece of the source, followed by an insertion point or a
+     * placeholder: slots 0 to functions_.size() are the insertion points
+     * (global scope first), and the placeholders follow.  The last
+     * segment has no slot (-1).
+     */
+    struct Segment
+    {
+        size_t start;
+        size_t length;
+        int slot;
+    };
+
+    int slot(const std::string &function) const;
+    int placeholder(const std::string &placeholder) const;
+
+    std::string source_;
+    ShaderSource::ShaderType type_;
+    bool precision_has_been_set_;
+    ShaderSource::Precision precision_;
+    std::vector<std::string> functions_;
+    std::vector<std::string> placeholders_;
+    std::vector<Segment> segments_;
+};
+
+#endif // SHADER_TEMPLATE_H_
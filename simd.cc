@@ -0,0 +1,1121 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <atomic>
+#include <math.h>
+#include "simd.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define LIBMATRIX_SIMD_X86 1
+// Some GCC releases warn about the deliberately undefined pass-through
+// operands inside their own AVX-512 intrinsics (GCC PR 105593).
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+// Each x86 variant is compiled for its own instruction set via function
+// attributes, so the library itself can be built for a baseline ISA.
+#define LIBMATRIX_TARGET_SSE2 __attribute__((target("sse2")))
+#define LIBMATRIX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define LIBMATRIX_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#elif defined(__ARM_NEON)
+#define LIBMATRIX_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace LibMatrix
+{
+namespace Simd
+{
+namespace
+{
+
+//
+// Portable implementations.  These are forced inline into each of the
+// per-ISA entry points below so that the compiler generates code for that
+// instruction set, and double as the scalar fallback.
+//
+
+template<typename T>
+[[gnu::always_inline]] inline void
+multiply4(T* dst, const T* lhs, const T* rhs)
+{
+    T a[16];
+    for (int i = 0; i < 16; i++)
+    {
+        a[i] = lhs[i];
+    }
+    for (int col = 0; col < 16; col += 4)
+    {
+        T b0(rhs[col]);
+        T b1(rhs[col + 1]);
+        T b2(rhs[col + 2]);
+        T b3(rhs[col + 3]);
+        for (int row = 0; row < 4; row++)
+        {
+            dst[col + row] = (a[row] * b0) + (a[row + 4] * b1) + (a[row + 8] * b2) + (a[row + 12] * b3);
+        }
+    }
+}
+
+// Inverse by cofactor expansion, sharing the 2x2 sub-determinants of the
+// upper (s) and lower (c) halves between all of the 3x3 minors.  The
+// inverse of the transpose is the transpose of the inverse, so the same
+// expressions work whether the storage is read by rows or by columns.
+template<typename T>
+[[gnu::always_inline]] inline bool
+inverse4(T* dst, const T* m)
+{
+    T s0((m[0] * m[5]) - (m[4] * m[1]));
+    T s1((m[0] * m[6]) - (m[4] * m[2]));
+    T s2((m[0] * m[7]) - (m[4] * m[3]));
+    T s3((m[1] * m[6]) - (m[5] * m[2]));
+    T s4((m[1] * m[7]) - (m[5] * m[3]));
+    T s5((m[2] * m[7]) - (m[6] * m[3]));
+    T c5((m[10] * m[15]) - (m[14] * m[11]));
+    T c4((m[9] * m[15]) - (m[13] * m[11]));
+    T c3((m[9] * m[14]) - (m[13] * m[10]));
+    T c2((m[8] * m[15]) - (m[12] * m[11]));
+    T c1((m[8] * m[14]) - (m[12] * m[10]));
+    T c0((m[8] * m[13]) - (m[12] * m[9]));
+    T d((s0 * c5) - (s1 * c4) + (s2 * c3) + (s3 * c2) - (s4 * c1) + (s5 * c0));
+    if (d == static_cast<T>(0))
+    {
+        return false;
+    }
+    T id(static_cast<T>(1) / d);
+    T r[16];
+    r[0] = ((m[5] * c5) - (m[6] * c4) + (m[7] * c3)) * id;
+    r[1] = (-(m[1] * c5) + (m[2] * c4) - (m[3] * c3)) * id;
+    r[2] = ((m[13] * s5) - (m[14] * s4) + (m[15] * s3)) * id;
+    r[3] = (-(m[9] * s5) + (m[10] * s4) - (m[11] * s3)) * id;
+    r[4] = (-(m[4] * c5) + (m[6] * c2) - (m[7] * c1)) * id;
+    r[5] = ((m[0] * c5) - (m[2] * c2) + (m[3] * c1)) * id;
+    r[6] = (-(m[12] * s5) + (m[14] * s2) - (m[15] * s1)) * id;
+    r[7] = ((m[8] * s5) - (m[10] * s2) + (m[11] * s1)) * id;
+    r[8] = ((m[4] * c4) - (m[5] * c2) + (m[7] * c0)) * id;
+    r[9] = (-(m[0] * c4) + (m[1] * c2) - (m[3] * c0)) * id;
+    r[10] = ((m[12] * s4) - (m[13] * s2) + (m[15] * s0)) * id;
+    r[11] = (-(m[8] * s4) + (m[9] * s2) - (m[11] * s0)) * id;
+    r[12] = (-(m[4] * c3) + (m[5] * c1) - (m[6] * c0)) * id;
+    r[13] = ((m[0] * c3) - (m[1] * c1) + (m[2] * c0)) * id;
+    r[14] = (-(m[12] * s3) + (m[13] * s1) - (m[14] * s0)) * id;
+    r[15] = ((m[8] * s3) - (m[9] * s1) + (m[10] * s0)) * id;
+    for (int i = 0; i < 16; i++)
+    {
+        dst[i] = r[i];
+    }
+    return true;
+}
+
+[[gnu::always_inline]] inline void
+transform4(float* dst, const float* m, const float* src, size_t count)
+{
+    for (size_t i = 0; i < count; i++, src += 4, dst += 4)
+    {
+        float x(src[0]);
+        float y(src[1]);
+        float z(src[2]);
+        float w(src[3]);
+        dst[0] = (m[0] * x) + (m[4] * y) + (m[8] * z) + (m[12] * w);
+        dst[1] = (m[1] * x) + (m[5] * y) + (m[9] * z) + (m[13] * w);
+        dst[2] = (m[2] * x) + (m[6] * y) + (m[10] * z) + (m[14] * w);
+        dst[3] = (m[3] * x) + (m[7] * y) + (m[11] * z) + (m[15] * w);
+    }
+}
+
+[[gnu::always_inline]] inline void
+transform3(float* dst, const float* m, const float* src, size_t count, float w)
+{
+    float tx(m[12] * w);
+    float ty(m[13] * w);
+    float tz(m[14] * w);
+    for (size_t i = 0; i < count; i++, src += 3, dst += 3)
+    {
+        float x(src[0]);
+        float y(src[1]);
+        float z(src[2]);
+        dst[0] = (m[0] * x) + (m[4] * y) + (m[8] * z) + tx;
+        dst[1] = (m[1] * x) + (m[5] * y) + (m[9] * z) + ty;
+        dst[2] = (m[2] * x) + (m[6] * y) + (m[10] * z) + tz;
+    }
+}
+
+[[gnu::always_inline]] inline void
+dot3(float* dst, const float* a, const float* b, size_t count)
+{
+    for (size_t i = 0; i < count; i++, a += 3, b += 3)
+    {
+        dst[i] = (a[0] * b[0]) + (a[1] * b[1]) + (a[2] * b[2]);
+    }
+}
+
+[[gnu::always_inline]] inline void
+cross3(float* dst, const float* a, const float* b, size_t count)
+{
+    for (size_t i = 0; i < count; i++, a += 3, b += 3, dst += 3)
+    {
+        float ax(a[0]);
+        float ay(a[1]);
+        float az(a[2]);
+        float bx(b[0]);
+        float by(b[1]);
+        float bz(b[2]);
+        dst[0] = (ay * bz) - (az * by);
+        dst[1] = (az * bx) - (ax * bz);
+        dst[2] = (ax * by) - (ay * bx);
+    }
+}
+
+[[gnu::always_inline]] inline void
+normalize3(float* dst, const float* src, size_t count)
+{
+    for (size_t i = 0; i < count; i++, src += 3, dst += 3)
+    {
+        float x(src[0]);
+        float y(src[1]);
+        float z(src[2]);
+        float l(sqrtf((x * x) + (y * y) + (z * z)));
+        float s(l != 0 ? 1 / l : 1);
+        dst[0] = x * s;
+        dst[1] = y * s;
+        dst[2] = z * s;
+    }
+}
+
+[[gnu::always_inline]] inline void
+multiplyq(float* dst, const float* a, const float* b, size_t count)
+{
+    for (size_t i = 0; i < count; i++, a += 4, b += 4, dst += 4)
+    {
+        float ax(a[0]);
+        float ay(a[1]);
+        float az(a[2]);
+        float aw(a[3]);
+        float bx(b[0]);
+        float by(b[1]);
+        float bz(b[2]);
+        float bw(b[3]);
+        dst[0] = (aw * bx) + (ax * bw) + (ay * bz) - (az * by);
+        dst[1] = (aw * by) - (ax * bz) + (ay * bw) + (az * bx);
+        dst[2] = (aw * bz) + (ax * by) - (ay * bx) + (az * bw);
+        dst[3] = (aw * bw) - (ax * bx) - (ay * by) - (az * bz);
+    }
+}
+
+[[gnu::always_inline]] inline void
+normalizeq(float* dst, const float* src, size_t count)
+{
+    for (size_t i = 0; i < count; i++, src += 4, dst += 4)
+    {
+        float x(src[0]);
+        float y(src[1]);
+        float z(src[2]);
+        float w(src[3]);
+        float l(sqrtf((x * x) + (y * y) + (z * z) + (w * w)));
+        float s(l != 0 ? 1 / l : 1);
+        dst[0] = x * s;
+        dst[1] = y * s;
+        dst[2] = z * s;
+        dst[3] = w * s;
+    }
+}
+
+// The structure-of-arrays kernels work through the lanes in chunks of
+// soa_lane_multiple, and build each chunk of results in locals before
+// storing it, so that the loops vectorize even though dst may alias a
+// source.
+constexpr size_t soa_chunk(soa_lane_multiple);
+
+[[gnu::always_inline]] inline void
+add_soa(float* dst, const float* a, const float* b, size_t count)
+{
+    for (size_t i = 0; i < count; i += soa_chunk)
+    {
+        float r[soa_chunk];
+        for (size_t l = 0; l < soa_chunk; l++)
+        {
+            r[l] = a[i + l] + b[i + l];
+        }
+        for (size_t l = 0; l < soa_chunk; l++)
+        {
+            dst[i + l] = r[l];
+        }
+    }
+}
+
+[[gnu::always_inline]] inline void
+scale_soa(float* dst, const float* src, float s, size_t count)
+{
+    for (size_t i = 0; i < count; i += soa_chunk)
+    {
+        float r[soa_chunk];
+        for (size_t l = 0; l < soa_chunk; l++)
+        {
+            r[l] = src[i + l] * s;
+        }
+        for (size_t l = 0; l < soa_chunk; l++)
+        {
+            dst[i + l] = r[l];
+        }
+    }
+}
+
+[[gnu::always_inline]] inline void
+cross_soa(float* dst, const float* a, const float* b, size_t blocks, size_t lanes)
+{
+    const size_t y(lanes);
+    const size_t z(lanes * 2);
+    for (size_t blk = 0; blk < blocks; blk++, a += lanes * 3, b += lanes * 3, dst += lanes * 3)
+    {
+        for (size_t i = 0; i < lanes; i += soa_chunk)
+        {
+            const float* ax(a + i);
+            const float* bx(b + i);
+            float r[3][soa_chunk];
+            for (size_t l = 0; l < soa_chunk; l++)
+            {
+                r[0][l] = (ax[y + l] * bx[z + l]) - (ax[z + l] * bx[y + l]);
+                r[1][l] = (ax[z + l] * bx[l]) - (ax[l] * bx[z + l]);
+                r[2][l] = (ax[l] * bx[y + l]) - (ax[y + l] * bx[l]);
+            }
+            for (size_t c = 0; c < 3; c++)
+            {
+                for (size_t l = 0; l < soa_chunk; l++)
+                {
+                    dst[(c * lanes) + i + l] = r[c][l];
+                }
+            }
+        }
+    }
+}
+
+// Sum of squares (or of products, with b) over the components of one chunk
+// of lanes.
+[[gnu::always_inline]] inline void
+sum_soa(float* sum, const float* a, const float* b, size_t components, size_t lanes)
+{
+    for (size_t l = 0; l < soa_chunk; l++)
+    {
+        sum[l] = 0;
+    }
+    for (size_t c = 0; c < components; c++, a += lanes, b += lanes)
+    {
+        for (size_t l = 0; l < soa_chunk; l++)
+        {
+            sum[l] += a[l] * b[l];
+        }
+    }
+}
+
+[[gnu::always_inline]] inline void
+normalize_soa(float* dst, const float* src, size_t blocks, size_t components, size_t lanes)
+{
+    const size_t size(components * lanes);
+    for (size_t blk = 0; blk < blocks; blk++, src += size, dst += size)
+    {
+        for (size_t i = 0; i < lanes; i += soa_chunk)
+        {
+            float s[soa_chunk];
+            sum_soa(s, src + i, src + i, components, lanes);
+            for (size_t l = 0; l < soa_chunk; l++)
+            {
+                s[l] = s[l] > 0 ? 1 / sqrtf(s[l]) : 1;
+            }
+            for (size_t c = 0; c < size; c += lanes)
+            {
+                float r[soa_chunk];
+                for (size_t l = 0; l < soa_chunk; l++)
+                {
+                    r[l] = src[c + i + l] * s[l];
+                }
+                for (size_t l = 0; l < soa_chunk; l++)
+                {
+                    dst[c + i + l] = r[l];
+                }
+            }
+        }
+    }
+}
+
+[[gnu::always_inline]] inline void
+dot_soa(float* dst, const float* a, const float* b, size_t blocks, size_t components,
+        size_t lanes)
+{
+    const size_t size(components * lanes);
+    for (size_t blk = 0; blk < blocks; blk++, a += size, b += size)
+    {
+        for (size_t i = 0; i < lanes; i += soa_chunk, dst += soa_chunk)
+        {
+            float r[soa_chunk];
+            sum_soa(r, a + i, b + i, components, lanes);
+            for (size_t l = 0; l < soa_chunk; l++)
+            {
+                dst[l] = r[l];
+            }
+        }
+    }
+}
+
+[[gnu::always_inline]] inline void
+length_soa(float* dst, const float* src, size_t blocks, size_t components, size_t lanes)
+{
+    const size_t size(components * lanes);
+    for (size_t blk = 0; blk < blocks; blk++, src += size)
+    {
+        for (size_t i = 0; i < lanes; i += soa_chunk, dst += soa_chunk)
+        {
+            float r[soa_chunk];
+            sum_soa(r, src + i, src + i, components, lanes);
+            for (size_t l = 0; l < soa_chunk; l++)
+            {
+                dst[l] = sqrtf(r[l]);
+            }
+        }
+    }
+}
+
+// Stamp out the entry points that are built from the portable code above
+// for a given instruction set.
+#define LIBMATRIX_PORTABLE_KERNELS(suffix, target) \
+    [[maybe_unused]] target void mat4_multiply_f_##suffix(float* dst, const float* lhs, const float* rhs) \
+    { multiply4(dst, lhs, rhs); } \
+    [[maybe_unused]] target void mat4_multiply_d_##suffix(double* dst, const double* lhs, const double* rhs) \
+    { multiply4(dst, lhs, rhs); } \
+    [[maybe_unused]] target bool mat4_inverse_f_##suffix(float* dst, const float* src) \
+    { return inverse4(dst, src); } \
+    [[maybe_unused]] target bool mat4_inverse_d_##suffix(double* dst, const double* src) \
+    { return inverse4(dst, src); } \
+    [[maybe_unused]] target void mat4_transform4_##suffix(float* dst, const float* m, const float* src, size_t count) \
+    { transform4(dst, m, src, count); } \
+    [[maybe_unused]] target void mat4_transform3_##suffix(float* dst, const float* m, const float* src, size_t count, float w) \
+    { transform3(dst, m, src, count, w); } \
+    [[maybe_unused]] target void vec3_dot_##suffix(float* dst, const float* a, const float* b, size_t count) \
+    { dot3(dst, a, b, count); } \
+    [[maybe_unused]] target void vec3_cross_##suffix(float* dst, const float* a, const float* b, size_t count) \
+    { cross3(dst, a, b, count); } \
+    [[maybe_unused]] target void vec3_normalize_##suffix(float* dst, const float* src, size_t count) \
+    { normalize3(dst, src, count); } \
+    [[maybe_unused]] target void quat_multiply_##suffix(float* dst, const float* a, const float* b, size_t count) \
+    { multiplyq(dst, a, b, count); } \
+    [[maybe_unused]] target void quat_normalize_##suffix(float* dst, const float* src, size_t count) \
+    { normalizeq(dst, src, count); } \
+    [[maybe_unused]] target void soa_add_##suffix(float* dst, const float* a, const float* b, size_t count) \
+    { add_soa(dst, a, b, count); } \
+    [[maybe_unused]] target void soa_scale_##suffix(float* dst, const float* src, float s, size_t count) \
+    { scale_soa(dst, src, s, count); } \
+    [[maybe_unused]] target void soa_cross_##suffix(float* dst, const float* a, const float* b, size_t blocks, size_t lanes) \
+    { cross_soa(dst, a, b, blocks, lanes); } \
+    [[maybe_unused]] target void soa_normalize_##suffix(float* dst, const float* src, size_t blocks, size_t components, size_t lanes) \
+    { normalize_soa(dst, src, blocks, components, lanes); } \
+    [[maybe_unused]] target void soa_dot_##suffix(float* dst, const float* a, const float* b, size_t blocks, size_t components, size_t lanes) \
+    { dot_soa(dst, a, b, blocks, components, lanes); } \
+    [[maybe_unused]] target void soa_length_##suffix(float* dst, const float* src, size_t blocks, size_t components, size_t lanes) \
+    { length_soa(dst, src, blocks, components, lanes); }
+
+LIBMATRIX_PORTABLE_KERNELS(scalar, )
+
+constexpr Kernels scalar_kernels = {
+    .id = isa::scalar,
+    .name = "scalar",
+    .mat4_multiply_f = mat4_multiply_f_scalar,
+    .mat4_multiply_d = mat4_multiply_d_scalar,
+    .mat4_inverse_f = mat4_inverse_f_scalar,
+    .mat4_inverse_d = mat4_inverse_d_scalar,
+    .mat4_transform4 = mat4_transform4_scalar,
+    .mat4_transform3 = mat4_transform3_scalar,
+    .vec3_dot = vec3_dot_scalar,
+    .vec3_cross = vec3_cross_scalar,
+    .vec3_normalize = vec3_normalize_scalar,
+    .quat_multiply = quat_multiply_scalar,
+    .quat_normalize = quat_normalize_scalar,
+    .soa_add = soa_add_scalar,
+    .soa_scale = soa_scale_scalar,
+    .soa_cross = soa_cross_scalar,
+    .soa_normalize = soa_normalize_scalar,
+    .soa_dot = soa_dot_scalar,
+    .soa_length = soa_length_scalar,
+};
+
+#if defined(LIBMATRIX_SIMD_X86)
+
+LIBMATRIX_PORTABLE_KERNELS(sse2, LIBMATRIX_TARGET_SSE2)
+LIBMATRIX_PORTABLE_KERNELS(avx2, LIBMATRIX_TARGET_AVX2)
+LIBMATRIX_PORTABLE_KERNELS(avx512, LIBMATRIX_TARGET_AVX512)
+
+//
+// SSE2
+//
+LIBMATRIX_TARGET_SSE2 void
+mat4_transform4_sse2_hand(float* dst, const float* m, const float* src, size_t count)
+{
+    __m128 c0 = _mm_loadu_ps(m + 0);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+    for (size_t i = 0; i < count; i++, src += 4, dst += 4)
+    {
+        __m128 v = _mm_loadu_ps(src);
+        __m128 r = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+        r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+        r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+        _mm_storeu_ps(dst, r);
+    }
+}
+
+LIBMATRIX_TARGET_SSE2 void
+mat4_multiply_f_sse2_hand(float* dst, const float* lhs, const float* rhs)
+{
+    mat4_transform4_sse2_hand(dst, lhs, rhs, 4);
+}
+
+LIBMATRIX_TARGET_SSE2 void
+mat4_multiply_d_sse2_hand(double* dst, const double* lhs, const double* rhs)
+{
+    // Each column occupies a lo (rows 0-1) and hi (rows 2-3) register.
+    __m128d a0l = _mm_loadu_pd(lhs + 0);
+    __m128d a0h = _mm_loadu_pd(lhs + 2);
+    __m128d a1l = _mm_loadu_pd(lhs + 4);
+    __m128d a1h = _mm_loadu_pd(lhs + 6);
+    __m128d a2l = _mm_loadu_pd(lhs + 8);
+    __m128d a2h = _mm_loadu_pd(lhs + 10);
+    __m128d a3l = _mm_loadu_pd(lhs + 12);
+    __m128d a3h = _mm_loadu_pd(lhs + 14);
+    for (int col = 0; col < 16; col += 4)
+    {
+        __m128d b0 = _mm_set1_pd(rhs[col]);
+        __m128d b1 = _mm_set1_pd(rhs[col + 1]);
+        __m128d b2 = _mm_set1_pd(rhs[col + 2]);
+        __m128d b3 = _mm_set1_pd(rhs[col + 3]);
+        __m128d rl = _mm_mul_pd(a0l, b0);
+        __m128d rh = _mm_mul_pd(a0h, b0);
+        rl = _mm_add_pd(rl, _mm_mul_pd(a1l, b1));
+        rh = _mm_add_pd(rh, _mm_mul_pd(a1h, b1));
+        rl = _mm_add_pd(rl, _mm_mul_pd(a2l, b2));
+        rh = _mm_add_pd(rh, _mm_mul_pd(a2h, b2));
+        rl = _mm_add_pd(rl, _mm_mul_pd(a3l, b3));
+        rh = _mm_add_pd(rh, _mm_mul_pd(a3h, b3));
+        _mm_storeu_pd(dst + col, rl);
+        _mm_storeu_pd(dst + col + 2, rh);
+    }
+}
+
+LIBMATRIX_TARGET_SSE2 void
+mat4_transform3_sse2_hand(float* dst, const float* m, const float* src, size_t count, float w)
+{
+    __m128 c0 = _mm_loadu_ps(m + 0);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 t = _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(w));
+    for (size_t i = 0; i < count; i++, src += 3, dst += 3)
+    {
+        __m128 r = _mm_add_ps(t, _mm_mul_ps(c0, _mm_set1_ps(src[0])));
+        r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(src[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(src[2])));
+        // Only write back x, y and z so that packed arrays are not overrun.
+        _mm_storel_pi(reinterpret_cast<__m64*>(dst), r);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(r, r));
+    }
+}
+
+// The product is w(a) * b plus x(a), y(a) and z(a) times shuffles of b
+// with some lanes negated.
+LIBMATRIX_TARGET_SSE2 void
+quat_multiply_sse2_hand(float* dst, const float* a, const float* b, size_t count)
+{
+    const __m128 sx = _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    const __m128 sy = _mm_set_ps(-0.0f, -0.0f, 0.0f, 0.0f);
+    const __m128 sz = _mm_set_ps(-0.0f, 0.0f, 0.0f, -0.0f);
+    for (size_t i = 0; i < count; i++, a += 4, b += 4, dst += 4)
+    {
+        __m128 va = _mm_loadu_ps(a);
+        __m128 vb = _mm_loadu_ps(b);
+        __m128 r = _mm_mul_ps(_mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 3, 3, 3)), vb);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(va, va, _MM_SHUFFLE(0, 0, 0, 0)),
+                                     _mm_xor_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(0, 1, 2, 3)), sx)));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(va, va, _MM_SHUFFLE(1, 1, 1, 1)),
+                                     _mm_xor_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(1, 0, 3, 2)), sy)));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(va, va, _MM_SHUFFLE(2, 2, 2, 2)),
+                                     _mm_xor_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1)), sz)));
+        _mm_storeu_ps(dst, r);
+    }
+}
+
+LIBMATRIX_TARGET_SSE2 void
+quat_normalize_sse2_hand(float* dst, const float* src, size_t count)
+{
+    for (size_t i = 0; i < count; i++, src += 4, dst += 4)
+    {
+        __m128 v = _mm_loadu_ps(src);
+        // Sum the squares into every lane.
+        __m128 d = _mm_mul_ps(v, v);
+        d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)));
+        d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 0, 3, 2)));
+        __m128 l = _mm_sqrt_ps(d);
+        __m128 zero = _mm_cmpeq_ps(l, _mm_setzero_ps());
+        __m128 r = _mm_div_ps(v, _mm_or_ps(_mm_andnot_ps(zero, l), _mm_and_ps(zero, _mm_set1_ps(1.0f))));
+        _mm_storeu_ps(dst, r);
+    }
+}
+
+// The vector square root is what the portable versions are missing: sqrtf
+// stays scalar because it may set errno.
+LIBMATRIX_TARGET_SSE2 void
+soa_normalize_sse2_hand(float* dst, const float* src, size_t blocks, size_t components,
+                        size_t lanes)
+{
+    const size_t size(components * lanes);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (size_t blk = 0; blk < blocks; blk++, src += size, dst += size)
+    {
+        for (size_t i = 0; i < lanes; i += 4)
+        {
+            __m128 s = _mm_setzero_ps();
+            for (size_t c = i; c < size; c += lanes)
+            {
+                __m128 v = _mm_loadu_ps(src + c);
+                s = _mm_add_ps(s, _mm_mul_ps(v, v));
+            }
+            __m128 nonzero = _mm_cmpgt_ps(s, _mm_setzero_ps());
+            s = _mm_div_ps(one, _mm_sqrt_ps(s));
+            s = _mm_or_ps(_mm_and_ps(nonzero, s), _mm_andnot_ps(nonzero, one));
+            for (size_t c = i; c < size; c += lanes)
+            {
+                _mm_storeu_ps(dst + c, _mm_mul_ps(_mm_loadu_ps(src + c), s));
+            }
+        }
+    }
+}
+
+LIBMATRIX_TARGET_SSE2 void
+soa_length_sse2_hand(float* dst, const float* src, size_t blocks, size_t components,
+                     size_t lanes)
+{
+    const size_t size(components * lanes);
+    for (size_t blk = 0; blk < blocks; blk++, src += size)
+    {
+        for (size_t i = 0; i < lanes; i += 4, dst += 4)
+        {
+            __m128 s = _mm_setzero_ps();
+            for (size_t c = i; c < size; c += lanes)
+            {
+                __m128 v = _mm_loadu_ps(src + c);
+                s = _mm_add_ps(s, _mm_mul_ps(v, v));
+            }
+            _mm_storeu_ps(dst, _mm_sqrt_ps(s));
+        }
+    }
+}
+
+constexpr Kernels sse2_kernels = {
+    .id = isa::sse2,
+    .name = "sse2",
+    .mat4_multiply_f = mat4_multiply_f_sse2_hand,
+    .mat4_multiply_d = mat4_multiply_d_sse2_hand,
+    .mat4_inverse_f = mat4_inverse_f_sse2,
+    .mat4_inverse_d = mat4_inverse_d_sse2,
+    .mat4_transform4 = mat4_transform4_sse2_hand,
+    .mat4_transform3 = mat4_transform3_sse2_hand,
+    .vec3_dot = vec3_dot_sse2,
+    .vec3_cross = vec3_cross_sse2,
+    .vec3_normalize = vec3_normalize_sse2,
+    .quat_multiply = quat_multiply_sse2_hand,
+    .quat_normalize = quat_normalize_sse2_hand,
+    .soa_add = soa_add_sse2,
+    .soa_scale = soa_scale_sse2,
+    .soa_cross = soa_cross_sse2,
+    .soa_normalize = soa_normalize_sse2_hand,
+    .soa_dot = soa_dot_sse2,
+    .soa_length = soa_length_sse2_hand,
+};
+
+//
+// AVX2 + FMA
+//
+LIBMATRIX_TARGET_AVX2 void
+mat4_transform4_avx2_hand(float* dst, const float* m, const float* src, size_t count)
+{
+    // Duplicate each matrix column into both 128-bit halves so that two
+    // vectors are transformed per iteration.
+    __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 0));
+    __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+    __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+    __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2, src += 8, dst += 8)
+    {
+        __m256 v = _mm256_loadu_ps(src);
+        __m256 r = _mm256_mul_ps(c0, _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm256_fmadd_ps(c1, _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+        r = _mm256_fmadd_ps(c2, _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+        r = _mm256_fmadd_ps(c3, _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+        _mm256_storeu_ps(dst, r);
+    }
+    if (i < count)
+    {
+        __m128 v = _mm_loadu_ps(src);
+        __m128 r = _mm_mul_ps(_mm256_castps256_ps128(c0), _mm_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm_fmadd_ps(_mm256_castps256_ps128(c1), _mm_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+        r = _mm_fmadd_ps(_mm256_castps256_ps128(c2), _mm_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+        r = _mm_fmadd_ps(_mm256_castps256_ps128(c3), _mm_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+        _mm_storeu_ps(dst, r);
+    }
+}
+
+LIBMATRIX_TARGET_AVX2 void
+mat4_multiply_f_avx2_hand(float* dst, const float* lhs, const float* rhs)
+{
+    mat4_transform4_avx2_hand(dst, lhs, rhs, 4);
+}
+
+LIBMATRIX_TARGET_AVX2 void
+mat4_multiply_d_avx2_hand(double* dst, const double* lhs, const double* rhs)
+{
+    __m256d a0 = _mm256_loadu_pd(lhs + 0);
+    __m256d a1 = _mm256_loadu_pd(lhs + 4);
+    __m256d a2 = _mm256_loadu_pd(lhs + 8);
+    __m256d a3 = _mm256_loadu_pd(lhs + 12);
+    for (int col = 0; col < 16; col += 4)
+    {
+        __m256d r = _mm256_mul_pd(a0, _mm256_broadcast_sd(rhs + col));
+        r = _mm256_fmadd_pd(a1, _mm256_broadcast_sd(rhs + col + 1), r);
+        r = _mm256_fmadd_pd(a2, _mm256_broadcast_sd(rhs + col + 2), r);
+        r = _mm256_fmadd_pd(a3, _mm256_broadcast_sd(rhs + col + 3), r);
+        _mm256_storeu_pd(dst + col, r);
+    }
+}
+
+LIBMATRIX_TARGET_AVX2 void
+mat4_transform3_avx2_hand(float* dst, const float* m, const float* src, size_t count, float w)
+{
+    __m128 c0 = _mm_loadu_ps(m + 0);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 t = _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(w));
+    for (size_t i = 0; i < count; i++, src += 3, dst += 3)
+    {
+        __m128 r = _mm_fmadd_ps(c0, _mm_broadcast_ss(src), t);
+        r = _mm_fmadd_ps(c1, _mm_broadcast_ss(src + 1), r);
+        r = _mm_fmadd_ps(c2, _mm_broadcast_ss(src + 2), r);
+        _mm_storel_pi(reinterpret_cast<__m64*>(dst), r);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(r, r));
+    }
+}
+
+LIBMATRIX_TARGET_AVX2 void
+quat_multiply_avx2_hand(float* dst, const float* a, const float* b, size_t count)
+{
+    const __m128 sx = _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    const __m128 sy = _mm_set_ps(-0.0f, -0.0f, 0.0f, 0.0f);
+    const __m128 sz = _mm_set_ps(-0.0f, 0.0f, 0.0f, -0.0f);
+    for (size_t i = 0; i < count; i++, a += 4, b += 4, dst += 4)
+    {
+        __m128 vb = _mm_loadu_ps(b);
+        __m128 r = _mm_mul_ps(_mm_broadcast_ss(a + 3), vb);
+        r = _mm_fmadd_ps(_mm_broadcast_ss(a), _mm_xor_ps(_mm_permute_ps(vb, _MM_SHUFFLE(0, 1, 2, 3)), sx), r);
+        r = _mm_fmadd_ps(_mm_broadcast_ss(a + 1), _mm_xor_ps(_mm_permute_ps(vb, _MM_SHUFFLE(1, 0, 3, 2)), sy), r);
+        r = _mm_fmadd_ps(_mm_broadcast_ss(a + 2), _mm_xor_ps(_mm_permute_ps(vb, _MM_SHUFFLE(2, 3, 0, 1)), sz), r);
+        _mm_storeu_ps(dst, r);
+    }
+}
+
+LIBMATRIX_TARGET_AVX2 void
+soa_normalize_avx2_hand(float* dst, const float* src, size_t blocks, size_t components,
+                        size_t lanes)
+{
+    const size_t size(components * lanes);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    for (size_t blk = 0; blk < blocks; blk++, src += size, dst += size)
+    {
+        for (size_t i = 0; i < lanes; i += 8)
+        {
+            __m256 s = _mm256_setzero_ps();
+            for (size_t c = i; c < size; c += lanes)
+            {
+                __m256 v = _mm256_loadu_ps(src + c);
+                s = _mm256_fmadd_ps(v, v, s);
+            }
+            __m256 nonzero = _mm256_cmp_ps(s, _mm256_setzero_ps(), _CMP_GT_OQ);
+            s = _mm256_blendv_ps(one, _mm256_div_ps(one, _mm256_sqrt_ps(s)), nonzero);
+            for (size_t c = i; c < size; c += lanes)
+            {
+                _mm256_storeu_ps(dst + c, _mm256_mul_ps(_mm256_loadu_ps(src + c), s));
+            }
+        }
+    }
+}
+
+LIBMATRIX_TARGET_AVX2 void
+soa_length_avx2_hand(float* dst, const float* src, size_t blocks, size_t components,
+                     size_t lanes)
+{
+    const size_t size(components * lanes);
+    for (size_t blk = 0; blk < blocks; blk++, src += size)
+    {
+        for (size_t i = 0; i < lanes; i += 8, dst += 8)
+        {
+            __m256 s = _mm256_setzero_ps();
+            for (size_t c = i; c < size; c += lanes)
+            {
+                __m256 v = _mm256_loadu_ps(src + c);
+                s = _mm256_fmadd_ps(v, v, s);
+            }
+            _mm256_storeu_ps(dst, _mm256_sqrt_ps(s));
+        }
+    }
+}
+
+constexpr Kernels avx2_kernels = {
+    .id = isa::avx2,
+    .name = "avx2",
+    .mat4_multiply_f = mat4_multiply_f_avx2_hand,
+    .mat4_multiply_d = mat4_multiply_d_avx2_hand,
+    .mat4_inverse_f = mat4_inverse_f_avx2,
+    .mat4_inverse_d = mat4_inverse_d_avx2,
+    .mat4_transform4 = mat4_transform4_avx2_hand,
+    .mat4_transform3 = mat4_transform3_avx2_hand,
+    .vec3_dot = vec3_dot_avx2,
+    .vec3_cross = vec3_cross_avx2,
+    .vec3_normalize = vec3_normalize_avx2,
+    .quat_multiply = quat_multiply_avx2_hand,
+    .quat_normalize = quat_normalize_sse2_hand,
+    .soa_add = soa_add_avx2,
+    .soa_scale = soa_scale_avx2,
+    .soa_cross = soa_cross_avx2,
+    .soa_normalize = soa_normalize_avx2_hand,
+    .soa_dot = soa_dot_avx2,
+    .soa_length = soa_length_avx2_hand,
+};
+
+//
+// AVX-512
+//
+LIBMATRIX_TARGET_AVX512 void
+mat4_transform4_avx512_hand(float* dst, const float* m, const float* src, size_t count)
+{
+    // Four vectors per iteration; the remainder is handled with a masked
+    // load and store rather than a scalar tail.
+    __m512 c0 = _mm512_broadcast_f32x4(_mm_loadu_ps(m + 0));
+    __m512 c1 = _mm512_broadcast_f32x4(_mm_loadu_ps(m + 4));
+    __m512 c2 = _mm512_broadcast_f32x4(_mm_loadu_ps(m + 8));
+    __m512 c3 = _mm512_broadcast_f32x4(_mm_loadu_ps(m + 12));
+    for (size_t i = 0; i < count; i += 4, src += 16, dst += 16)
+    {
+        size_t n = count - i;
+        __mmask16 mask = n >= 4 ? static_cast<__mmask16>(0xffff) :
+                                  static_cast<__mmask16>((1u << (n * 4)) - 1);
+        __m512 v = _mm512_maskz_loadu_ps(mask, src);
+        __m512 r = _mm512_mul_ps(c0, _mm512_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm512_fmadd_ps(c1, _mm512_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+        r = _mm512_fmadd_ps(c2, _mm512_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+        r = _mm512_fmadd_ps(c3, _mm512_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+        _mm512_mask_storeu_ps(dst, mask, r);
+    }
+}
+
+LIBMATRIX_TARGET_AVX512 void
+mat4_multiply_f_avx512_hand(float* dst, const float* lhs, const float* rhs)
+{
+    mat4_transform4_avx512_hand(dst, lhs, rhs, 4);
+}
+
+LIBMATRIX_TARGET_AVX512 void
+mat4_multiply_d_avx512_hand(double* dst, const double* lhs, const double* rhs)
+{
+    // Two result columns per iteration, one in each 256-bit half.
+    __m512d a0 = _mm512_broadcast_f64x4(_mm256_loadu_pd(lhs + 0));
+    __m512d a1 = _mm512_broadcast_f64x4(_mm256_loadu_pd(lhs + 4));
+    __m512d a2 = _mm512_broadcast_f64x4(_mm256_loadu_pd(lhs + 8));
+    __m512d a3 = _mm512_broadcast_f64x4(_mm256_loadu_pd(lhs + 12));
+    for (int col = 0; col < 16; col += 8)
+    {
+        __m512d b = _mm512_loadu_pd(rhs + col);
+        __m512d r = _mm512_mul_pd(a0, _mm512_permutex_pd(b, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm512_fmadd_pd(a1, _mm512_permutex_pd(b, _MM_SHUFFLE(1, 1, 1, 1)), r);
+        r = _mm512_fmadd_pd(a2, _mm512_permutex_pd(b, _MM_SHUFFLE(2, 2, 2, 2)), r);
+        r = _mm512_fmadd_pd(a3, _mm512_permutex_pd(b, _MM_SHUFFLE(3, 3, 3, 3)), r);
+        _mm512_storeu_pd(dst + col, r);
+    }
+}
+
+constexpr Kernels avx512_kernels = {
+    .id = isa::avx512,
+    .name = "avx512",
+    .mat4_multiply_f = mat4_multiply_f_avx512_hand,
+    .mat4_multiply_d = mat4_multiply_d_avx512_hand,
+    .mat4_inverse_f = mat4_inverse_f_avx512,
+    .mat4_inverse_d = mat4_inverse_d_avx512,
+    .mat4_transform4 = mat4_transform4_avx512_hand,
+    .mat4_transform3 = mat4_transform3_avx2_hand,
+    .vec3_dot = vec3_dot_avx512,
+    .vec3_cross = vec3_cross_avx512,
+    .vec3_normalize = vec3_normalize_avx512,
+    .quat_multiply = quat_multiply_avx2_hand,
+    .quat_normalize = quat_normalize_sse2_hand,
+    .soa_add = soa_add_avx512,
+    .soa_scale = soa_scale_avx512,
+    .soa_cross = soa_cross_avx512,
+    .soa_normalize = soa_normalize_avx2_hand,
+    .soa_dot = soa_dot_avx512,
+    .soa_length = soa_length_avx2_hand,
+};
+
+#endif // LIBMATRIX_SIMD_X86
+
+#if defined(LIBMATRIX_SIMD_NEON)
+
+LIBMATRIX_PORTABLE_KERNELS(neon, )
+
+void
+mat4_transform4_neon_hand(float* dst, const float* m, const float* src, size_t count)
+{
+    float32x4_t c0 = vld1q_f32(m + 0);
+    float32x4_t c1 = vld1q_f32(m + 4);
+    float32x4_t c2 = vld1q_f32(m + 8);
+    float32x4_t c3 = vld1q_f32(m + 12);
+    for (size_t i = 0; i < count; i++, src += 4, dst += 4)
+    {
+        float32x4_t v = vld1q_f32(src);
+#if defined(__aarch64__)
+        float32x4_t r = vmulq_laneq_f32(c0, v, 0);
+        r = vfmaq_laneq_f32(r, c1, v, 1);
+        r = vfmaq_laneq_f32(r, c2, v, 2);
+        r = vfmaq_laneq_f32(r, c3, v, 3);
+#else
+        float32x4_t r = vmulq_lane_f32(c0, vget_low_f32(v), 0);
+        r = vmlaq_lane_f32(r, c1, vget_low_f32(v), 1);
+        r = vmlaq_lane_f32(r, c2, vget_high_f32(v), 0);
+        r = vmlaq_lane_f32(r, c3, vget_high_f32(v), 1);
+#endif
+        vst1q_f32(dst, r);
+    }
+}
+
+void
+mat4_multiply_f_neon_hand(float* dst, const float* lhs, const float* rhs)
+{
+    mat4_transform4_neon_hand(dst, lhs, rhs, 4);
+}
+
+#if defined(__aarch64__)
+void
+mat4_multiply_d_neon_hand(double* dst, const double* lhs, const double* rhs)
+{
+    float64x2_t a0l = vld1q_f64(lhs + 0);
+    float64x2_t a0h = vld1q_f64(lhs + 2);
+    float64x2_t a1l = vld1q_f64(lhs + 4);
+    float64x2_t a1h = vld1q_f64(lhs + 6);
+    float64x2_t a2l = vld1q_f64(lhs + 8);
+    float64x2_t a2h = vld1q_f64(lhs + 10);
+    float64x2_t a3l = vld1q_f64(lhs + 12);
+    float64x2_t a3h = vld1q_f64(lhs + 14);
+    for (int col = 0; col < 16; col += 4)
+    {
+        float64x2_t b01 = vld1q_f64(rhs + col);
+        float64x2_t b23 = vld1q_f64(rhs + col + 2);
+        float64x2_t rl = vmulq_laneq_f64(a0l, b01, 0);
+        float64x2_t rh = vmulq_laneq_f64(a0h, b01, 0);
+        rl = vfmaq_laneq_f64(rl, a1l, b01, 1);
+        rh = vfmaq_laneq_f64(rh, a1h, b01, 1);
+        rl = vfmaq_laneq_f64(rl, a2l, b23, 0);
+        rh = vfmaq_laneq_f64(rh, a2h, b23, 0);
+        rl = vfmaq_laneq_f64(rl, a3l, b23, 1);
+        rh = vfmaq_laneq_f64(rh, a3h, b23, 1);
+        vst1q_f64(dst + col, rl);
+        vst1q_f64(dst + col + 2, rh);
+    }
+}
+#else
+void
+mat4_multiply_d_neon_hand(double* dst, const double* lhs, const double* rhs)
+{
+    multiply4(dst, lhs, rhs);
+}
+#endif
+
+void
+mat4_transform3_neon_hand(float* dst, const float* m, const float* src, size_t count, float w)
+{
+    float32x4_t c0 = vld1q_f32(m + 0);
+    float32x4_t c1 = vld1q_f32(m + 4);
+    float32x4_t c2 = vld1q_f32(m + 8);
+    float32x4_t t = vmulq_n_f32(vld1q_f32(m + 12), w);
+    for (size_t i = 0; i < count; i++, src += 3, dst += 3)
+    {
+        float32x4_t r = vmlaq_n_f32(t, c0, src[0]);
+        r = vmlaq_n_f32(r, c1, src[1]);
+        r = vmlaq_n_f32(r, c2, src[2]);
+        vst1_f32(dst, vget_low_f32(r));
+        vst1q_lane_f32(dst + 2, r, 2);
+    }
+}
+
+void
+quat_multiply_neon_hand(float* dst, const float* a, const float* b, size_t count)
+{
+    static const float sx[4] = { 1, -1, 1, -1 };
+    static const float sy[4] = { 1, 1, -1, -1 };
+    static const float sz[4] = { -1, 1, 1, -1 };
+    float32x4_t mx = vld1q_f32(sx);
+    float32x4_t my = vld1q_f32(sy);
+    float32x4_t mz = vld1q_f32(sz);
+    for (size_t i = 0; i < count; i++, a += 4, b += 4, dst += 4)
+    {
+        float32x4_t vb = vld1q_f32(b);
+        // (w, z, y, x), (z, w, x, y) and (y, x, w, z) of b.
+        float32x4_t yx = vrev64q_f32(vb);
+        float32x4_t bx = vcombine_f32(vget_high_f32(yx), vget_low_f32(yx));
+        float32x4_t by = vcombine_f32(vget_high_f32(vb), vget_low_f32(vb));
+        float32x4_t bz = yx;
+        float32x4_t r = vmulq_n_f32(vb, a[3]);
+        r = vmlaq_n_f32(r, vmulq_f32(bx, mx), a[0]);
+        r = vmlaq_n_f32(r, vmulq_f32(by, my), a[1]);
+        r = vmlaq_n_f32(r, vmulq_f32(bz, mz), a[2]);
+        vst1q_f32(dst, r);
+    }
+}
+
+constexpr Kernels neon_kernels = {
+    .id = isa::neon,
+    .name = "neon",
+    .mat4_multiply_f = mat4_multiply_f_neon_hand,
+    .mat4_multiply_d = mat4_multiply_d_neon_hand,
+    .mat4_inverse_f = mat4_inverse_f_neon,
+    .mat4_inverse_d = mat4_inverse_d_neon,
+    .mat4_transform4 = mat4_transform4_neon_hand,
+    .mat4_transform3 = mat4_transform3_neon_hand,
+    .vec3_dot = vec3_dot_neon,
+    .vec3_cross = vec3_cross_neon,
+    .vec3_normalize = vec3_normalize_neon,
+    .quat_multiply = quat_multiply_neon_hand,
+    .quat_normalize = quat_normalize_neon,
+    .soa_add = soa_add_neon,
+    .soa_scale = soa_scale_neon,
+    .soa_cross = soa_cross_neon,
+    .soa_normalize = soa_normalize_neon,
+    .soa_dot = soa_dot_neon,
+    .soa_length = soa_length_neon,
+};
+
+#endif // LIBMATRIX_SIMD_NEON
+
+#undef LIBMATRIX_PORTABLE_KERNELS
+
+const Kernels*
+table(isa id)
+{
+    switch (id)
+    {
+    case isa::scalar:
+        return &scalar_kernels;
+#if defined(LIBMATRIX_SIMD_X86)
+    case isa::sse2:
+        return &sse2_kernels;
+    case isa::avx2:
+        return &avx2_kernels;
+    case isa::avx512:
+        return &avx512_kernels;
+#endif // LIBMATRIX_SIMD_X86
+#if defined(LIBMATRIX_SIMD_NEON)
+    case isa::neon:
+        return &neon_kernels;
+#endif // LIBMATRIX_SIMD_NEON
+    default:
+        return 0;
+    }
+}
+
+// The kernels in use before the CPU has been probed, which must run on any
+// host the library was built for.
+#if defined(LIBMATRIX_SIMD_X86) && defined(__SSE2__)
+constexpr const Kernels* baseline_kernels(&sse2_kernels);
+#elif defined(LIBMATRIX_SIMD_NEON)
+constexpr const Kernels* baseline_kernels(&neon_kernels);
+#else
+constexpr const Kernels* baseline_kernels(&scalar_kernels);
+#endif
+
+std::atomic<const Kernels*> active_kernels(baseline_kernels);
+
+} // namespace
+
+const Kernels&
+kernels()
+{
+    return *active_kernels.load(std::memory_order_relaxed);
+}
+
+bool
+supported(isa id)
+{
+    switch (id)
+    {
+    case isa::scalar:
+        return true;
+#if defined(LIBMATRIX_SIMD_X86)
+    case isa::sse2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+    case isa::avx2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case isa::avx512:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512f") &&
+               __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif // LIBMATRIX_SIMD_X86
+#if defined(LIBMATRIX_SIMD_NEON)
+    case isa::neon:
+        return true;
+#endif // LIBMATRIX_SIMD_NEON
+    default:
+        return false;
+    }
+}
+
+bool
+select(isa id)
+{
+    const Kernels* kernels(table(id));
+    if (!kernels || !supported(id))
+    {
+        return false;
+    }
+    active_kernels.store(kernels, std::memory_order_relaxed);
+    return true;
+}
+
+void
+select_best()
+{
+    static const isa preference[] = {
+        isa::avx512,
+        isa::avx2,
+        isa::sse2,
+        isa::neon,
+        isa::scalar
+    };
+    for (isa id : preference)
+    {
+        if (select(id))
+        {
+            return;
+        }
+    }
+}
+
+namespace
+{
+// Probe the CPU once while the library is being initialized.
+const bool selected_at_startup = (select_best(), true);
+}
+
+} // namespace Simd
+} // namespace LibMatrix
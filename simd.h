@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef SIMD_H_
+#define SIMD_H_
+
+#include <stddef.h>
+
+namespace LibMatrix
+{
+namespace Simd
+{
+//
+// Hand-vectorized kernels backing the hot matrix and vector operations.  All
+// of them work on raw, column-major storage as used by the tmat classes (and
+// packed x,y,z triples for vec3 arrays), so that the same kernels can be
+// handed arrays that did not come from a tmat or tvec.  No alignment is
+// required of any of the pointers.
+//
+// Every kernel is built for several instruction sets, and the best one the
+// host CPU supports is selected once at startup.  This lets a library built
+// for a baseline ISA still take advantage of AVX2 or AVX-512 where they are
+// available.
+//
+enum class isa
+{
+    scalar,
+    sse2,
+    avx2,
+    avx512,
+    neon
+};
+
+// Table of entry points for one instruction set.
+struct Kernels
+{
+    isa id;
+    const char* name;
+    void (*mat4_multiply_f)(float* dst, const float* lhs, const float* rhs);
+    void (*mat4_multiply_d)(double* dst, const double* lhs, const double* rhs);
+    bool (*mat4_inverse_f)(float* dst, const float* src);
+    bool (*mat4_inverse_d)(double* dst, const double* src);
+    void (*mat4_transform4)(float* dst, const float* m, const float* src, size_t count);
+    void (*mat4_transform3)(float* dst, const float* m, const float* src, size_t count, float w);
+    void (*vec3_dot)(float* dst, const float* a, const float* b, size_t count);
+    void (*vec3_cross)(float* dst, const float* a, const float* b, size_t count);
+    void (*vec3_normalize)(float* dst, const float* src, size_t count);
+    void (*quat_multiply)(float* dst, const float* a, const float* b, size_t count);
+    void (*quat_normalize)(float* dst, const float* src, size_t count);
+    void (*soa_add)(float* dst, const float* a, const float* b, size_t count);
+    void (*soa_scale)(float* dst, const float* src, float s, size_t count);
+    void (*soa_cross)(float* dst, const float* a, const float* b, size_t blocks, size_t lanes);
+    void (*soa_normalize)(float* dst, const float* src, size_t blocks, size_t components, size_t lanes);
+    void (*soa_dot)(float* dst, const float* a, const float* b, size_t blocks, size_t components, size_t lanes);
+    void (*soa_length)(float* dst, const float* src, size_t blocks, size_t components, size_t lanes);
+};
+
+// The active table.  This starts out as kernels that are safe on any host
+// of the target architecture, and is switched over to the best supported
+// set during static initialization of the library.
+const Kernels& kernels();
+
+// Report whether the host CPU can run the kernels for an instruction set.
+bool supported(isa id);
+
+// Force the use of a particular set of kernels (e.g. to compare variants in
+// tests and benchmarks).  Returns false, leaving the current selection
+// alone, if the host cannot run them or they were not built in.
+bool select(isa id);
+
+// Select the best set of kernels supported by the host CPU.  This is done
+// automatically at startup.
+void select_best();
+
+// Multiply two 4x4 matrices (dst = lhs * rhs).  Each column of the result
+// is formed by broadcasting the elements of the matching rhs column against
+// the columns of lhs.  It is safe for dst to alias lhs and/or rhs.
+inline void
+mat4_multiply(float* dst, const float* lhs, const float* rhs)
+{
+    kernels().mat4_multiply_f(dst, lhs, rhs);
+}
+
+inline void
+mat4_multiply(double* dst, const double* lhs, const double* rhs)
+{
+    kernels().mat4_multiply_d(dst, lhs, rhs);
+}
+
+// Invert a 4x4 matrix into dst.  Returns false, leaving dst untouched, if
+// the matrix is singular.  It is safe for dst to alias src.
+inline bool
+mat4_inverse(float* dst, const float* src)
+{
+    return kernels().mat4_inverse_f(dst, src);
+}
+
+inline bool
+mat4_inverse(double* dst, const double* src)
+{
+    return kernels().mat4_inverse_d(dst, src);
+}
+
+// Transform 'count' packed 4-component vectors by the matrix m.  It is safe
+// for dst to alias src.
+inline void
+mat4_transform4(float* dst, const float* m, const float* src, size_t count)
+{
+    kernels().mat4_transform4(dst, m, src, count);
+}
+
+// Transform 'count' packed 3-component vectors by the matrix m, using 'w'
+// as the implied fourth component (1 for points, 0 for directions).  The
+// bottom row of m is ignored, so no perspective divide takes place.  It is
+// safe for dst to alias src.
+inline void
+mat4_transform3(float* dst, const float* m, const float* src, size_t count, float w)
+{
+    kernels().mat4_transform3(dst, m, src, count, w);
+}
+
+// Compute 'count' dot products of packed 3-component vectors.
+inline void
+vec3_dot(float* dst, const float* a, const float* b, size_t count)
+{
+    kernels().vec3_dot(dst, a, b, count);
+}
+
+// Compute 'count' cross products of packed 3-component vectors.  It is safe
+// for dst to alias a or b.
+inline void
+vec3_cross(float* dst, const float* a, const float* b, size_t count)
+{
+    kernels().vec3_cross(dst, a, b, count);
+}
+
+// Normalize 'count' packed 3-component vectors.  Zero-length vectors are
+// copied unchanged.  It is safe for dst to alias src.
+inline void
+vec3_normalize(float* dst, const float* src, size_t count)
+{
+    kernels().vec3_normalize(dst, src, count);
+}
+
+// Compute 'count' Hamilton products of packed x,y,z,w quaternions.  It is
+// safe for dst to alias a or b.
+inline void
+quat_multiply(float* dst, const float* a, const float* b, size_t count)
+{
+    kernels().quat_multiply(dst, a, b, count);
+}
+
+// Normalize 'count' packed x,y,z,w quaternions.  Zero-length quaternions
+// are copied unchanged.  It is safe for dst to alias src.
+inline void
+quat_normalize(float* dst, const float* src, size_t count)
+{
+    kernels().quat_normalize(dst, src, count);
+}
+
+//
+// Kernels for vectors stored in blocks of structures of arrays (see
+// tvec_soa in vec-soa.h).  A block holds 'lanes' values of its first
+// component, then 'lanes' of the second, and so on.  'lanes' must be a
+// multiple of soa_lane_multiple.  It is safe for dst to alias a source.
+//
+constexpr size_t soa_lane_multiple = 8;
+
+// dst = a + b, for 'count' floats (a multiple of soa_lane_multiple).
+inline void
+soa_add(float* dst, const float* a, const float* b, size_t count)
+{
+    kernels().soa_add(dst, a, b, count);
+}
+
+// dst = src * s, for 'count' floats (a multiple of soa_lane_multiple).
+inline void
+soa_scale(float* dst, const float* src, float s, size_t count)
+{
+    kernels().soa_scale(dst, src, s, count);
+}
+
+// Cross products of the 3-component vectors in 'blocks' blocks.
+inline void
+soa_cross(float* dst, const float* a, const float* b, size_t blocks, size_t lanes)
+{
+    kernels().soa_cross(dst, a, b, blocks, lanes);
+}
+
+// Normalize the vectors in 'blocks' blocks.  Zero-length vectors are copied
+// unchanged.
+inline void
+soa_normalize(float* dst, const float* src, size_t blocks, size_t components, size_t lanes)
+{
+    kernels().soa_normalize(dst, src, blocks, components, lanes);
+}
+
+// Dot products of the vectors in 'blocks' blocks, one per lane, so dst
+// receives blocks * lanes values.
+inline void
+soa_dot(float* dst, const float* a, const float* b, size_t blocks, size_t components,
+        size_t lanes)
+{
+    kernels().soa_dot(dst, a, b, blocks, components, lanes);
+}
+
+// Lengths of the vectors in 'blocks' blocks, one per lane, so dst receives
+// blocks * lanes values.
+inline void
+soa_length(float* dst, const float* src, size_t blocks, size_t components, size_t lanes)
+{
+    kernels().soa_length(dst, src, blocks, components, lanes);
+}
+
+} // namespace Simd
+} // namespace LibMatrix
+
+#endif // SIMD_H_
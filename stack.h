@@ -13,6 +13,7 @@
 #define STACK_H_
 
 #include <vector>
+#include <stdexcept>
 #include "mat.h"
 
 namespace LibMatrix
@@ -50,6 +51,10 @@ public:
     {
         theStack_.back().setIdentity();
     }
+    void load(const T& matrix)
+    {
+        theStack_.back() = matrix;
+    }
     T& operator*=(const T& rhs)
     {
         T& curMatrix = theStack_.back();
@@ -66,20 +71,235 @@ private:
     std::vector<T> theStack_;
 };
 
-class Stack4 : public MatrixStack<mat4> 
+//
+// Matrix stack with a fixed maximum depth, for code that needs deterministic
+// timing (e.g. scene traversal in the middle of a frame).  All of the
+// storage lives inside the object and is set up at construction, so push()
+// never allocates; it only copies the top matrix into the next slot.  The
+// slots are cache line aligned, so each mat4 copy is a single aligned
+// 64-byte move.
+//
+// Pushing past 'Capacity' or popping the last matrix is an error, and is
+// otherwise ignored.
+//
+template<typename T, unsigned int Capacity>
+class FixedMatrixStack
 {
+    static_assert(Capacity > 0, "FixedMatrixStack needs room for at least one matrix");
 public:
+    FixedMatrixStack() : depth_(1) {}
+    FixedMatrixStack(const T& matrix) : depth_(1)
+    {
+        theStack_[0] = matrix;
+    }
+    ~FixedMatrixStack() {}
+
+    const T& getCurrent() const { return theStack_[depth_ - 1]; }
+
+    void push()
+    {
+        if (depth_ == Capacity)
+        {
+#ifdef USE_EXCEPTIONS
+            throw std::overflow_error("Matrix stack overflow");
+#else // !USE_EXCEPTIONS
+            Log::error("Matrix stack overflow (capacity %u)\n", Capacity);
+            return;
+#endif // USE_EXCEPTIONS
+        }
+        theStack_[depth_] = theStack_[depth_ - 1];
+        depth_++;
+    }
+    void pop()
+    {
+        if (depth_ == 1)
+        {
+#ifdef USE_EXCEPTIONS
+            throw std::underflow_error("Matrix stack underflow");
+#else // !USE_EXCEPTIONS
+            Log::error("Matrix stack underflow\n");
+            return;
+#endif // USE_EXCEPTIONS
+        }
+        depth_--;
+    }
+    void loadIdentity()
+    {
+        theStack_[depth_ - 1].setIdentity();
+    }
+    void load(const T& matrix)
+    {
+        theStack_[depth_ - 1] = matrix;
+    }
+    T& operator*=(const T& rhs)
+    {
+        T& curMatrix = theStack_[depth_ - 1];
+        curMatrix *= rhs;
+        return curMatrix;
+    }
+    void print() const
+    {
+        const T& curMatrix = theStack_[depth_ - 1];
+        curMatrix.print();
+    }
+    unsigned int getDepth() const { return depth_; }
+    unsigned int getCapacity() const { return Capacity; }
+    // The storage for all of the matrices, bottom first (e.g. to check its
+    // alignment).
+    const T* slots() const { return theStack_; }
+    bool full() const { return depth_ == Capacity; }
+private:
+    alignas(64) T theStack_[Capacity];
+    unsigned int depth_;
+};
+
+//
+// The OpenGL-style transformation functions, on top of either kind of
+// matrix stack.
+//
+// The affine operations (translate, scale, rotate and lookAt) are not
+// multiplied into the top of the stack straight away.  Instead they are
+// gathered into a pending affine transform, where a translate or scale
+// only touches the elements it changes, and that is folded into the top
+// of the stack with a single mat4 * affine4 product when the matrix is
+// next needed (or, from a const method, into a cached copy of the top).  A
+// pop() simply drops whatever is pending, unless the pop is refused at the
+// bottom of the stack.
+//
+// The stack also caches the matrices usually derived from the top of a
+// modelview stack: its inverse, its normal matrix and the product with a
+// projection matrix.  Each is computed on first request and then reused
+// until the top of the stack changes, so a draw loop can ask for them
+// repeatedly at no cost.
+//
+// The matrix stack is a protected base, so that its own getCurrent(),
+// push() and pop(), which know nothing of the pending transform, cannot be
+// reached from outside.
+//
+template<typename Base>
+class TransformStack : protected Base
+{
+public:
+    TransformStack() : pendingValid_(false), cacheValid_(0) {}
+
+    using Base::getDepth;
+
+    // The top of the stack, with any pending operations applied.  While
+    // operations are pending, this is their product with the top of the
+    // stack, computed once and cached.
+    const mat4& getCurrent() const
+    {
+        if (!pendingValid_)
+        {
+            return Base::getCurrent();
+        }
+        if (!(cacheValid_ & CurrentValid))
+        {
+            current_ = Base::getCurrent() * pending_;
+            cacheValid_ |= CurrentValid;
+        }
+        return current_;
+    }
+
+    // The inverse of getCurrent().
+    const mat4& getInverse() const
+    {
+        if (!(cacheValid_ & InverseValid))
+        {
+            inverse_ = getCurrent();
+            inverse_.inverse();
+            cacheValid_ |= InverseValid;
+        }
+        return inverse_;
+    }
+
+    // The inverse transpose of the upper 3x3 of getCurrent(), for
+    // transforming normals.
+    const mat3& getNormalMatrix() const
+    {
+        if (!(cacheValid_ & NormalValid))
+        {
+            normal_ = getCurrent().inverse_transpose3x3();
+            cacheValid_ |= NormalValid;
+        }
+        return normal_;
+    }
+
+    // Set the projection for getModelViewProjection().
+    void setProjection(const mat4& projection)
+    {
+        projection_ = projection;
+        cacheValid_ &= ~MvpValid;
+    }
+
+    // The projection set by setProjection() times getCurrent().
+    const mat4& getModelViewProjection() const
+    {
+        if (!(cacheValid_ & MvpValid))
+        {
+            mvp_ = projection_;
+            mvp_ *= getCurrent();
+            cacheValid_ |= MvpValid;
+        }
+        return mvp_;
+    }
+
+    void push()
+    {
+        fold();
+        Base::push();
+    }
+    void pop()
+    {
+        // A pop refused at the bottom of the stack must not change the
+        // current transform.
+        if (Base::getDepth() > 1)
+        {
+            pending_.setIdentity();
+            pendingValid_ = false;
+            changed();
+        }
+        Base::pop();
+    }
+    void loadIdentity()
+    {
+        pending_.setIdentity();
+        pendingValid_ = false;
+        Base::loadIdentity();
+        changed();
+    }
+    void load(const mat4& matrix)
+    {
+        pending_.setIdentity();
+        pendingValid_ = false;
+        Base::load(matrix);
+        changed();
+    }
+    const mat4& operator*=(const mat4& rhs)
+    {
+        fold();
+        changed();
+        return Base::operator*=(rhs);
+    }
+    void print() const
+    {
+        getCurrent().print();
+    }
+
     void translate(float x, float y, float z)
     {
-        *this *= Mat4::translate(x, y, z);
+        pending_.translate(x, y, z);
+        pendingChanged();
     }
     void scale(float x, float y, float z)
     {
-        *this *= Mat4::scale(x, y, z);
+        pending_.scale(x, y, z);
+        pendingChanged();
     }
     void rotate(float angle, float x, float y, float z)
     {
-        *this *= Mat4::rotate(angle, x, y, z);
+        pending_ *= Affine4::rotate(angle, x, y, z);
+        pendingChanged();
     }
     void frustum(float left, float right, float bottom, float top, float near, float far)
     {
@@ -97,8 +317,58 @@ public:
                 float centerX, float centerY, float centerZ, 
                 float upX, float upY, float upZ)
     {
-        *this *= Mat4::lookAt(eyeX, eyeY, eyeZ, centerX, centerY, centerZ, upX, upY, upZ);
+        pending_ *= Affine4::lookAt(eyeX, eyeY, eyeZ, centerX, centerY, centerZ, upX, upY, upZ);
+        pendingChanged();
+    }
+
+private:
+    enum
+    {
+        InverseValid = 1 << 0,
+        NormalValid = 1 << 1,
+        MvpValid = 1 << 2,
+        CurrentValid = 1 << 3
+    };
+
+    // Fold the pending transform into the top of the stack.
+    void fold()
+    {
+        if (pendingValid_)
+        {
+            Base::load(getCurrent());
+            pending_.setIdentity();
+            pendingValid_ = false;
+        }
+    }
+    void changed() { cacheValid_ = 0; }
+    void pendingChanged()
+    {
+        pendingValid_ = true;
+        changed();
     }
+
+    affine4 pending_;
+    bool pendingValid_;
+    mat4 projection_;
+    mutable mat4 current_;
+    mutable mat4 inverse_;
+    mutable mat3 normal_;
+    mutable mat4 mvp_;
+    mutable unsigned int cacheValid_;
+};
+
+class Stack4 : public TransformStack<MatrixStack<mat4> >
+{
+};
+
+template<unsigned int Capacity>
+class FixedStack4 : public TransformStack<FixedMatrixStack<mat4, Capacity> >
+{
+    typedef FixedMatrixStack<mat4, Capacity> Base;
+public:
+    using Base::getCapacity;
+    using Base::full;
+    using Base::slots;
 };
 
 } // namespace LibMatrix
@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <iostream>
+#include <math.h>
+#include "libmatrix_test.h"
+#include "affine_test.h"
+#include "../mat.h"
+
+using LibMatrix::mat4;
+using LibMatrix::affine4;
+using LibMatrix::vec3;
+using LibMatrix::vec4;
+using std::cout;
+using std::endl;
+
+void
+AffineTestMultiply::run(const Options& options)
+{
+    // Integer-valued elements, so that the products are exact.
+    mat4 a;
+    mat4 b;
+    for (int row = 0; row < 3; row++)
+    {
+        for (int col = 0; col < 4; col++)
+        {
+            a[row][col] = row * 4 + col - 5;
+            b[row][col] = (row + 2) * (col - 1);
+        }
+    }
+
+    affine4 aa(a);
+    affine4 ab(b);
+    if (aa.to_mat4() != a)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Round trip through affine4 changed the matrix" << endl;
+        }
+        return;
+    }
+
+    mat4 expected(a);
+    expected *= b;
+    aa *= ab;
+    if (aa.to_mat4() != expected)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Composed affine transform:" << endl;
+            aa.print();
+            cout << "does not match the mat4 product:" << endl;
+            expected.print();
+        }
+        return;
+    }
+
+    // A full matrix times an affine one.
+    mat4 p(LibMatrix::Mat4::perspective(60.0, 1.5, 1.0, 100.0));
+    mat4 pexpected(p);
+    pexpected *= b;
+    if (!close(p * ab, pexpected, 1e-4))
+    {
+        if (options.beVerbose())
+        {
+            cout << "mat4 * affine4 does not match the mat4 product" << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+AffineTestInverse::run(const Options& options)
+{
+    affine4 m(LibMatrix::Affine4::translate(3.0, -1.0, 2.0));
+    m *= LibMatrix::Affine4::rotate(40.0, 0.0, 1.0, 1.0);
+    m *= LibMatrix::Affine4::scale(2.0, 3.0, 0.5);
+
+    affine4 inv(m);
+    inv.inverse();
+    mat4 expected(m.to_mat4());
+    expected.inverse();
+    if (!close(inv.to_mat4(), expected, 1e-4))
+    {
+        if (options.beVerbose())
+        {
+            cout << "Inverse of affine transform:" << endl;
+            inv.print();
+            cout << "does not match the mat4 inverse:" << endl;
+            expected.print();
+        }
+        return;
+    }
+
+    affine4 identity(m * inv);
+    if (!close(identity.to_mat4(), mat4(), 1e-4))
+    {
+        if (options.beVerbose())
+        {
+            cout << "An affine transform times its inverse is not the identity" << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+AffineTestTransform::run(const Options& options)
+{
+    affine4 m(LibMatrix::Affine4::lookAt(1.0, 2.0, 5.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0));
+    mat4 full(LibMatrix::Mat4::lookAt(1.0, 2.0, 5.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0));
+    if (!close(m.to_mat4(), full, 1e-4))
+    {
+        if (options.beVerbose())
+        {
+            cout << "Affine4::lookAt does not match Mat4::lookAt" << endl;
+        }
+        return;
+    }
+
+    const vec3 p(0.5, -1.5, 2.0);
+    vec3 point(m.transform_point(p));
+    vec3 vector(m.transform_vector(p));
+    vec4 epoint(full * vec4(p, 1.0f));
+    vec4 evector(full * vec4(p, 0.0f));
+    for (int i = 0; i < 3; i++)
+    {
+        if (fabs(point[i] - epoint[i]) > 1e-5 || fabs(vector[i] - evector[i]) > 1e-5)
+        {
+            if (options.beVerbose())
+            {
+                cout << "Affine transform of a point or vector is wrong" << endl;
+            }
+            return;
+        }
+    }
+
+    pass_ = true;
+}
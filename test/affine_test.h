@@ -0,0 +1,36 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef AFFINE_TEST_H_
+#define AFFINE_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class AffineTestMultiply : public MatrixTest
+{
+public:
+    AffineTestMultiply() : MatrixTest("affine4::multiply") {}
+    virtual void run(const Options& options);
+};
+
+class AffineTestInverse : public MatrixTest
+{
+public:
+    AffineTestInverse() : MatrixTest("affine4::inverse") {}
+    virtual void run(const Options& options);
+};
+
+class AffineTestTransform : public MatrixTest
+{
+public:
+    AffineTestTransform() : MatrixTest("affine4::transform") {}
+    virtual void run(const Options& options);
+};
+
+#endif // AFFINE_TEST_H_
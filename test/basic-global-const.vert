@@ -1,4 +1,4 @@
-const vec4 ConstantColor = vec4(1.000000, 1.000000, 1.000000, 1.000000);
+const vec4 ConstantColor = vec4(1.0, 1.0, 1.0, 1.0);
 attribute vec3 position;
 
 uniform mat4 modelview;
@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <iostream>
+#include "libmatrix_test.h"
+#include "expr_test.h"
+#include "../vec-expr.h"
+
+using LibMatrix::vec3;
+using LibMatrix::vec4;
+using LibMatrix::Expr::lazy;
+using std::cout;
+using std::endl;
+
+void
+ExprTestVec3::run(const Options& options)
+{
+    // Values chosen so that every intermediate is exact.
+    const vec3 a(1.0, -2.0, 3.0);
+    const vec3 b(0.5, 4.0, -1.5);
+    const vec3 c(2.0, 2.0, 2.0);
+    const float s(2.0);
+    const float t(-4.0);
+
+    vec3 eager((a * s) + (b * t) - c);
+    vec3 fused = lazy(a) * s + lazy(b) * t - c;
+    if (fused != eager)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Fused expression does not match the eager one" << endl;
+        }
+        return;
+    }
+
+    // Scalars on the left, division and negation.
+    vec3 eager2((c - a) / 2.0f + 1.0f);
+    vec3 fused2 = 1.0f + -(lazy(a) - c) / 2.0f;
+    vec3 eager3(c - (a * 3.0f));
+    vec3 fused3 = c - 3.0f * lazy(a);
+    if (fused2 != eager2 || fused3 != eager3)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Expression with scalar operands is wrong" << endl;
+        }
+        return;
+    }
+
+    // Evaluating into one of the operands, as in an integration step.
+    vec3 v(a);
+    LibMatrix::Expr::assign(v, lazy(b) * 0.5f + v);
+    if (v != a + (b * 0.5f))
+    {
+        if (options.beVerbose())
+        {
+            cout << "Evaluation into an operand is wrong" << endl;
+        }
+        return;
+    }
+
+    if (LibMatrix::Expr::dot(lazy(a) - b, c) != vec3::dot(a - b, c))
+    {
+        if (options.beVerbose())
+        {
+            cout << "Dot product of an expression is wrong" << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+ExprTestVec4::run(const Options& options)
+{
+    const vec4 a(1.0, 2.0, 3.0, 4.0);
+    const vec4 b(8.0, 4.0, 2.0, 1.0);
+
+    vec4 eager((a * b) / 2.0f - a);
+    vec4 fused = lazy(a) * b / 2.0f - a;
+    if (fused != eager)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Fused vec4 expression does not match the eager one" << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
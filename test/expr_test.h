@@ -0,0 +1,29 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef EXPR_TEST_H_
+#define EXPR_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class ExprTestVec3 : public MatrixTest
+{
+public:
+    ExprTestVec3() : MatrixTest("vec3::expression") {}
+    virtual void run(const Options& options);
+};
+
+class ExprTestVec4 : public MatrixTest
+{
+public:
+    ExprTestVec4() : MatrixTest("vec4::expression") {}
+    virtual void run(const Options& options);
+};
+
+#endif // EXPR_TEST_H_
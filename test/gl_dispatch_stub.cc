@@ -0,0 +1,23 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include "../gl-dispatch.h"
+
+//
+// Linked into the test program in place of gl-dispatch.o, which would need
+// a GL library.  The tests install the mock table (see gl_mock.h) with
+// GLDispatch::set(), so nothing should ever reach this one: its entries
+// are all null, to make a call that does fail loudly.
+//
+static const GLDispatch stubDispatch = {};
+
+const GLDispatch&
+GLDispatch::system()
+{
+    return stubDispatch;
+}
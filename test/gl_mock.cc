@@ -0,0 +1,742 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include "gl_mock.h"
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace
+{
+
+const GLenum mockBinaryFormat(0x4d4f434b);
+const string binaryHeader("MOCKBINARY\n");
+
+struct Variable
+{
+    string name;
+    GLenum type;
+    GLint size;
+    GLint location;
+};
+
+struct Shader
+{
+    GLenum type;
+    string source;
+    bool compiled;
+    string log;
+};
+
+struct Program
+{
+    Program() : linked(false), pollsLeft(0) {}
+    vector<GLuint> shaders;
+    bool linked;
+    string log;
+    string sources;
+    vector<Variable> attributes;
+    vector<Variable> uniforms;
+    vector<string> blocks;
+    map<GLint, vector<float> > values;
+    unsigned int pollsLeft;
+};
+
+struct State
+{
+    State() { clear(); }
+    void clear()
+    {
+        shaders.clear();
+        programs.clear();
+        buffers.clear();
+        bufferBindings.clear();
+        uniformBindings.clear();
+        calls.clear();
+        totalCalls = 0;
+        nextName = 1;
+        current = 0;
+        linkFailure = false;
+        parallelCompile = false;
+        pollsToComplete = 0;
+        binaryFormats = 1;
+        driverVersion = "1.0 mock";
+    }
+    map<GLuint, Shader> shaders;
+    map<GLuint, Program> programs;
+    map<GLuint, vector<unsigned char> > buffers;
+    map<GLenum, GLuint> bufferBindings;
+    map<GLuint, GLuint> uniformBindings;
+    map<string, unsigned int> calls;
+    unsigned int totalCalls;
+    GLuint nextName;
+    GLuint current;
+    bool linkFailure;
+    bool parallelCompile;
+    unsigned int pollsToComplete;
+    int binaryFormats;
+    string driverVersion;
+};
+
+State&
+state()
+{
+    static State theState;
+    return theState;
+}
+
+void
+count(const char* name)
+{
+    state().calls[name]++;
+    state().totalCalls++;
+}
+
+GLenum
+typeFromName(const string& name)
+{
+    static const struct { const char* name; GLenum type; } types[] = {
+        { "float", GL_FLOAT },
+        { "vec2", GL_FLOAT_VEC2 },
+        { "vec3", GL_FLOAT_VEC3 },
+        { "vec4", GL_FLOAT_VEC4 },
+        { "mat3", GL_FLOAT_MAT3 },
+        { "mat4", GL_FLOAT_MAT4 },
+        { "int", GL_INT },
+        { "bool", GL_BOOL },
+        { "sampler2D", GL_SAMPLER_2D },
+        { "samplerCube", GL_SAMPLER_CUBE },
+    };
+    for (unsigned int i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+    {
+        if (name == types[i].name)
+        {
+            return types[i].type;
+        }
+    }
+    return 0;
+}
+
+//
+// Pick the declarations out of a shader source.  Only the simple forms
+// used by the tests are understood:
+//
+//     attribute vec3 position;   in vec3 position;
+//     uniform mat4 mvp;          uniform vec4 lights[4];
+//     uniform Material {
+//
+void
+parseDeclarations(const string& source, bool vertex, Program& program)
+{
+    std::istringstream tokens(source);
+    vector<string> words;
+    string word;
+    while (tokens >> word)
+    {
+        words.push_back(word);
+    }
+    for (size_t i = 0; i + 1 < words.size(); i++)
+    {
+        const string& qualifier(words[i]);
+        bool isUniform(qualifier == "uniform");
+        bool isAttribute(vertex && (qualifier == "attribute" || qualifier == "in"));
+        if (!isUniform && !isAttribute)
+        {
+            continue;
+        }
+        if (isUniform && (words[i + 1] == "{" || (i + 2 < words.size() && words[i + 2] == "{")))
+        {
+            string block(words[i + 1]);
+            if (block.size() > 1 && block[block.size() - 1] == '{')
+            {
+                block.erase(block.size() - 1);
+            }
+            program.blocks.push_back(block);
+            continue;
+        }
+        if (i + 2 >= words.size())
+        {
+            break;
+        }
+        GLenum type(typeFromName(words[i + 1]));
+        string name(words[i + 2]);
+        if (!type || name.empty() || name[name.size() - 1] != ';')
+        {
+            continue;
+        }
+        name.erase(name.size() - 1);
+        GLint size(1);
+        size_t bracket(name.find('['));
+        if (bracket != string::npos)
+        {
+            size = atoi(name.c_str() + bracket + 1);
+            name = name.substr(0, bracket) + "[0]";
+        }
+        vector<Variable>& list(isUniform ? program.uniforms : program.attributes);
+        bool known(false);
+        for (vector<Variable>::const_iterator it = list.begin(); it != list.end(); it++)
+        {
+            known = known || it->name == name;
+        }
+        if (!known)
+        {
+            GLint location(0);
+            if (!list.empty())
+            {
+                location = list.back().location + list.back().size;
+            }
+            Variable v = { name, type, size, location };
+            list.push_back(v);
+        }
+    }
+}
+
+// Set a program's interface from the (concatenated) sources of its
+// shaders.  Vertex shader sources are prefixed with 'V', others with 'F'.
+void
+linkSources(Program& program)
+{
+    program.attributes.clear();
+    program.uniforms.clear();
+    program.blocks.clear();
+    std::istringstream in(program.sources);
+    string record;
+    while (std::getline(in, record, '\0'))
+    {
+        if (!record.empty())
+        {
+            parseDeclarations(record.substr(1), record[0] == 'V', program);
+        }
+    }
+    program.linked = true;
+    program.log.clear();
+}
+
+Program*
+findProgram(GLuint name)
+{
+    map<GLuint, Program>::iterator it = state().programs.find(name);
+    return it == state().programs.end() ? 0 : &it->second;
+}
+
+const Variable*
+findVariable(const vector<Variable>& list, const string& name, GLint& offset)
+{
+    string base(name);
+    offset = 0;
+    size_t bracket(name.find('['));
+    if (bracket != string::npos)
+    {
+        base = name.substr(0, bracket);
+        offset = atoi(name.c_str() + bracket + 1);
+    }
+    for (vector<Variable>::const_iterator it = list.begin(); it != list.end(); it++)
+    {
+        if (it->name == base || it->name == base + "[0]")
+        {
+            if (offset >= it->size)
+            {
+                return 0;
+            }
+            return &(*it);
+        }
+    }
+    return 0;
+}
+
+void
+copyString(const string& s, GLsizei bufSize, GLsizei* length, GLchar* dst)
+{
+    GLsizei n(0);
+    if (bufSize > 0)
+    {
+        n = std::min<GLsizei>(s.size(), bufSize - 1);
+        memcpy(dst, s.data(), n);
+        dst[n] = '\0';
+    }
+    if (length)
+    {
+        *length = n;
+    }
+}
+
+void
+storeUniform(GLint location, GLsizei count, unsigned int components, const float* value)
+{
+    Program* program(findProgram(state().current));
+    if (!program || location < 0)
+    {
+        return;
+    }
+    for (GLsizei i = 0; i < count; i++)
+    {
+        program->values[location + i].assign(value + i * components,
+                                             value + (i + 1) * components);
+    }
+}
+
+void
+getActive(const vector<Variable>& list, GLuint index, GLsizei bufSize,
+          GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    if (index >= list.size())
+    {
+        return;
+    }
+    copyString(list[index].name, bufSize, length, name);
+    *size = list[index].size;
+    *type = list[index].type;
+}
+
+GLsizei
+maxNameLength(const vector<Variable>& list)
+{
+    GLsizei length(0);
+    for (vector<Variable>::const_iterator it = list.begin(); it != list.end(); it++)
+    {
+        length = std::max<GLsizei>(length, it->name.size() + 1);
+    }
+    return length;
+}
+
+const GLDispatch mockDispatch = {
+    .CreateShader = [](GLenum type)
+    {
+        count("CreateShader");
+        GLuint name(state().nextName++);
+        Shader shader = { type, string(), false, string() };
+        state().shaders[name] = shader;
+        return name;
+    },
+    .ShaderSource = [](GLuint shader, GLsizei n, const GLchar* const* strings, const GLint* lengths)
+    {
+        count("ShaderSource");
+        string source;
+        for (GLsizei i = 0; i < n; i++)
+        {
+            source += lengths ? string(strings[i], lengths[i]) : string(strings[i]);
+        }
+        state().shaders[shader].source = source;
+    },
+    .CompileShader = [](GLuint shader)
+    {
+        count("CompileShader");
+        Shader& s(state().shaders[shader]);
+        s.compiled = s.source.find("#error") == string::npos;
+        s.log = s.compiled ? string() : string("0:1: error: #error directive");
+    },
+    .GetShaderiv = [](GLuint shader, GLenum pname, GLint* params)
+    {
+        count("GetShaderiv");
+        const Shader& s(state().shaders[shader]);
+        switch (pname)
+        {
+        case GL_SHADER_SOURCE_LENGTH:
+            *params = s.source.size() + 1;
+            break;
+        case GL_COMPILE_STATUS:
+            *params = s.compiled ? GL_TRUE : GL_FALSE;
+            break;
+        case GL_INFO_LOG_LENGTH:
+            *params = s.log.size() + 1;
+            break;
+        }
+    },
+    .GetShaderInfoLog = [](GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        count("GetShaderInfoLog");
+        copyString(state().shaders[shader].log, bufSize, length, infoLog);
+    },
+    .DeleteShader = [](GLuint shader)
+    {
+        count("DeleteShader");
+        state().shaders.erase(shader);
+    },
+    .CreateProgram = []()
+    {
+        count("CreateProgram");
+        GLuint name(state().nextName++);
+        state().programs[name] = Program();
+        return name;
+    },
+    .AttachShader = [](GLuint program, GLuint shader)
+    {
+        count("AttachShader");
+        state().programs[program].shaders.push_back(shader);
+    },
+    .LinkProgram = [](GLuint program)
+    {
+        count("LinkProgram");
+        Program& p(state().programs[program]);
+        p.linked = false;
+        p.sources.clear();
+        p.pollsLeft = state().pollsToComplete;
+        for (vector<GLuint>::const_iterator it = p.shaders.begin(); it != p.shaders.end(); it++)
+        {
+            const Shader& s(state().shaders[*it]);
+            if (!s.compiled)
+            {
+                p.log = "error: attached shader is not compiled";
+                return;
+            }
+            p.sources += (s.type == GL_VERTEX_SHADER ? "V" : "F") + s.source + string(1, '\0');
+        }
+        if (state().linkFailure)
+        {
+            p.log = "error: mock link failure";
+            return;
+        }
+        linkSources(p);
+    },
+    .GetProgramiv = [](GLuint program, GLenum pname, GLint* params)
+    {
+        count("GetProgramiv");
+        Program& p(state().programs[program]);
+        switch (pname)
+        {
+        case GL_LINK_STATUS:
+            *params = p.linked ? GL_TRUE : GL_FALSE;
+            break;
+        case GL_INFO_LOG_LENGTH:
+            *params = p.log.size() + 1;
+            break;
+        case GL_ACTIVE_ATTRIBUTES:
+            *params = p.attributes.size();
+            break;
+        case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:
+            *params = maxNameLength(p.attributes);
+            break;
+        case GL_ACTIVE_UNIFORMS:
+            *params = p.uniforms.size();
+            break;
+        case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+            *params = maxNameLength(p.uniforms);
+            break;
+        case GL_PROGRAM_BINARY_LENGTH:
+            *params = p.linked ? binaryHeader.size() + p.sources.size() : 0;
+            break;
+        case GL_COMPLETION_STATUS_KHR:
+            if (p.pollsLeft > 0)
+            {
+                p.pollsLeft--;
+            }
+            *params = p.pollsLeft == 0 ? GL_TRUE : GL_FALSE;
+            break;
+        }
+    },
+    .GetProgramInfoLog = [](GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        count("GetProgramInfoLog");
+        copyString(state().programs[program].log, bufSize, length, infoLog);
+    },
+    .UseProgram = [](GLuint program)
+    {
+        count("UseProgram");
+        state().current = program;
+    },
+    .DeleteProgram = [](GLuint program)
+    {
+        count("DeleteProgram");
+        state().programs.erase(program);
+    },
+    .ProgramParameteri = [](GLuint, GLenum, GLint)
+    {
+        count("ProgramParameteri");
+    },
+    .GetProgramBinary = [](GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary)
+    {
+        count("GetProgramBinary");
+        const Program& p(state().programs[program]);
+        string data(binaryHeader + p.sources);
+        GLsizei n(std::min<GLsizei>(data.size(), bufSize));
+        memcpy(binary, data.data(), n);
+        *length = n;
+        *binaryFormat = mockBinaryFormat;
+    },
+    .ProgramBinary = [](GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+    {
+        count("ProgramBinary");
+        Program& p(state().programs[program]);
+        string data(static_cast<const char*>(binary), length);
+        p.linked = false;
+        if (binaryFormat != mockBinaryFormat || data.compare(0, binaryHeader.size(), binaryHeader) != 0)
+        {
+            p.log = "error: invalid program binary";
+            return;
+        }
+        p.sources = data.substr(binaryHeader.size());
+        linkSources(p);
+    },
+    .GetAttribLocation = [](GLuint program, const GLchar* name)
+    {
+        count("GetAttribLocation");
+        GLint offset(0);
+        const Variable* v(findVariable(state().programs[program].attributes, name, offset));
+        return v ? v->location + offset : -1;
+    },
+    .GetUniformLocation = [](GLuint program, const GLchar* name)
+    {
+        count("GetUniformLocation");
+        GLint offset(0);
+        const Variable* v(findVariable(state().programs[program].uniforms, name, offset));
+        return v ? v->location + offset : -1;
+    },
+    .GetActiveAttrib = [](GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+    {
+        count("GetActiveAttrib");
+        getActive(state().programs[program].attributes, index, bufSize, length, size, type, name);
+    },
+    .GetActiveUniform = [](GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+    {
+        count("GetActiveUniform");
+        getActive(state().programs[program].uniforms, index, bufSize, length, size, type, name);
+    },
+    .GetUniformBlockIndex = [](GLuint program, const GLchar* name)
+    {
+        count("GetUniformBlockIndex");
+        const vector<string>& blocks(state().programs[program].blocks);
+        for (GLuint i = 0; i < blocks.size(); i++)
+        {
+            if (blocks[i] == name)
+            {
+                return i;
+            }
+        }
+        return static_cast<GLuint>(GL_INVALID_INDEX);
+    },
+    .UniformBlockBinding = [](GLuint, GLuint, GLuint)
+    {
+        count("UniformBlockBinding");
+    },
+    .Uniform1f = [](GLint location, GLfloat v0)
+    {
+        count("Uniform1f");
+        storeUniform(location, 1, 1, &v0);
+    },
+    .Uniform1i = [](GLint location, GLint v0)
+    {
+        count("Uniform1i");
+        float f(v0);
+        storeUniform(location, 1, 1, &f);
+    },
+    .Uniform1fv = [](GLint location, GLsizei n, const GLfloat* value)
+    {
+        count("Uniform1fv");
+        storeUniform(location, n, 1, value);
+    },
+    .Uniform2fv = [](GLint location, GLsizei n, const GLfloat* value)
+    {
+        count("Uniform2fv");
+        storeUniform(location, n, 2, value);
+    },
+    .Uniform3fv = [](GLint location, GLsizei n, const GLfloat* value)
+    {
+        count("Uniform3fv");
+        storeUniform(location, n, 3, value);
+    },
+    .Uniform4fv = [](GLint location, GLsizei n, const GLfloat* value)
+    {
+        count("Uniform4fv");
+        storeUniform(location, n, 4, value);
+    },
+    .Uniform1iv = [](GLint location, GLsizei n, const GLint* value)
+    {
+        count("Uniform1iv");
+        vector<float> f(value, value + n);
+        storeUniform(location, n, 1, f.data());
+    },
+    .UniformMatrix3fv = [](GLint location, GLsizei n, GLboolean, const GLfloat* value)
+    {
+        count("UniformMatrix3fv");
+        storeUniform(location, n, 9, value);
+    },
+    .UniformMatrix4fv = [](GLint location, GLsizei n, GLboolean, const GLfloat* value)
+    {
+        count("UniformMatrix4fv");
+        storeUniform(location, n, 16, value);
+    },
+    .GenBuffers = [](GLsizei n, GLuint* buffers)
+    {
+        count("GenBuffers");
+        for (GLsizei i = 0; i < n; i++)
+        {
+            buffers[i] = state().nextName++;
+            state().buffers[buffers[i]].clear();
+        }
+    },
+    .DeleteBuffers = [](GLsizei n, const GLuint* buffers)
+    {
+        count("DeleteBuffers");
+        for (GLsizei i = 0; i < n; i++)
+        {
+            state().buffers.erase(buffers[i]);
+        }
+    },
+    .BindBuffer = [](GLenum target, GLuint buffer)
+    {
+        count("BindBuffer");
+        state().bufferBindings[target] = buffer;
+    },
+    .BindBufferBase = [](GLenum, GLuint index, GLuint buffer)
+    {
+        count("BindBufferBase");
+        state().uniformBindings[index] = buffer;
+    },
+    .BufferData = [](GLenum target, GLsizeiptr size, const void* data, GLenum)
+    {
+        count("BufferData");
+        vector<unsigned char>& b(state().buffers[state().bufferBindings[target]]);
+        b.assign(size, 0);
+        if (data)
+        {
+            memcpy(b.data(), data, size);
+        }
+    },
+    .BufferSubData = [](GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+    {
+        count("BufferSubData");
+        vector<unsigned char>& b(state().buffers[state().bufferBindings[target]]);
+        if (static_cast<size_t>(offset + size) <= b.size())
+        {
+            memcpy(b.data() + offset, data, size);
+        }
+    },
+    .GetIntegerv = [](GLenum pname, GLint* data)
+    {
+        count("GetIntegerv");
+        switch (pname)
+        {
+        case GL_NUM_PROGRAM_BINARY_FORMATS:
+            *data = state().binaryFormats;
+            break;
+        case GL_NUM_EXTENSIONS:
+            *data = state().parallelCompile ? 1 : 0;
+            break;
+        case GL_CURRENT_PROGRAM:
+            *data = state().current;
+            break;
+        }
+    },
+    .GetString = [](GLenum name)
+    {
+        count("GetString");
+        const char* value(0);
+        switch (name)
+        {
+        case GL_VENDOR:
+            value = "libmatrix";
+            break;
+        case GL_RENDERER:
+            value = "mock";
+            break;
+        case GL_VERSION:
+            value = state().driverVersion.c_str();
+            break;
+        }
+        return reinterpret_cast<const GLubyte*>(value);
+    },
+    .GetStringi = [](GLenum name, GLuint index)
+    {
+        count("GetStringi");
+        const char* value(0);
+        if (name == GL_EXTENSIONS && index == 0 && state().parallelCompile)
+        {
+            value = "GL_KHR_parallel_shader_compile";
+        }
+        return reinterpret_cast<const GLubyte*>(value);
+    },
+};
+
+} // anonymous namespace
+
+const GLDispatch&
+GLMock::dispatch()
+{
+    return mockDispatch;
+}
+
+void
+GLMock::reset()
+{
+    state().clear();
+}
+
+unsigned int
+GLMock::calls(const string& name)
+{
+    map<string, unsigned int>::const_iterator it = state().calls.find(name);
+    return it == state().calls.end() ? 0 : it->second;
+}
+
+unsigned int
+GLMock::totalCalls()
+{
+    return state().totalCalls;
+}
+
+void
+GLMock::resetCalls()
+{
+    state().calls.clear();
+    state().totalCalls = 0;
+}
+
+vector<float>
+GLMock::uniform(int location)
+{
+    Program* p(findProgram(state().current));
+    if (!p)
+    {
+        return vector<float>();
+    }
+    map<GLint, vector<float> >::const_iterator it = p->values.find(location);
+    return it == p->values.end() ? vector<float>() : it->second;
+}
+
+vector<unsigned char>
+GLMock::buffer(unsigned int buffer)
+{
+    return state().buffers[buffer];
+}
+
+unsigned int
+GLMock::uniformBufferBinding(unsigned int index)
+{
+    return state().uniformBindings[index];
+}
+
+void
+GLMock::setLinkFailure(bool fail)
+{
+    state().linkFailure = fail;
+}
+
+void
+GLMock::setParallelCompile(bool supported, unsigned int pollsToComplete)
+{
+    state().parallelCompile = supported;
+    state().pollsToComplete = pollsToComplete;
+}
+
+void
+GLMock::setBinaryFormats(int formats)
+{
+    state().binaryFormats = formats;
+}
+
+void
+GLMock::setDriverVersion(const string& version)
+{
+    state().driverVersion = version;
+}
@@ -0,0 +1,68 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef GL_MOCK_H_
+#define GL_MOCK_H_
+
+#include <string>
+#include <vector>
+#include "../gl-dispatch.h"
+
+//
+// A headless stand-in for the GL entry points in GLDispatch.  The test
+// program installs this table with GLDispatch::set() before running any
+// test, so Program, Shader and UniformBuffer run against it without a GL
+// library or a GPU.
+//
+// The mock keeps just enough state to behave plausibly:
+//
+//  - A shader compiles unless its source contains "#error".
+//  - Linking fails if an attached shader did not compile, or if
+//    setLinkFailure() is in effect.  Otherwise the program's active
+//    attributes ("attribute" or "in" declarations in vertex shaders) and
+//    uniforms ("uniform" declarations, including arrays and blocks) are
+//    taken from the shader sources, with locations handed out in order.
+//  - Uniform values are stored per program and can be read back.
+//  - Program binaries are supported (one format), and with
+//    setParallelCompile() the GL_KHR_parallel_shader_compile completion
+//    query reports "not done" for a given number of polls.
+//
+// Every call is counted by entry point name (e.g. "Uniform4fv").
+//
+struct GLMock
+{
+    // The mock table, for GLDispatch::set().
+    static const GLDispatch& dispatch();
+
+    // Forget all objects and counts and restore the default behaviour.
+    static void reset();
+
+    // Number of calls to an entry point, and to all entry points, since
+    // the last reset() or resetCalls().
+    static unsigned int calls(const std::string& name);
+    static unsigned int totalCalls();
+    static void resetCalls();
+
+    // The last value loaded into a uniform location of the current
+    // program.  Integer uniforms are converted to float.  Empty if never
+    // set.
+    static std::vector<float> uniform(int location);
+
+    // The contents of a buffer object, and the buffer bound to a uniform
+    // buffer binding point.
+    static std::vector<unsigned char> buffer(unsigned int buffer);
+    static unsigned int uniformBufferBinding(unsigned int index);
+
+    // Behaviour controls.
+    static void setLinkFailure(bool fail);
+    static void setParallelCompile(bool supported, unsigned int pollsToComplete = 0);
+    static void setBinaryFormats(int formats);
+    static void setDriverVersion(const std::string& version);
+};
+
+#endif // GL_MOCK_H_
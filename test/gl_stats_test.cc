@@ -0,0 +1,188 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <iostream>
+#include <string>
+#include <vector>
+#include "gl_mock.h"
+#include "libmatrix_test.h"
+#include "gl_stats_test.h"
+#include "../gl-stats.h"
+#include "../program.h"
+
+using LibMatrix::vec4;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+static const string vertexSource(
+    "attribute vec3 position;\n"
+    "uniform mat4 ModelViewProjection;\n"
+    "void main() { gl_Position = ModelViewProjection * vec4(position, 1.0); }\n");
+
+static const string fragmentSource(
+    "uniform vec4 Color;\n"
+    "void main() { gl_FragColor = Color; }\n");
+
+static void
+buildProgram(Program& program)
+{
+    program.init();
+    program.addShader(GL_VERTEX_SHADER, vertexSource);
+    program.addShader(GL_FRAGMENT_SHADER, fragmentSource);
+    program.build();
+}
+
+static uint64_t
+callCount(const GLStats::Snapshot& snapshot, const string& name)
+{
+    for (vector<GLStats::Call>::const_iterator callIt = snapshot.calls.begin();
+         callIt != snapshot.calls.end();
+         callIt++)
+    {
+        if (callIt->name == name)
+        {
+            return callIt->count;
+        }
+    }
+    return 0;
+}
+
+void
+GLStatsTestCounts::run(const Options& options)
+{
+    GLMock::reset();
+    GLStats::enable();
+    GLStats::reset();
+    // Enabling asks for the bound program, before anything is counted.
+    GLMock::resetCalls();
+
+    Program first;
+    buildProgram(first);
+    Program second;
+    buildProgram(second);
+    first.start();
+    first["Color"] = vec4(1.0, 0.0, 0.0, 1.0);
+    // Without the binding tracked, starting again binds again.
+    Program::forgetBinding();
+    first.start();
+    second.start();
+    second["Color"] = vec4(0.0, 1.0, 0.0, 1.0);
+    second["Color"] = vec4(0.0, 0.0, 1.0, 1.0);
+    second.stop();
+
+    GLStats::Snapshot snapshot(GLStats::snapshot());
+    GLStats::disable();
+    if (options.beVerbose())
+    {
+        snapshot.print(cout);
+    }
+
+    // The wrapper saw exactly what the mock did.
+    if (snapshot.totalCalls != GLMock::totalCalls() ||
+        callCount(snapshot, "UseProgram") != GLMock::calls("UseProgram") ||
+        callCount(snapshot, "Uniform4fv") != 3)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Call counts do not match the calls made" << endl;
+        }
+        return;
+    }
+
+    const GLStats::ProgramStats& a(snapshot.programs[first.handle()]);
+    const GLStats::ProgramStats& b(snapshot.programs[second.handle()]);
+    if (a.binds != 2 || a.redundantBinds != 1 || a.uniformUploads != 1 ||
+        b.binds != 1 || b.redundantBinds != 0 || b.uniformUploads != 2)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Calls were charged to the wrong program" << endl;
+        }
+        return;
+    }
+
+    // Reflection at link time looks up the location of each of the three
+    // active symbols once.
+    if (a.locationQueries != 3 || b.locationQueries != 3 ||
+        a.nanoseconds > snapshot.totalNanoseconds)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Wrong per-program totals" << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+GLStatsTestDisable::run(const Options& options)
+{
+    GLMock::reset();
+    const GLDispatch* table(&GLDispatch::get());
+    GLStats::enable();
+    bool wrapped(&GLDispatch::get() != table && GLStats::enabled());
+    GLStats::disable();
+    if (!wrapped || &GLDispatch::get() != table || GLStats::enabled())
+    {
+        if (options.beVerbose())
+        {
+            cout << "Dispatch table was not wrapped and restored" << endl;
+        }
+        return;
+    }
+
+    GLStats::reset();
+    Program program;
+    buildProgram(program);
+    program.start();
+    GLStats::Snapshot snapshot(GLStats::snapshot());
+    if (snapshot.totalCalls != 0 || !snapshot.programs.empty())
+    {
+        if (options.beVerbose())
+        {
+            cout << "Calls were counted while disabled" << endl;
+        }
+        return;
+    }
+
+    // The program bound before enabling is charged for uniform calls.
+    GLStats::enable();
+    GLStats::reset();
+    program["Color"] = vec4(1.0, 1.0, 1.0, 1.0);
+    snapshot = GLStats::snapshot();
+    if (snapshot.programs[program.handle()].uniformUploads != 1)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Uniform call was not charged to the program bound at enable()" << endl;
+        }
+        GLStats::disable();
+        return;
+    }
+
+    // A table installed in front of the wrapper stays in place.
+    GLDispatch front(GLDispatch::get());
+    GLDispatch::set(&front);
+    GLStats::disable();
+    bool kept(&GLDispatch::get() == &front && !GLStats::enabled());
+    GLDispatch::set(table);
+    if (!kept)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Disabling replaced a table installed after enable()" << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
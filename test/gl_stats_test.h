@@ -0,0 +1,29 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef GL_STATS_TEST_H_
+#define GL_STATS_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class GLStatsTestCounts : public MatrixTest
+{
+public:
+    GLStatsTestCounts() : MatrixTest("GLStats::counts") {}
+    virtual void run(const Options& options);
+};
+
+class GLStatsTestDisable : public MatrixTest
+{
+public:
+    GLStatsTestDisable() : MatrixTest("GLStats::disable") {}
+    virtual void run(const Options& options);
+};
+
+#endif // GL_STATS_TEST_H_
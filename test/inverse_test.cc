@@ -10,6 +10,8 @@
 //     Jesse Barker - original implementation.
 //
 #include <iostream>
+#include <limits>
+#include <math.h>
 #include "libmatrix_test.h"
 #include "inverse_test.h"
 #include "../mat.h"
@@ -17,6 +19,9 @@
 using LibMatrix::mat2;
 using LibMatrix::mat3;
 using LibMatrix::mat4;
+using LibMatrix::dmat4;
+using LibMatrix::tmat3;
+using LibMatrix::tmat4;
 using std::cout;
 using std::endl;
 
@@ -170,3 +175,198 @@ MatrixTest4x4Inverse::run(const Options& options)
     }
 }
 
+
+// Reference inverse by the textbook adjugate: each element is the signed
+// determinant of its own 3x3 minor, computed in extended precision.
+static tmat4<long double>
+reference_inverse(const tmat4<long double>& m)
+{
+    tmat4<long double> adj;
+    long double d(0);
+    for (int row = 0; row < 4; row++)
+    {
+        for (int col = 0; col < 4; col++)
+        {
+            long double e[9];
+            int n(0);
+            for (int j = 0; j < 4; j++)
+            {
+                for (int i = 0; i < 4; i++)
+                {
+                    if (i != row && j != col)
+                    {
+                        e[n++] = m[i][j];
+                    }
+                }
+            }
+            tmat3<long double> minor(e[0], e[1], e[2], e[3], e[4], e[5], e[6], e[7], e[8]);
+            long double cofactor(((row + col) % 2 ? -1 : 1) * minor.determinant());
+            adj[col][row] = cofactor;
+            if (row == 0)
+            {
+                d += m[0][col] * cofactor;
+            }
+        }
+    }
+    return adj / d;
+}
+
+// Largest absolute difference between the elements of two matrices.
+template<typename T>
+static long double
+max_error(const tmat4<T>& a, const tmat4<long double>& b)
+{
+    long double err(0);
+    for (int row = 0; row < 4; row++)
+    {
+        for (int col = 0; col < 4; col++)
+        {
+            err = std::max(err, fabsl(a[row][col] - b[row][col]));
+        }
+    }
+    return err;
+}
+
+// A well-conditioned, but otherwise unremarkable, projective matrix.
+template<typename T>
+static tmat4<T>
+test_matrix()
+{
+    static const int values[16] = {
+        4, -2, 1, 3,
+        1, 5, -1, 2,
+        -3, 1, 6, -2,
+        2, 1, -1, 7,
+    };
+    tmat4<T> m;
+    for (int i = 0; i < 16; i++)
+    {
+        m[i / 4][i % 4] = values[i] / static_cast<T>(4);
+    }
+    return m;
+}
+
+template<typename T>
+static tmat4<long double>
+widen(const tmat4<T>& m)
+{
+    tmat4<long double> w;
+    for (int row = 0; row < 4; row++)
+    {
+        for (int col = 0; col < 4; col++)
+        {
+            w[row][col] = m[row][col];
+        }
+    }
+    return w;
+}
+
+void
+MatrixTest4x4InverseAccuracy::run(const Options& options)
+{
+    const tmat4<long double> expected(reference_inverse(test_matrix<long double>()));
+
+    mat4 f(test_matrix<float>());
+    f.inverse();
+    dmat4 d(test_matrix<double>());
+    d.inverse();
+    tmat4<long double> ld(test_matrix<long double>());
+    ld.inverse();
+
+    long double ferr(max_error(f, expected));
+    long double derr(max_error(d, expected));
+    long double lderr(max_error(ld, expected));
+    if (options.beVerbose())
+    {
+        cout << std::scientific << "Largest error against the reference inverse: float " << ferr
+             << ", double " << derr << ", long double " << lderr << endl;
+    }
+
+    // The determinants of a matrix and its inverse are reciprocal.
+    tmat4<long double> m(test_matrix<long double>());
+    tmat4<long double> mi(expected);
+    long double deterr(fabsl(m.determinant() * mi.determinant() - 1));
+
+    // long double may be no wider than double (e.g. MSVC, Apple arm64), so
+    // allow it a few ulps of whatever precision it has.
+    const long double ldtolerance(64 * std::numeric_limits<long double>::epsilon());
+    if (ferr < 1e-5 && derr < 1e-13 && lderr < ldtolerance && deterr < ldtolerance)
+    {
+        pass_ = true;
+    }
+}
+
+void
+MatrixTest4x4InverseAffine::run(const Options& options)
+{
+    mat4 m(LibMatrix::Mat4::translate(2.0, -3.0, 0.5));
+    m *= LibMatrix::Mat4::rotate(75.0, 1.0, 2.0, 3.0);
+    m *= LibMatrix::Mat4::scale(0.5, 2.0, 4.0);
+    // Add some shear as well.
+    m[0][1] += 0.25;
+
+    mat4 mi(m);
+    mi.inverse_affine();
+    long double err(max_error(mi, reference_inverse(widen(m))));
+    if (options.beVerbose())
+    {
+        cout << std::scientific << "Largest error of affine inverse: " << err << endl;
+        mi.print();
+    }
+
+    if (err < 1e-5 && mi[3][0] == 0 && mi[3][1] == 0 && mi[3][2] == 0 && mi[3][3] == 1)
+    {
+        pass_ = true;
+    }
+}
+
+void
+MatrixTest4x4InverseRigid::run(const Options& options)
+{
+    mat4 m(LibMatrix::Mat4::lookAt(3.0, 1.0, -2.0, 0.0, 0.5, 0.0, 0.0, 1.0, 0.0));
+
+    mat4 mi(m);
+    mi.inverse_rigid();
+    long double err(max_error(mi, reference_inverse(widen(m))));
+    if (options.beVerbose())
+    {
+        cout << std::scientific << "Largest error of rigid inverse: " << err << endl;
+        mi.print();
+    }
+
+    if (err < 1e-5)
+    {
+        pass_ = true;
+    }
+}
+
+void
+MatrixTest4x4InverseTranspose::run(const Options& options)
+{
+    mat4 m(LibMatrix::Mat4::rotate(30.0, 0.0, 1.0, 0.0));
+    m *= LibMatrix::Mat4::scale(1.0, 3.0, 0.25);
+    m[2][0] += 0.5;
+
+    mat3 n(m.inverse_transpose3x3());
+    tmat4<long double> expected(reference_inverse(widen(m)));
+    expected.transpose();
+
+    long double err(0);
+    for (int row = 0; row < 3; row++)
+    {
+        for (int col = 0; col < 3; col++)
+        {
+            err = std::max(err, fabsl(n[row][col] - expected[row][col]));
+        }
+    }
+    if (options.beVerbose())
+    {
+        cout << std::scientific << "Largest error of inverse transpose: " << err << endl;
+        n.print();
+    }
+
+    if (err < 1e-5)
+    {
+        pass_ = true;
+    }
+}
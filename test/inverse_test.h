@@ -36,4 +36,32 @@ public:
     virtual void run(const Options& options);
 };
 
+class MatrixTest4x4InverseAccuracy : public MatrixTest
+{
+public:
+    MatrixTest4x4InverseAccuracy() : MatrixTest("mat4::inverse::accuracy") {}
+    virtual void run(const Options& options);
+};
+
+class MatrixTest4x4InverseAffine : public MatrixTest
+{
+public:
+    MatrixTest4x4InverseAffine() : MatrixTest("mat4::inverse_affine") {}
+    virtual void run(const Options& options);
+};
+
+class MatrixTest4x4InverseRigid : public MatrixTest
+{
+public:
+    MatrixTest4x4InverseRigid() : MatrixTest("mat4::inverse_rigid") {}
+    virtual void run(const Options& options);
+};
+
+class MatrixTest4x4InverseTranspose : public MatrixTest
+{
+public:
+    MatrixTest4x4InverseTranspose() : MatrixTest("mat4::inverse_transpose3x3") {}
+    virtual void run(const Options& options);
+};
+
 #endif // INVERSE_TEST_H_
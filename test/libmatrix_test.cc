@@ -14,10 +14,24 @@
 #include <string>
 #include <vector>
 #include "libmatrix_test.h"
+#include "gl_mock.h"
 #include "inverse_test.h"
 #include "transpose_test.h"
+#include "multiply_test.h"
+#include "affine_test.h"
+#include "simd_test.h"
+#include "transform_test.h"
+#include "soa_test.h"
+#include "expr_test.h"
+#include "quat_test.h"
+#include "stack_test.h"
+#include "uniform_block_test.h"
+#include "program_test.h"
+#include "gl_stats_test.h"
 #include "const_vec_test.h"
 #include "shader_source_test.h"
+#include "shader_permutations_test.h"
+#include "shader_template_test.h"
 #include "util_split_test.h"
 
 using std::cerr;
@@ -35,15 +49,64 @@ main(int argc, char** argv)
         return 0;
     }
 
+    // There is no GL in the test program, so make all GL calls to the mock.
+    GLDispatch::set(&GLMock::dispatch());
+
     using std::vector;
     vector<MatrixTest*> testVec;
     testVec.push_back(new MatrixTest2x2Inverse());
     testVec.push_back(new MatrixTest3x3Inverse());
     testVec.push_back(new MatrixTest4x4Inverse());
+    testVec.push_back(new MatrixTest4x4InverseAccuracy());
+    testVec.push_back(new MatrixTest4x4InverseAffine());
+    testVec.push_back(new MatrixTest4x4InverseRigid());
+    testVec.push_back(new MatrixTest4x4InverseTranspose());
     testVec.push_back(new MatrixTest2x2Transpose());
     testVec.push_back(new MatrixTest3x3Transpose());
     testVec.push_back(new MatrixTest4x4Transpose());
+    testVec.push_back(new MatrixTest4x4Multiply());
+    testVec.push_back(new MatrixTest4x4MultiplyDouble());
+    testVec.push_back(new AffineTestMultiply());
+    testVec.push_back(new AffineTestInverse());
+    testVec.push_back(new AffineTestTransform());
+    testVec.push_back(new SimdTestDispatch());
+    testVec.push_back(new TransformTestBatch());
+    testVec.push_back(new TransformTestStrided());
+    testVec.push_back(new TransformTestThreaded());
+    testVec.push_back(new SoaTestConvert());
+    testVec.push_back(new SoaTestKernels());
+    testVec.push_back(new ExprTestVec3());
+    testVec.push_back(new ExprTestVec4());
+    testVec.push_back(new QuatTestMatrix());
+    testVec.push_back(new QuatTestSlerp());
+    testVec.push_back(new QuatTestDual());
+    testVec.push_back(new StackTestFixed());
+    testVec.push_back(new StackTestLazy());
+    testVec.push_back(new UniformBlockTestLayout());
+    testVec.push_back(new UniformBlockTestPack());
+    testVec.push_back(new ProgramTestBuild());
+    testVec.push_back(new ProgramTestSymbols());
+    testVec.push_back(new ProgramTestMove());
+    testVec.push_back(new ProgramTestUniformCache());
+    testVec.push_back(new ProgramTestStaging());
+    testVec.push_back(new ProgramTestStagingThreads());
+    testVec.push_back(new ProgramTestAsync());
+    testVec.push_back(new ProgramTestBinaryCache());
+    testVec.push_back(new ProgramTestUniformBuffer());
+    testVec.push_back(new ProgramTestBinding());
+    testVec.push_back(new ProgramTestUniformOverhead());
+    testVec.push_back(new GLStatsTestCounts());
+    testVec.push_back(new GLStatsTestDisable());
     testVec.push_back(new ShaderSourceBasic());
+    testVec.push_back(new ShaderSourceAddConstGlobal());
+    testVec.push_back(new ShaderSourceConstFormat());
+    testVec.push_back(new ShaderSourceEdits());
+    testVec.push_back(new ShaderSourceReplaceAll());
+    testVec.push_back(new ShaderSourceInterleaved());
+    testVec.push_back(new ShaderPermutationsTestExpand());
+    testVec.push_back(new ShaderPermutationsTestThreads());
+    testVec.push_back(new ShaderTemplateTestInstance());
+    testVec.push_back(new ShaderTemplateTestVariants());
     testVec.push_back(new UtilSplitTestNormal());
     testVec.push_back(new UtilSplitTestQuoted());
 
@@ -12,6 +12,9 @@
 #ifndef LIBMATRIX_TEST_H_
 #define LIBMATRIX_TEST_H_
 
+#include <math.h>
+#include <type_traits>
+
 class Options
 {
     Options();
@@ -48,4 +51,49 @@ public:
     const bool passed() const { return pass_; }
 };
 
+//
+// Compare results with a tolerance.  Elements are close when they differ by
+// no more than 'tolerance', scaled up by the magnitude of the expected value
+// 'b' once that is past one.  This works on scalars, on arrays of them, and
+// on the vector and matrix types, which are compared element by element.
+// The result 'a' is converted to the type of 'b' if need be (e.g. from an
+// element proxy of an SoA array).
+//
+template<typename T>
+bool
+close(const T* a, const T* b, unsigned int count, double tolerance = 1e-5)
+{
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (fabs(a[i] - b[i]) > tolerance * (1 + fabs(b[i])))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+    requires (!std::is_array_v<T>)
+bool
+close(const std::type_identity_t<T>& a, const T& b, double tolerance = 1e-5)
+{
+    if constexpr (std::is_arithmetic_v<T>)
+    {
+        return close(&a, &b, 1, tolerance);
+    }
+    else if constexpr (std::is_convertible_v<const T&, const double*>)
+    {
+        static_assert(sizeof(T) % sizeof(double) == 0, "padded vector or matrix");
+        return close(static_cast<const double*>(a), static_cast<const double*>(b),
+                     sizeof(T) / sizeof(double), tolerance);
+    }
+    else
+    {
+        static_assert(sizeof(T) % sizeof(float) == 0, "padded vector or matrix");
+        return close(static_cast<const float*>(a), static_cast<const float*>(b),
+                     sizeof(T) / sizeof(float), tolerance);
+    }
+}
+
 #endif // LIBMATRIX_TEST_H_
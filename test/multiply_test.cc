@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <iostream>
+#include "libmatrix_test.h"
+#include "multiply_test.h"
+#include "../mat.h"
+
+using LibMatrix::tmat4;
+using LibMatrix::mat4;
+using LibMatrix::dmat4;
+using std::cout;
+using std::endl;
+
+// Fill a matrix with small, distinct integral values so that the products
+// are exact regardless of whether the kernels fuse multiply and add.
+template<typename T>
+static void
+fill(tmat4<T>& m, int seed)
+{
+    for (unsigned int row = 0; row < 4; row++)
+    {
+        for (unsigned int col = 0; col < 4; col++)
+        {
+            m[row][col] = static_cast<T>(((row * 4 + col + seed) % 7) - 3);
+        }
+    }
+}
+
+// Straightforward row-by-column product to check the kernels against.
+template<typename T>
+static tmat4<T>
+reference(const tmat4<T>& a, const tmat4<T>& b)
+{
+    tmat4<T> product;
+    for (unsigned int row = 0; row < 4; row++)
+    {
+        for (unsigned int col = 0; col < 4; col++)
+        {
+            T sum(0);
+            for (unsigned int k = 0; k < 4; k++)
+            {
+                sum += a[row][k] * b[k][col];
+            }
+            product[row][col] = sum;
+        }
+    }
+    return product;
+}
+
+template<typename T>
+static bool
+check_multiply(const Options& options)
+{
+    tmat4<T> a;
+    tmat4<T> b;
+    fill(a, 1);
+    fill(b, 5);
+
+    tmat4<T> expected(reference(a, b));
+    tmat4<T> product(a * b);
+
+    if (options.beVerbose())
+    {
+        cout << "Product of the kernel: " << endl << endl;
+        product.print();
+        cout << endl << "Reference product: " << endl << endl;
+        expected.print();
+    }
+
+    if (product != expected)
+    {
+        return false;
+    }
+
+    // Multiplying a matrix by itself in place exercises aliasing of all
+    // three kernel operands.
+    tmat4<T> square(a);
+    square *= square;
+    if (square != reference(a, a))
+    {
+        return false;
+    }
+
+    // Multiplying by the identity must leave the matrix unchanged.
+    tmat4<T> ident;
+    tmat4<T> same(a);
+    same *= ident;
+    return same == a;
+}
+
+void
+MatrixTest4x4Multiply::run(const Options& options)
+{
+    pass_ = check_multiply<float>(options);
+}
+
+void
+MatrixTest4x4MultiplyDouble::run(const Options& options)
+{
+    pass_ = check_multiply<double>(options);
+}
@@ -0,0 +1,632 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gl_mock.h"
+#include "libmatrix_test.h"
+#include "program_test.h"
+#include "../program.h"
+#include "../util.h"
+
+using LibMatrix::mat4;
+using LibMatrix::vec4;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+// Uniform locations, as handed out by the mock in declaration order:
+// ModelViewProjection 0, NormalMatrix 1, LightColor 2, Lights 3 to 6,
+// Shininess 7, Texture 8.
+static const string vertexSource(
+    "attribute vec3 position;\n"
+    "attribute vec3 normal;\n"
+    "uniform mat4 ModelViewProjection;\n"
+    "uniform mat3 NormalMatrix;\n"
+    "void main() { gl_Position = ModelViewProjection * vec4(position, 1.0); }\n");
+
+static const string fragmentSource(
+    "uniform vec4 LightColor;\n"
+    "uniform vec4 Lights[4];\n"
+    "uniform float Shininess;\n"
+    "uniform sampler2D Texture;\n"
+    "void main() { gl_FragColor = LightColor * Lights[0] * Shininess; }\n");
+
+static const unsigned int activeSymbols(8);
+
+// Report a failed check (in verbose mode).  Returns the condition.
+static bool
+check(const Options& options, bool condition, const string& what)
+{
+    if (!condition && options.beVerbose())
+    {
+        cout << what << endl;
+    }
+    return condition;
+}
+
+static void
+addShaders(Program& program)
+{
+    program.addShader(GL_VERTEX_SHADER, vertexSource);
+    program.addShader(GL_FRAGMENT_SHADER, fragmentSource);
+}
+
+static bool
+uniformIs(int location, const float* expected, unsigned int size)
+{
+    vector<float> actual(GLMock::uniform(location));
+    return actual == vector<float>(expected, expected + size);
+}
+
+void
+ProgramTestBuild::run(const Options& options)
+{
+    GLMock::reset();
+    Program program;
+    program.init();
+    addShaders(program);
+    program.build();
+    if (!check(options, program.ready(), "Program did not build: " + program.errorMessage()) ||
+        !check(options, program.numSymbols() == activeSymbols, "Wrong number of active symbols"))
+    {
+        return;
+    }
+
+    Program broken;
+    broken.init();
+    broken.addShader(GL_VERTEX_SHADER, "#error\n" + vertexSource);
+    if (!check(options, !broken.valid() &&
+               broken.errorMessage().find("#error") != string::npos,
+               "Compile failure was not reported"))
+    {
+        return;
+    }
+
+    GLMock::setLinkFailure(true);
+    Program unlinked;
+    unlinked.init();
+    addShaders(unlinked);
+    unlinked.build();
+    if (!check(options, !unlinked.ready() &&
+               unlinked.errorMessage().find("link") != string::npos,
+               "Link failure was not reported"))
+    {
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+ProgramTestSymbols::run(const Options& options)
+{
+    GLMock::reset();
+    Program program;
+    program.init();
+    addShaders(program);
+    program.build();
+
+    // Everything active was found at link time, so lookups make no GL
+    // queries at all.
+    GLMock::resetCalls();
+    unsigned int mvp(program.getHandle("ModelViewProjection"));
+    Program::Symbol& lights(program["Lights"]);
+    Program::Symbol& position(program["position"]);
+    if (!check(options, GLMock::totalCalls() == 0, "Symbol lookup queried GL") ||
+        !check(options, program[mvp].location() == 0 &&
+               program[mvp].dataType() == GL_FLOAT_MAT4, "Wrong ModelViewProjection symbol") ||
+        !check(options, lights.location() == 3 && lights.count() == 4 &&
+               lights.symbolType() == Program::Symbol::Uniform, "Wrong Lights symbol") ||
+        !check(options, &program["Lights[0]"] == &lights, "Array names do not match") ||
+        !check(options, position.symbolType() == Program::Symbol::Attribute,
+               "Wrong position symbol"))
+    {
+        return;
+    }
+
+    // An unknown name falls back to GL, and is then ignored.
+    program.start();
+    Program::Symbol& missing(program["Missing"]);
+    GLMock::resetCalls();
+    missing = 1.0f;
+    if (!check(options, missing.symbolType() == Program::Symbol::None &&
+               GLMock::totalCalls() == 0, "Unknown symbol was not ignored"))
+    {
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+ProgramTestMove::run(const Options& options)
+{
+    GLMock::reset();
+    Program program;
+    program.init();
+    addShaders(program);
+    program.build();
+
+    // Symbols stay put as more are added, well past one block's worth.
+    Program::Symbol& mvp(program["ModelViewProjection"]);
+    for (unsigned int i = 0; i < 100; i++)
+    {
+        program["Missing" + std::to_string(i)];
+    }
+    if (!check(options, &program["ModelViewProjection"] == &mvp &&
+               mvp.name() == "ModelViewProjection" &&
+               program.numSymbols() == activeSymbols + 100 &&
+               program[program.getHandle("Missing99")].name() == "Missing99",
+               "Symbols moved or were lost as more were added"))
+    {
+        return;
+    }
+
+    // Moving a program hands over the GL object and the symbols as they
+    // are.
+    unsigned int handle(program.handle());
+    Program moved(std::move(program));
+    Program assigned;
+    assigned = std::move(moved);
+    if (!check(options, assigned.ready() && assigned.handle() == handle &&
+               &assigned["ModelViewProjection"] == &mvp, "Move did not keep the symbols") ||
+        !check(options, !program.valid() && program.handle() == 0 &&
+               program.numSymbols() == 0 && !moved.valid(),
+               "Moved-from program was not left empty"))
+    {
+        return;
+    }
+
+    assigned.start();
+    mat4 m;
+    m[1][2] = 3.0;
+    mvp = m;
+    assigned.release();
+    if (!check(options, GLMock::calls("DeleteProgram") == 1 &&
+               GLMock::calls("UniformMatrix4fv") == 1, "Moved program was mishandled"))
+    {
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+ProgramTestUniformCache::run(const Options& options)
+{
+    GLMock::reset();
+    Program program;
+    program.init();
+    addShaders(program);
+    program.build();
+    program.start();
+
+    Program::Symbol& mvp(program["ModelViewProjection"]);
+    mat4 m;
+    m[0][3] = 5.0;
+    mvp = m;
+    mvp = m;
+    if (!check(options, GLMock::calls("UniformMatrix4fv") == 1 &&
+               mvp.issuedUploads() == 1 && mvp.skippedUploads() == 1,
+               "Repeated value was uploaded again") ||
+        !check(options, uniformIs(0, m, 16), "Wrong matrix uploaded"))
+    {
+        return;
+    }
+
+    m[0][3] = 6.0;
+    mvp = m;
+    mvp.invalidate();
+    mvp = m;
+    if (!check(options, GLMock::calls("UniformMatrix4fv") == 3,
+               "Changed or invalidated value was not uploaded"))
+    {
+        return;
+    }
+
+    // Different types with the same bits are still different values.
+    Program::Symbol& texture(program["Texture"]);
+    texture = 0;
+    texture = 0.0f;
+    if (!check(options, GLMock::calls("Uniform1i") == 1 &&
+               GLMock::calls("Uniform1f") == 1, "Value types were confused"))
+    {
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+ProgramTestStaging::run(const Options& options)
+{
+    GLMock::reset();
+    Program program;
+    program.init();
+    addShaders(program);
+    program.build();
+
+    unsigned int lights(program.getHandle("Lights"));
+    unsigned int shininess(program.getHandle("Shininess"));
+    unsigned int mvp(program.getHandle("ModelViewProjection"));
+    vec4 first(1.0, 2.0, 3.0, 4.0);
+    vec4 second(5.0, 6.0, 7.0, 8.0);
+
+    // None of this touches GL.
+    GLMock::resetCalls();
+    program.stage(lights, first, 1);
+    program.stage(lights, second, 3);
+    program.stage(lights, second, 4);     // out of range
+    program.stage(mvp, first);            // wrong type
+    program.stage(shininess, 8.0f);
+    if (!check(options, GLMock::totalCalls() == 0, "Staging made GL calls"))
+    {
+        return;
+    }
+
+    // Elements 1 and 3 of Lights go in separate calls, leaving element 2
+    // alone.
+    program.start();
+    const float shininessValue(8.0);
+    if (!check(options, GLMock::calls("Uniform4fv") == 2 &&
+               GLMock::calls("Uniform1fv") == 1 &&
+               GLMock::calls("UniformMatrix4fv") == 0, "Wrong calls to flush staging") ||
+        !check(options, uniformIs(4, first, 4) && uniformIs(6, second, 4) &&
+               GLMock::uniform(5).empty() && GLMock::uniform(3).empty() &&
+               uniformIs(7, &shininessValue, 1), "Wrong staged values"))
+    {
+        return;
+    }
+
+    // Neighbouring elements go in one call.
+    GLMock::resetCalls();
+    program.stage(lights, second, 1);
+    program.stage(lights, first, 2);
+    program.flush();
+    if (!check(options, GLMock::calls("Uniform4fv") == 1, "Neighbouring elements not merged") ||
+        !check(options, uniformIs(4, second, 4) && uniformIs(5, first, 4) &&
+               uniformIs(6, second, 4), "Wrong merged values"))
+    {
+        return;
+    }
+
+    GLMock::resetCalls();
+    program.flush();
+    if (!check(options, GLMock::totalCalls() == 0, "Flush repeated staged values"))
+    {
+        return;
+    }
+
+    pass_ = true;
+}
+
+//
+// One thread stages values while another keeps flushing them, as when the
+// next frame is set up on a worker during rendering.  Every value staged
+// is either sent by a flush or superseded by a later one, so the last
+// values staged must be the ones GL ends up with.
+//
+void
+ProgramTestStagingThreads::run(const Options& options)
+{
+    GLMock::reset();
+    Program program;
+    program.init();
+    addShaders(program);
+    program.build();
+    program.start();
+
+    unsigned int lights(program.getHandle("Lights"));
+    unsigned int shininess(program.getHandle("Shininess"));
+    static const unsigned int rounds(10000);
+    std::atomic<bool> done(false);
+    std::thread worker([&]()
+    {
+        for (unsigned int n = 1; n <= rounds; n++)
+        {
+            float f(static_cast<float>(n));
+            for (unsigned int i = 0; i < 4; i++)
+            {
+                program.stage(lights, vec4(f, f, f, f), i);
+            }
+            program.stage(shininess, f);
+        }
+        done = true;
+    });
+    unsigned int flushes(0);
+    while (!done)
+    {
+        program.flush();
+        flushes++;
+    }
+    worker.join();
+    program.flush();
+
+    const float last(static_cast<float>(rounds));
+    const vec4 lastLight(last, last, last, last);
+    if (options.beVerbose())
+    {
+        cout << flushes << " flushes during staging" << endl;
+    }
+    if (!check(options, uniformIs(3, lastLight, 4) && uniformIs(4, lastLight, 4) &&
+               uniformIs(5, lastLight, 4) && uniformIs(6, lastLight, 4) &&
+               uniformIs(7, &last, 1), "Lost the last staged values"))
+    {
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+ProgramTestAsync::run(const Options& options)
+{
+    GLMock::reset();
+    GLMock::setParallelCompile(true, 2);
+    Program program;
+    program.init();
+    program.setAsyncBuild(true);
+    addShaders(program);
+    if (!check(options, GLMock::calls("CompileShader") == 0, "addShader compiled"))
+    {
+        return;
+    }
+
+    program.buildAsync();
+    if (!check(options, GLMock::calls("CompileShader") == 2 &&
+               GLMock::calls("LinkProgram") == 1, "Shaders were not submitted") ||
+        !check(options, program.poll() == Program::BuildPending, "Build finished too soon") ||
+        !check(options, program.poll() == Program::BuildReady && program.ready() &&
+               program.numSymbols() == activeSymbols, "Build did not finish"))
+    {
+        return;
+    }
+
+    GLMock::setParallelCompile(false);
+    Program broken;
+    broken.init();
+    broken.setAsyncBuild(true);
+    broken.addShader(GL_VERTEX_SHADER, vertexSource);
+    broken.addShader(GL_FRAGMENT_SHADER, "#error\n" + fragmentSource);
+    broken.buildAsync();
+    if (!check(options, broken.poll() == Program::BuildFailed &&
+               broken.errorMessage().find("#error") != string::npos,
+               "Async compile failure was not reported"))
+    {
+        return;
+    }
+
+    pass_ = true;
+}
+
+// Count the entries in the cache directory.
+static unsigned int
+cacheEntries(const std::filesystem::path& dir)
+{
+    unsigned int entries(0);
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(dir))
+    {
+        if (entry.is_regular_file())
+        {
+            entries++;
+        }
+    }
+    return entries;
+}
+
+static bool
+buildCached(Program& program, const std::filesystem::path& dir)
+{
+    program.setBinaryCache(dir.string());
+    program.init();
+    addShaders(program);
+    program.build();
+    return program.ready();
+}
+
+void
+ProgramTestBinaryCache::run(const Options& options)
+{
+    GLMock::reset();
+    std::filesystem::path dir(std::filesystem::temp_directory_path() /
+        ("libmatrix-test-" + Util::toString(Util::get_timestamp_us())));
+
+    // Miss, then hit.
+    Program first;
+    bool ok(check(options, buildCached(first, dir) && !first.fromBinaryCache() &&
+                  GLMock::calls("CompileShader") == 2 && cacheEntries(dir) == 1,
+                  "First build was not compiled and cached"));
+    GLMock::resetCalls();
+    Program second;
+    ok = ok && check(options, buildCached(second, dir) && second.fromBinaryCache() &&
+                     GLMock::calls("CompileShader") == 0 &&
+                     second.numSymbols() == activeSymbols,
+                     "Second build did not come from the cache");
+
+    // A corrupt entry is rebuilt from source and replaced.
+    if (ok)
+    {
+        std::filesystem::path entry(std::filesystem::directory_iterator(dir)->path());
+        std::ofstream(entry.string().c_str(), std::ios::binary) << "garbage";
+        Program third;
+        Program fourth;
+        ok = check(options, buildCached(third, dir) && !third.fromBinaryCache(),
+                   "Corrupt cache entry was used") &&
+             check(options, buildCached(fourth, dir) && fourth.fromBinaryCache(),
+                   "Corrupt cache entry was not replaced");
+    }
+
+    // A new driver misses the cache.
+    GLMock::setDriverVersion("2.0 mock");
+    Program fifth;
+    ok = ok && check(options, buildCached(fifth, dir) && !fifth.fromBinaryCache() &&
+                     cacheEntries(dir) == 2, "Driver change did not miss the cache");
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    pass_ = ok;
+}
+
+void
+ProgramTestUniformBuffer::run(const Options& options)
+{
+    GLMock::reset();
+    UniformBuffer buffer;
+    buffer.init(16, 2);
+    const unsigned char a[16] = { 1 };
+    const unsigned char b[16] = { 2 };
+
+    buffer.update(a);
+    buffer.bind(3);
+    unsigned int firstCopy(GLMock::uniformBufferBinding(3));
+    buffer.update(b);
+    buffer.bind(3);
+    unsigned int secondCopy(GLMock::uniformBufferBinding(3));
+    if (!check(options, firstCopy != secondCopy, "Updates did not alternate copies") ||
+        !check(options, GLMock::buffer(firstCopy) == vector<unsigned char>(a, a + 16) &&
+               GLMock::buffer(secondCopy) == vector<unsigned char>(b, b + 16),
+               "Wrong buffer contents"))
+    {
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+ProgramTestBinding::run(const Options& options)
+{
+    GLMock::reset();
+    Program first;
+    first.init();
+    addShaders(first);
+    first.build();
+    Program second;
+    second.init();
+    addShaders(second);
+    second.build();
+
+    // Starting a bound program, or stopping when nothing is bound, makes
+    // no GL call.
+    Program::resetBindCounts();
+    first.start();
+    first.start();
+    first.stop();
+    first.stop();
+    if (!check(options, GLMock::calls("UseProgram") == 2 &&
+               Program::issuedBinds() == 2 && Program::skippedBinds() == 2,
+               "Redundant binds were issued"))
+    {
+        return;
+    }
+
+    // Lazily, stop() leaves the program bound until another one replaces
+    // it, or it is explicitly unbound.
+    Program::setLazyUnbind(true);
+    GLMock::resetCalls();
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        first.start();
+        first.stop();
+    }
+    second.start();
+    second.stop();
+    Program::unbind();
+    Program::setLazyUnbind(false);
+    if (!check(options, GLMock::calls("UseProgram") == 3, "Lazy unbinding issued binds"))
+    {
+        return;
+    }
+
+    // A released program's name is not taken to be bound any more, and
+    // forgetBinding() makes the next start() bind again.
+    first.start();
+    first.release();
+    first.init();
+    addShaders(first);
+    first.build();
+    GLMock::resetCalls();
+    first.start();
+    Program::forgetBinding();
+    first.start();
+    first.stop();
+    if (!check(options, GLMock::calls("UseProgram") == 3,
+               "Stale binding survived release"))
+    {
+        return;
+    }
+
+    pass_ = true;
+}
+
+//
+// Not so much a test as a measurement of the CPU cost of uniform updates
+// through Program, with the mock standing in for the driver.  Run with
+// --verbose to see the numbers.
+//
+void
+ProgramTestUniformOverhead::run(const Options& options)
+{
+    GLMock::reset();
+    Program program;
+    program.init();
+    addShaders(program);
+    program.build();
+    program.start();
+
+    const unsigned int iterations(100000);
+    unsigned int mvp(program.getHandle("ModelViewProjection"));
+    mat4 m;
+
+    uint64_t start(Util::get_timestamp_us());
+    for (unsigned int i = 0; i < iterations; i++)
+    {
+        program["ModelViewProjection"] = m;
+    }
+    uint64_t byName(Util::get_timestamp_us() - start);
+
+    start = Util::get_timestamp_us();
+    for (unsigned int i = 0; i < iterations; i++)
+    {
+        program[mvp] = m;
+    }
+    uint64_t byHandle(Util::get_timestamp_us() - start);
+
+    start = Util::get_timestamp_us();
+    for (unsigned int i = 0; i < iterations; i++)
+    {
+        m[0][0] = static_cast<float>(i);
+        program[mvp] = m;
+    }
+    uint64_t changing(Util::get_timestamp_us() - start);
+
+    if (options.beVerbose())
+    {
+        cout << std::fixed << std::setprecision(1);
+        cout << "Unchanged mat4 by name:   " << byName * 1000.0 / iterations << " ns" << endl;
+        cout << "Unchanged mat4 by handle: " << byHandle * 1000.0 / iterations << " ns" << endl;
+        cout << "Changing mat4 by handle:  " << changing * 1000.0 / iterations << " ns" << endl;
+    }
+
+    if (!check(options, GLMock::calls("UniformMatrix4fv") == iterations + 1 &&
+               program[mvp].skippedUploads() == 2 * iterations - 1,
+               "Unexpected number of uploads"))
+    {
+        return;
+    }
+
+    pass_ = true;
+}
@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef PROGRAM_TEST_H_
+#define PROGRAM_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class ProgramTestBuild : public MatrixTest
+{
+public:
+    ProgramTestBuild() : MatrixTest("Program::build") {}
+    virtual void run(const Options& options);
+};
+
+class ProgramTestSymbols : public MatrixTest
+{
+public:
+    ProgramTestSymbols() : MatrixTest("Program::symbols") {}
+    virtual void run(const Options& options);
+};
+
+class ProgramTestMove : public MatrixTest
+{
+public:
+    ProgramTestMove() : MatrixTest("Program::move") {}
+    virtual void run(const Options& options);
+};
+
+class ProgramTestUniformCache : public MatrixTest
+{
+public:
+    ProgramTestUniformCache() : MatrixTest("Program::uniform_cache") {}
+    virtual void run(const Options& options);
+};
+
+class ProgramTestStaging : public MatrixTest
+{
+public:
+    ProgramTestStaging() : MatrixTest("Program::staging") {}
+    virtual void run(const Options& options);
+};
+
+class ProgramTestStagingThreads : public MatrixTest
+{
+public:
+    ProgramTestStagingThreads() : MatrixTest("Program::staging_threads") {}
+    virtual void run(const Options& options);
+};
+
+class ProgramTestAsync : public MatrixTest
+{
+public:
+    ProgramTestAsync() : MatrixTest("Program::async") {}
+    virtual void run(const Options& options);
+};
+
+class ProgramTestBinaryCache : public MatrixTest
+{
+public:
+    ProgramTestBinaryCache() : MatrixTest("Program::binary_cache") {}
+    virtual void run(const Options& options);
+};
+
+class ProgramTestUniformBuffer : public MatrixTest
+{
+public:
+    ProgramTestUniformBuffer() : MatrixTest("UniformBuffer::update") {}
+    virtual void run(const Options& options);
+};
+
+class ProgramTestBinding : public MatrixTest
+{
+public:
+    ProgramTestBinding() : MatrixTest("Program::binding") {}
+    virtual void run(const Options& options);
+};
+
+class ProgramTestUniformOverhead : public MatrixTest
+{
+public:
+    ProgramTestUniformOverhead() : MatrixTest("Program::uniform_overhead") {}
+    virtual void run(const Options& options);
+};
+
+#endif // PROGRAM_TEST_H_
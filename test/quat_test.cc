@@ -0,0 +1,229 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <iostream>
+#include <vector>
+#include <math.h>
+#include "libmatrix_test.h"
+#include "quat_test.h"
+#include "../quat.h"
+
+using LibMatrix::mat3;
+using LibMatrix::mat4;
+using LibMatrix::quat;
+using LibMatrix::dquat;
+using LibMatrix::dualquat;
+using LibMatrix::vec3;
+using LibMatrix::vec4;
+using std::cout;
+using std::endl;
+using std::vector;
+
+// q and -q are the same rotation.
+static bool
+same_rotation(const quat& a, const quat& b, double tolerance = 1e-5)
+{
+    return 1 - fabs(quat::dot(a, b)) < tolerance;
+}
+
+void
+QuatTestMatrix::run(const Options& options)
+{
+    // Angles past 180 degrees exercise every branch of the matrix
+    // conversion.
+    static const float angles[] = { 0.0, 30.0, 90.0, 179.0, 200.0, 300.0 };
+    static const vec3 axes[] = {
+        vec3(1.0, 0.0, 0.0), vec3(0.0, 1.0, 0.0), vec3(0.0, 0.0, 1.0),
+        vec3(1.0, 2.0, -3.0),
+    };
+
+    for (float angle : angles)
+    {
+        for (const vec3& axis : axes)
+        {
+            quat q(LibMatrix::Quat::rotate(angle, axis.x(), axis.y(), axis.z()));
+            mat4 m(LibMatrix::Mat4::rotate(angle, axis.x(), axis.y(), axis.z()));
+            if (!close(q.to_mat4(), m) || !same_rotation(quat(m), q))
+            {
+                if (options.beVerbose())
+                {
+                    cout << "Rotation of " << angle << " degrees converts wrongly" << endl;
+                    q.print();
+                    quat(m).print();
+                }
+                return;
+            }
+
+            const vec3 v(0.5, -1.0, 2.0);
+            vec4 expected(m * vec4(v, 0.0f));
+            if (!close(q.rotate(v), vec3(expected.x(), expected.y(), expected.z())))
+            {
+                if (options.beVerbose())
+                {
+                    cout << "Rotating a vector by " << angle << " degrees is wrong" << endl;
+                }
+                return;
+            }
+        }
+    }
+
+    quat a(LibMatrix::Quat::rotate(40.0, 1.0, 1.0, 0.0));
+    quat b(LibMatrix::Quat::rotate(-75.0, 0.0, 1.0, 2.0));
+    mat4 ab(a.to_mat4());
+    ab *= b.to_mat4();
+    quat ai(a);
+    ai.inverse();
+    if (!close((a * b).to_mat4(), ab) || !same_rotation(a * ai, quat()))
+    {
+        if (options.beVerbose())
+        {
+            cout << "Quaternion product or inverse does not match the matrices" << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+QuatTestSlerp::run(const Options& options)
+{
+    const unsigned int count(100);
+    vector<quat> a(count);
+    vector<quat> b(count);
+    vector<float> t(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        a[i] = LibMatrix::Quat::rotate(i * 3.7f, 1.0, i % 5, 2.0);
+        b[i] = LibMatrix::Quat::rotate(i * -5.3f + 20.0f, i % 3, 1.0, -1.0);
+        t[i] = (i % 11) / 10.0f;
+    }
+
+    vector<quat> fixed(count);
+    vector<quat> varying(count);
+    vector<quat> nlerped(count);
+    LibMatrix::Quat::slerp(fixed, a, b, 0.3f);
+    LibMatrix::Quat::slerp(varying, a, b, t);
+    LibMatrix::Quat::nlerp(nlerped, a, b, 0.3f);
+
+    double worst(0);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        // Compare against the exact slerp in double precision.
+        dquat da(a[i].x(), a[i].y(), a[i].z(), a[i].w());
+        dquat db(b[i].x(), b[i].y(), b[i].z(), b[i].w());
+        dquat exact(LibMatrix::slerp(da, db, 0.3));
+        dquat exactv(LibMatrix::slerp(da, db, static_cast<double>(t[i])));
+        quat single(LibMatrix::slerp(a[i], b[i], 0.3f));
+        for (int c = 0; c < 4; c++)
+        {
+            worst = std::max(worst, fabs(static_cast<const float*>(fixed[i])[c] - static_cast<const double*>(exact)[c]));
+            worst = std::max(worst, fabs(static_cast<const float*>(varying[i])[c] - static_cast<const double*>(exactv)[c]));
+            worst = std::max(worst, fabs(static_cast<const float*>(single)[c] - static_cast<const double*>(exact)[c]));
+        }
+        if (nlerped[i] != LibMatrix::nlerp(a[i], b[i], 0.3f) &&
+            !same_rotation(nlerped[i], LibMatrix::nlerp(a[i], b[i], 0.3f), 1e-6))
+        {
+            if (options.beVerbose())
+            {
+                cout << "Batched nlerp differs at element " << i << endl;
+            }
+            return;
+        }
+    }
+
+    if (options.beVerbose())
+    {
+        cout << std::scientific << "Largest slerp error: " << worst << endl;
+    }
+
+    // In-place interpolation, and the end points.
+    vector<quat> in_place(a);
+    LibMatrix::Quat::slerp(in_place, in_place, b, 1.0f);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (!same_rotation(in_place[i], b[i]))
+        {
+            return;
+        }
+    }
+
+    if (worst < 1e-6)
+    {
+        pass_ = true;
+    }
+}
+
+void
+QuatTestDual::run(const Options& options)
+{
+    quat r(LibMatrix::Quat::rotate(60.0, 1.0, -1.0, 0.5));
+    vec3 t(3.0, -2.0, 1.0);
+    dualquat d(r, t);
+
+    mat4 m(LibMatrix::Mat4::translate(t.x(), t.y(), t.z()));
+    m *= LibMatrix::Mat4::rotate(60.0, 1.0, -1.0, 0.5);
+    if (!close(d.to_mat4(), m) || !close(d.translation(), t))
+    {
+        if (options.beVerbose())
+        {
+            cout << "Dual quaternion does not match its matrix" << endl;
+            d.to_mat4().print();
+            m.print();
+        }
+        return;
+    }
+
+    // Composition and inversion.
+    dualquat e(LibMatrix::Quat::rotate(-20.0, 0.0, 0.0, 1.0), vec3(0.0, 5.0, 0.0));
+    mat4 me(e.to_mat4());
+    mat4 mde(m);
+    mde *= me;
+    dualquat de(d * e);
+    dualquat di(d);
+    di.inverse();
+    mat4 mi(m);
+    mi.inverse();
+    if (!close(de.to_mat4(), mde) || !close(di.to_mat4(), mi) ||
+        !close(dualquat(m).to_mat4(), m))
+    {
+        if (options.beVerbose())
+        {
+            cout << "Dual quaternion product or inverse is wrong" << endl;
+        }
+        return;
+    }
+
+    const vec3 p(1.0, 2.0, 3.0);
+    vec4 expected(m * vec4(p, 1.0f));
+    if (!close(d.transform_point(p), vec3(expected.x(), expected.y(), expected.z())))
+    {
+        if (options.beVerbose())
+        {
+            cout << "Dual quaternion transforms points wrongly" << endl;
+        }
+        return;
+    }
+
+    // Blending gives the end points at 0 and 1, and a rigid transform in
+    // between.
+    dualquat half(LibMatrix::nlerp(d, e, 0.5f));
+    mat4 h(half.to_mat4());
+    if (!close(LibMatrix::nlerp(d, e, 0.0f).to_mat4(), m) ||
+        !close(LibMatrix::nlerp(d, e, 1.0f).to_mat4(), me) ||
+        fabs(h.determinant() - 1) > 1e-5)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Dual quaternion blending is wrong" << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
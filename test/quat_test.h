@@ -0,0 +1,36 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef QUAT_TEST_H_
+#define QUAT_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class QuatTestMatrix : public MatrixTest
+{
+public:
+    QuatTestMatrix() : MatrixTest("quat::matrix") {}
+    virtual void run(const Options& options);
+};
+
+class QuatTestSlerp : public MatrixTest
+{
+public:
+    QuatTestSlerp() : MatrixTest("quat::slerp") {}
+    virtual void run(const Options& options);
+};
+
+class QuatTestDual : public MatrixTest
+{
+public:
+    QuatTestDual() : MatrixTest("dualquat::transform") {}
+    virtual void run(const Options& options);
+};
+
+#endif // QUAT_TEST_H_
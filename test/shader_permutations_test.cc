@@ -0,0 +1,131 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "libmatrix_test.h"
+#include "shader_permutations_test.h"
+#include "../shader-permutations.h"
+#include "../util.h"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+static const string base_shader(
+    "precision mediump float;\n"
+    "uniform vec4 Color;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_FragColor = COLOR;\n"
+    "}\n");
+
+void
+ShaderPermutationsTestExpand::run(const Options& options)
+{
+    ShaderSource base;
+    base.append(base_shader);
+
+    ShaderPermutations perms(base);
+    perms.add_replace("COLOR", {"Color", "Color * Scale"});
+    perms.add_const("Scale", {1.0f, 2.0f, 4.0f}, "main");
+    // An axis whose values all give the same source.
+    perms.add_axis(2, [](ShaderSource &source, size_t) {
+        source.add("// unused\n");
+    });
+    perms.expand(2);
+
+    if (perms.size() != 12 || perms.num_variants() != 6)
+    {
+        if (options.beVerbose())
+        {
+            cout << perms.size() << " permutations, " << perms.num_variants()
+                 << " variants" << endl;
+        }
+        return;
+    }
+
+    // Variants are numbered in permutation order, and each matches the
+    // same edits made by hand.
+    unsigned int scaled(perms.variant(perms.permutation({1, 2, 1})));
+    ShaderSource expected(base);
+    expected.replace("COLOR", "Color * Scale");
+    expected.add_const("Scale", 4.0f, "main");
+    expected.add("// unused\n");
+    if (perms.variant(0) != 0 || perms.variant(1) != 0 || perms.variant(2) != 1 ||
+        scaled != 5 || perms.variant_source(scaled) != expected.str() ||
+        perms.permutation({2, 0, 0}) != perms.size())
+    {
+        if (options.beVerbose())
+        {
+            cout << "Wrong variants" << endl << perms.variant_source(scaled) << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
+
+//
+// Checks that the result does not depend on the number of threads, and
+// (with --verbose) shows how expansion scales with them.
+//
+void
+ShaderPermutationsTestThreads::run(const Options& options)
+{
+    ShaderSource base;
+    base.append(base_shader);
+
+    ShaderPermutations perms(base);
+    perms.add_replace("COLOR", {"Color", "Color.bgra", "Color * 0.5"});
+    perms.add_define("LIGHTS", {"1", "2", "4", "8"});
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        perms.add_const("Const" + std::to_string(i), {0.0f, 0.5f, 1.0f, 2.0f});
+    }
+
+    unsigned int counts[] = { 1, 2, 0 };
+    vector<unsigned int> reference;
+    for (unsigned int c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        uint64_t start(Util::get_timestamp_us());
+        perms.expand(counts[c]);
+        uint64_t elapsed(Util::get_timestamp_us() - start);
+
+        if (options.beVerbose())
+        {
+            cout << std::fixed << std::setprecision(1);
+            cout << perms.size() << " permutations with "
+                 << (counts[c] ? counts[c] : Util::get_num_processors())
+                 << " thread(s): " << elapsed / 1000.0 << " ms" << endl;
+        }
+
+        vector<unsigned int> variants;
+        for (size_t p = 0; p < perms.size(); p++)
+        {
+            variants.push_back(perms.variant(p));
+        }
+        if (reference.empty())
+        {
+            reference = variants;
+        }
+        else if (variants != reference || perms.num_variants() != perms.size())
+        {
+            if (options.beVerbose())
+            {
+                cout << "Variants depend on the number of threads" << endl;
+            }
+            return;
+        }
+    }
+
+    pass_ = true;
+}
@@ -0,0 +1,29 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef SHADER_PERMUTATIONS_TEST_H_
+#define SHADER_PERMUTATIONS_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class ShaderPermutationsTestExpand : public MatrixTest
+{
+public:
+    ShaderPermutationsTestExpand() : MatrixTest("ShaderPermutations::expand") {}
+    virtual void run(const Options& options);
+};
+
+class ShaderPermutationsTestThreads : public MatrixTest
+{
+public:
+    ShaderPermutationsTestThreads() : MatrixTest("ShaderPermutations::threads") {}
+    virtual void run(const Options& options);
+};
+
+#endif // SHADER_PERMUTATIONS_TEST_H_
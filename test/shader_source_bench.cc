@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <span>
+#include <string>
+#include <vector>
+#include "../shader-source.h"
+#include "../util.h"
+#include "../vec.h"
+
+using LibMatrix::vec4;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+//
+// Timings of building shader sources with ShaderSource, run by "make
+// bench" (the correctness of the same operations is covered by the unit
+// tests).
+//
+
+static const string edit_shader(
+    "precision mediump float;\n"
+    "uniform vec4 Color;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = Color;\n"
+    "}\n");
+
+// Build permutations of a shader with many constants added by add_const().
+static void
+permutations()
+{
+    static const unsigned int permutations(20);
+    static const unsigned int counts[] = { 10, 100, 1000 };
+
+    for (unsigned int c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        uint64_t start(Util::get_timestamp_us());
+        size_t size(0);
+        for (unsigned int p = 0; p < permutations; p++)
+        {
+            ShaderSource src_shader;
+            src_shader.append(edit_shader);
+            for (unsigned int i = 0; i < counts[c]; i++)
+            {
+                src_shader.add_const("Global" + std::to_string(i), static_cast<float>(p));
+                src_shader.add_const("Local" + std::to_string(i), vec4(i, p, 0.0, 1.0), "main");
+            }
+            size += src_shader.str().size();
+        }
+        uint64_t elapsed(Util::get_timestamp_us() - start);
+
+        cout << std::fixed << std::setprecision(1);
+        cout << std::setw(4) << counts[c] << " constants: "
+             << static_cast<double>(elapsed) / permutations << " us per shader ("
+             << size / permutations << " bytes)" << endl;
+    }
+}
+
+// Add a large lookup table with add_array().
+static void
+table()
+{
+    vector<float> table(4096);
+    for (unsigned int i = 0; i < table.size(); i++)
+    {
+        table[i] = std::sin(i * 0.001f);
+    }
+
+    uint64_t start(Util::get_timestamp_us());
+    ShaderSource src_shader;
+    src_shader.append(edit_shader);
+    src_shader.add_array("Table", std::span<const float>(table), "main");
+    size_t size(src_shader.str().size());
+    uint64_t elapsed(Util::get_timestamp_us() - start);
+
+    cout << table.size() << " entry table: " << elapsed << " us ("
+         << size << " bytes)" << endl;
+}
+
+int
+main()
+{
+    permutations();
+    table();
+    return 0;
+}
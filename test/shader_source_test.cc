@@ -9,13 +9,23 @@
 // Contributors:
 //     Jesse Barker - original implementation.
 //
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 #include "libmatrix_test.h"
 #include "shader_source_test.h"
 #include "../shader-source.h"
 #include "../vec.h"
 
+using std::cout;
+using std::endl;
 using std::string;
+using std::vector;
 using LibMatrix::vec4;
 
 void
@@ -47,3 +57,320 @@ ShaderSourceAddConstGlobal::run(const Options& options)
     // Compare the output strings to confirm the results.
     pass_ = (src_shader.str() == result_shader.str());
 }
+
+static const string edit_shader(
+    "precision mediump float;\n"
+    "uniform vec4 Color;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = Color;\n"
+    "}\n");
+
+void
+ShaderSourceEdits::run(const Options& options)
+{
+    // Globals go after the precision statements and locals at the top of
+    // the function, each ahead of the ones added before.
+    ShaderSource src_shader;
+    src_shader.append(edit_shader);
+    src_shader.add("const float A = 1.0;\n");
+    src_shader.add("float b = A;\n", "main");
+    src_shader.add("const float B = 2.0;\n");
+    src_shader.add("float c = B;\n", "main");
+    src_shader.replace("Color", "Tint");
+    src_shader.add("const float C = 3.0;\n");
+    src_shader.append("// end\n");
+
+    ShaderSource result_shader;
+    result_shader.append(
+        "precision mediump float;\n"
+        "const float C = 3.0;\n"
+        "const float B = 2.0;\n"
+        "const float A = 1.0;\n"
+        "uniform vec4 Tint;\n"
+        "void main()\n"
+        "{\n"
+        "float c = B;\n"
+        "float b = A;\n"
+        "    gl_Position = Tint;\n"
+        "}\n"
+        "// end\n");
+
+    if (src_shader.str() != result_shader.str())
+    {
+        if (options.beVerbose())
+        {
+            cout << src_shader.str() << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+ShaderSourceReplaceAll::run(const Options& options)
+{
+    // All strings are replaced in one pass: the longest match wins, and
+    // replacement text is not searched again.
+    vector<std::pair<string, string> > replacements;
+    replacements.push_back(std::make_pair("Color", "Color * Tint"));
+    replacements.push_back(std::make_pair("ColorScale", "2.0"));
+    replacements.push_back(std::make_pair("Tint", "Shade"));
+
+    ShaderSource src_shader;
+    src_shader.append(edit_shader);
+    src_shader.append("// Color ColorScale Tint\n");
+    src_shader.replace_all(replacements);
+
+    // The same strings with different replacements (using the cached
+    // matcher).
+    replacements[0].second = "vec4(1.0)";
+    ShaderSource src_shader2;
+    src_shader2.append("// Color ColorScale Tint\n");
+    src_shader2.replace_all(replacements);
+
+    ShaderSource result_shader;
+    result_shader.append(
+        "precision mediump float;\n"
+        "uniform vec4 Color * Tint;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_Position = Color * Tint;\n"
+        "}\n"
+        "// Color * Tint 2.0 Shade\n");
+    ShaderSource result_shader2;
+    result_shader2.append("// vec4(1.0) 2.0 Shade\n");
+
+    if (src_shader.str() != result_shader.str() ||
+        src_shader2.str() != result_shader2.str())
+    {
+        if (options.beVerbose())
+        {
+            cout << src_shader.str() << src_shader2.str() << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
+
+//
+// The same edits made to a plain string, finding the insertion points
+// afresh for every one (where ShaderSource keeps them, and edits a piece
+// table), for ShaderSourceInterleaved to check against.
+//
+class SourceModel
+{
+public:
+    void append(const string &str) { text_ += str; }
+
+    void add(const string &str, const string &function = "")
+    {
+        size_t pos(function.empty() ? global_position() : local_position(function));
+        if (pos == string::npos)
+            text_ += str;
+        else
+            text_.insert(pos, str);
+    }
+
+    void add_const(const string &name, float f, const string &function = "")
+    {
+        add(ShaderSource::const_definition(name, f), function);
+    }
+
+    void replace(const string &remove, const string &insert)
+    {
+        string result;
+        size_t start(0);
+        for (size_t pos = text_.find(remove); pos != string::npos;
+             pos = text_.find(remove, start))
+        {
+            result.append(text_, start, pos - start);
+            result += insert;
+            start = pos + remove.size();
+        }
+        result.append(text_, start, string::npos);
+        text_ = result;
+    }
+
+    const string &text() const { return text_; }
+
+private:
+    size_t global_position() const
+    {
+        size_t pos(text_.rfind("precision"));
+        if (pos == string::npos)
+            return 0;
+        size_t pos_if(text_.find("#if", pos));
+        size_t pos_endif(text_.find("#endif", pos));
+        if (pos_endif != string::npos && pos_endif < pos_if)
+            pos = pos_endif;
+        pos = text_.find("\n", pos);
+        return pos == string::npos ? pos : pos + 1;
+    }
+
+    size_t local_position(const string &function) const
+    {
+        size_t pos(text_.find("{", text_.find(function)));
+        pos = text_.find("\n", pos);
+        return pos == string::npos ? pos : pos + 1;
+    }
+
+    string text_;
+};
+
+void
+ShaderSourceInterleaved::run(const Options& options)
+{
+    ShaderSource src_shader;
+    SourceModel model;
+    src_shader.append(edit_shader);
+    model.append(edit_shader);
+
+    // Enough edits between replacements for the piece table to be
+    // compacted (at 1024 pieces) more than once, with insertions in two
+    // places, appends that move the insertion points, and strings that
+    // contain what the insertion points are found by.
+    for (unsigned int i = 0; i < 4000; i++)
+    {
+        string n(std::to_string(i));
+        switch (i % 7)
+        {
+        case 0:
+        case 3:
+            src_shader.add_const("G" + n, static_cast<float>(i));
+            model.add_const("G" + n, static_cast<float>(i));
+            break;
+        case 1:
+        case 4:
+            src_shader.add("float l" + n + " = Color.x;\n", "main");
+            model.add("float l" + n + " = Color.x;\n", "main");
+            break;
+        case 2:
+            src_shader.add("// precision " + n + "\n");
+            model.add("// precision " + n + "\n");
+            break;
+        case 5:
+            src_shader.add("// no newline " + n, "main");
+            model.add("// no newline " + n, "main");
+            break;
+        case 6:
+            src_shader.append("// appended " + n + "\n");
+            model.append("// appended " + n + "\n");
+            break;
+        }
+
+        if (i % 1500 == 1499)
+        {
+            src_shader.replace("Color", "Tint" + n);
+            model.replace("Color", "Tint" + n);
+            src_shader.replace("Tint" + n, "Color");
+            model.replace("Tint" + n, "Color");
+        }
+    }
+
+    ShaderSource result_shader;
+    result_shader.append(model.text());
+
+    if (src_shader.str() != result_shader.str())
+    {
+        if (options.beVerbose())
+        {
+            string str(src_shader.str());
+            string expected(result_shader.str());
+            size_t diff(std::mismatch(str.begin(), str.end(), expected.begin(), expected.end()).first -
+                        str.begin());
+            cout << "Sources differ at " << diff << ": "
+                 << str.substr(diff > 40 ? diff - 40 : 0, 80) << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
+
+//
+// Checks that constants are written as the shortest GLSL float literals
+// that read back as the same values, and that a large lookup table is
+// written out whole.
+//
+void
+ShaderSourceConstFormat::run(const Options& options)
+{
+    static const std::pair<float, const char *> literals[] = {
+        { 1.0f, "1.0" },
+        { -0.5f, "-0.5" },
+        { 0.1f, "0.1" },
+        { 100.0f, "100.0" },
+        { 1e-7f, "1e-07" },
+        { 3e20f, "3e+20" },
+    };
+
+    for (unsigned int i = 0; i < sizeof(literals) / sizeof(literals[0]); i++)
+    {
+        string expected("const float F = " + string(literals[i].second) + ";\n");
+        string definition(ShaderSource::const_definition("F", literals[i].first));
+        if (definition != expected)
+        {
+            if (options.beVerbose())
+            {
+                cout << "Got " << definition << "Expected " << expected;
+            }
+            return;
+        }
+    }
+
+    // Walk through the float bit patterns, reading each literal back.
+    for (uint32_t bits = 0; bits < 0x7f800000; bits += 0x1000 - 1)
+    {
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        string definition(ShaderSource::const_definition("F", f));
+        const char *literal(definition.c_str() + definition.find('=') + 2);
+        if (std::strtof(literal, 0) != f)
+        {
+            if (options.beVerbose())
+            {
+                cout << "Lost precision: " << definition;
+            }
+            return;
+        }
+    }
+
+    vector<float> table(4096);
+    for (unsigned int i = 0; i < table.size(); i++)
+    {
+        table[i] = std::sin(i * 0.001f);
+    }
+
+    ShaderSource src_shader;
+    src_shader.append(edit_shader);
+    src_shader.add_array("Table", std::span<const float>(table), "main");
+
+    // The declaration goes after the precision statement, and the
+    // initialization at the top of main().
+    string init;
+    for (unsigned int i = 0; i < table.size(); i++)
+    {
+        string definition(ShaderSource::const_definition("F", table[i]));
+        init += "Table[" + std::to_string(i) + "] = " +
+                definition.substr(definition.find('=') + 2);
+    }
+    string expected(edit_shader);
+    expected.insert(expected.find("{\n") + 2, init);
+    expected.insert(expected.find('\n') + 1, "float Table[4096];\n");
+    ShaderSource result_shader;
+    result_shader.append(expected);
+
+    if (src_shader.str() != result_shader.str())
+    {
+        if (options.beVerbose())
+        {
+            cout << "Wrong table" << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
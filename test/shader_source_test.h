@@ -29,4 +29,32 @@ public:
     virtual void run(const Options& options);
 };
 
+class ShaderSourceConstFormat : public MatrixTest
+{
+public:
+    ShaderSourceConstFormat() : MatrixTest("ShaderSource::const_format") {}
+    virtual void run(const Options& options);
+};
+
+class ShaderSourceEdits : public MatrixTest
+{
+public:
+    ShaderSourceEdits() : MatrixTest("ShaderSource::edits") {}
+    virtual void run(const Options& options);
+};
+
+class ShaderSourceReplaceAll : public MatrixTest
+{
+public:
+    ShaderSourceReplaceAll() : MatrixTest("ShaderSource::replace_all") {}
+    virtual void run(const Options& options);
+};
+
+class ShaderSourceInterleaved : public MatrixTest
+{
+public:
+    ShaderSourceInterleaved() : MatrixTest("ShaderSource::interleaved") {}
+    virtual void run(const Options& options);
+};
+
 #endif // SHADER_SOURCE_TEST_H
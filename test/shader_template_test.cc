@@ -0,0 +1,142 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "libmatrix_test.h"
+#include "shader_template_test.h"
+#include "../shader-template.h"
+#include "../util.h"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+static const string base_shader(
+    "#ifdef GL_ES\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "uniform vec4 Color;\n"
+    "vec4 shade(vec4 c)\n"
+    "{\n"
+    "    return c * $SCALE$;\n"
+    "}\n"
+    "void main()\n"
+    "{\n"
+    "    gl_FragColor = shade(Color) + $SCALE$ * $BIAS$;\n"
+    "}\n");
+
+void
+ShaderTemplateTestInstance::run(const Options& options)
+{
+    ShaderSource base;
+    base.append(base_shader);
+
+    ShaderTemplate tmpl(base, {"main", "shade"}, {"$SCALE$", "$BIAS$"});
+    ShaderTemplate::Instance instance(tmpl.instantiate());
+    instance.add_const("Scale", 2.0f);
+    instance.add("uniform float Time;\n");
+    instance.add_const("Offset", LibMatrix::vec2(1.0f, -1.0f), "main");
+    instance.add("    c.a = 1.0;\n", "shade");
+    instance.add("    float t = Time;\n", "main");
+    instance.set("$SCALE$", "Scale");
+    instance.precision(ShaderSource::Precision("high,high,default,default"));
+
+    ShaderSource expected(base);
+    expected.add_const("Scale", 2.0f);
+    expected.add("uniform float Time;\n");
+    expected.add_const("Offset", LibMatrix::vec2(1.0f, -1.0f), "main");
+    expected.add("    c.a = 1.0;\n", "shade");
+    expected.add("    float t = Time;\n", "main");
+    expected.replace("$SCALE$", "Scale");
+    expected.precision(ShaderSource::Precision("high,high,default,default"));
+
+    // A fresh instance of the same template is unaffected by the first.
+    ShaderSource unchanged(base);
+    if (instance.str() != expected.str() ||
+        tmpl.instantiate().str() != unchanged.str())
+    {
+        if (options.beVerbose())
+        {
+            cout << "Got:" << endl << instance.str() << endl
+                 << "Expected:" << endl << expected.str() << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
+
+//
+// Checks that variants made from a template match those made by editing
+// copies of the ShaderSource, and (with --verbose) compares their costs.
+//
+void
+ShaderTemplateTestVariants::run(const Options& options)
+{
+    ShaderSource base;
+    base.append(base_shader);
+    // A shader of a realistic size, with the functions near the end.
+    for (unsigned int i = 0; i < 200; i++)
+    {
+        base.add("uniform vec4 Unused" + std::to_string(i) + ";\n");
+    }
+
+    static const unsigned int num_variants(256);
+    ShaderTemplate tmpl(base, {"main", "shade"}, {"$SCALE$", "$BIAS$"});
+
+    vector<string> from_template;
+    uint64_t start(Util::get_timestamp_us());
+    for (unsigned int v = 0; v < num_variants; v++)
+    {
+        ShaderTemplate::Instance instance(tmpl.instantiate());
+        instance.add_const("Scale", static_cast<float>(v));
+        instance.add_const("Tint", LibMatrix::vec4(v, 0.0f, 1.0f, 0.5f), "main");
+        instance.add("    c.a = 1.0;\n", "shade");
+        instance.set("$SCALE$", "Scale");
+        instance.set("$BIAS$", std::to_string(v % 4));
+        from_template.push_back(instance.str());
+    }
+    uint64_t template_us(Util::get_timestamp_us() - start);
+
+    vector<string> from_source;
+    start = Util::get_timestamp_us();
+    for (unsigned int v = 0; v < num_variants; v++)
+    {
+        ShaderSource source(base);
+        source.add_const("Scale", static_cast<float>(v));
+        source.add_const("Tint", LibMatrix::vec4(v, 0.0f, 1.0f, 0.5f), "main");
+        source.add("    c.a = 1.0;\n", "shade");
+        source.replace("$SCALE$", "Scale");
+        source.replace("$BIAS$", std::to_string(v % 4));
+        from_source.push_back(source.str());
+    }
+    uint64_t source_us(Util::get_timestamp_us() - start);
+
+    if (options.beVerbose())
+    {
+        cout << std::fixed << std::setprecision(2);
+        cout << num_variants << " variants: ShaderTemplate "
+             << template_us / 1000.0 << " ms, ShaderSource "
+             << source_us / 1000.0 << " ms" << endl;
+    }
+
+    if (from_template != from_source)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Variants differ" << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
@@ -0,0 +1,29 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef SHADER_TEMPLATE_TEST_H_
+#define SHADER_TEMPLATE_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class ShaderTemplateTestInstance : public MatrixTest
+{
+public:
+    ShaderTemplateTestInstance() : MatrixTest("ShaderTemplate::instance") {}
+    virtual void run(const Options& options);
+};
+
+class ShaderTemplateTestVariants : public MatrixTest
+{
+public:
+    ShaderTemplateTestVariants() : MatrixTest("ShaderTemplate::variants") {}
+    virtual void run(const Options& options);
+};
+
+#endif // SHADER_TEMPLATE_TEST_H_
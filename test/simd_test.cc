@@ -0,0 +1,209 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+#include "libmatrix_test.h"
+#include "simd_test.h"
+#include "../simd.h"
+
+using LibMatrix::Simd::isa;
+using std::cout;
+using std::endl;
+
+namespace Simd = LibMatrix::Simd;
+
+// The kernels may fuse and reorder operations.
+static const double tolerance(1e-4);
+
+// Run every kernel of the active set and compare it to the scalar set.
+static bool
+check_kernels(const Simd::Kernels& k, const Simd::Kernels& ref)
+{
+    // A well conditioned, non-trivial matrix.
+    static const float mf[16] = {
+        2, 1, 0, 0.5,
+        -1, 3, 1, 0,
+        0.25, 0, 4, 1,
+        3, -2, 1, 1
+    };
+    static const double md[16] = {
+        2, 1, 0, 0.5,
+        -1, 3, 1, 0,
+        0.25, 0, 4, 1,
+        3, -2, 1, 1
+    };
+    static const unsigned int count(7);
+    float v4[count * 4];
+    float v3a[count * 3];
+    float v3b[count * 3];
+    for (unsigned int i = 0; i < count * 4; i++)
+    {
+        v4[i] = static_cast<float>(i % 5) - 1.5f;
+    }
+    for (unsigned int i = 0; i < count * 3; i++)
+    {
+        v3a[i] = static_cast<float>(i % 4) + 0.5f;
+        v3b[i] = static_cast<float>(i % 3) - 1.0f;
+    }
+
+    float outf[16];
+    float reff[16];
+    double outd[16];
+    double refd[16];
+    k.mat4_multiply_f(outf, mf, mf);
+    ref.mat4_multiply_f(reff, mf, mf);
+    if (!close(outf, reff, 16, tolerance))
+        return false;
+    k.mat4_multiply_d(outd, md, md);
+    ref.mat4_multiply_d(refd, md, md);
+    if (!close(outd, refd, 16, tolerance))
+        return false;
+    if (!k.mat4_inverse_f(outf, mf) || !ref.mat4_inverse_f(reff, mf) ||
+        !close(outf, reff, 16, tolerance))
+        return false;
+    if (!k.mat4_inverse_d(outd, md) || !ref.mat4_inverse_d(refd, md) ||
+        !close(outd, refd, 16, tolerance))
+        return false;
+
+    float out4[count * 4];
+    float ref4[count * 4];
+    k.mat4_transform4(out4, mf, v4, count);
+    ref.mat4_transform4(ref4, mf, v4, count);
+    if (!close(out4, ref4, count * 4, tolerance))
+        return false;
+
+    // Packed vec3 output must not be written past its end.
+    float out3[count * 3 + 1];
+    float ref3[count * 3];
+    out3[count * 3] = 42.0f;
+    k.mat4_transform3(out3, mf, v3a, count, 1.0f);
+    ref.mat4_transform3(ref3, mf, v3a, count, 1.0f);
+    if (!close(out3, ref3, count * 3, tolerance) || out3[count * 3] != 42.0f)
+        return false;
+
+    k.vec3_dot(out3, v3a, v3b, count);
+    ref.vec3_dot(ref3, v3a, v3b, count);
+    if (!close(out3, ref3, count, tolerance))
+        return false;
+    k.vec3_cross(out3, v3a, v3b, count);
+    ref.vec3_cross(ref3, v3a, v3b, count);
+    if (!close(out3, ref3, count * 3, tolerance))
+        return false;
+    k.vec3_normalize(out3, v3b, count);
+    ref.vec3_normalize(ref3, v3b, count);
+    if (!close(out3, ref3, count * 3, tolerance))
+        return false;
+
+    float q4[count * 4];
+    for (unsigned int i = 0; i < count * 4; i++)
+    {
+        q4[i] = static_cast<float>(i % 7) * 0.25f - 0.5f;
+    }
+    k.quat_multiply(out4, v4, q4, count);
+    ref.quat_multiply(ref4, v4, q4, count);
+    if (!close(out4, ref4, count * 4, tolerance))
+        return false;
+
+    // A zero quaternion must come through unchanged.
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        q4[i] = 0.0f;
+    }
+    k.quat_normalize(out4, q4, count);
+    ref.quat_normalize(ref4, q4, count);
+    if (!close(out4, ref4, count * 4, tolerance) || out4[0] != 0.0f || out4[3] != 0.0f)
+        return false;
+
+    // Two blocks of 4-component vectors, two chunks of lanes each.
+    static const size_t lanes(Simd::soa_lane_multiple * 2);
+    static const size_t blocks(2);
+    static const size_t size(blocks * 4 * lanes);
+    float sa[size];
+    float sb[size];
+    float out[size];
+    float refs[size];
+    for (unsigned int i = 0; i < size; i++)
+    {
+        sa[i] = static_cast<float>(i % 11) * 0.5f - 2.0f;
+        sb[i] = static_cast<float>(i % 6) - 2.5f;
+    }
+    // A zero vector in the second lane of the first block.
+    for (unsigned int c = 0; c < 4; c++)
+    {
+        sa[c * lanes + 1] = 0.0f;
+    }
+    k.soa_add(out, sa, sb, size);
+    ref.soa_add(refs, sa, sb, size);
+    if (!close(out, refs, size, tolerance))
+        return false;
+    k.soa_scale(out, sa, -1.5f, size);
+    ref.soa_scale(refs, sa, -1.5f, size);
+    if (!close(out, refs, size, tolerance))
+        return false;
+    k.soa_cross(out, sa, sb, blocks, lanes);
+    ref.soa_cross(refs, sa, sb, blocks, lanes);
+    if (!close(out, refs, blocks * 3 * lanes, tolerance))
+        return false;
+    k.soa_dot(out, sa, sb, blocks, 4, lanes);
+    ref.soa_dot(refs, sa, sb, blocks, 4, lanes);
+    if (!close(out, refs, blocks * lanes, tolerance))
+        return false;
+    k.soa_length(out, sa, blocks, 4, lanes);
+    ref.soa_length(refs, sa, blocks, 4, lanes);
+    if (!close(out, refs, blocks * lanes, tolerance))
+        return false;
+    // In place, as tvec_soa normalizes.
+    std::copy_n(sa, size, out);
+    k.soa_normalize(out, out, blocks, 4, lanes);
+    ref.soa_normalize(refs, sa, blocks, 4, lanes);
+    return close(out, refs, size, tolerance) && out[1] == 0.0f && out[lanes + 1] == 0.0f;
+}
+
+void
+SimdTestDispatch::run(const Options& options)
+{
+    static const isa all[] = {
+        isa::scalar,
+        isa::sse2,
+        isa::avx2,
+        isa::avx512,
+        isa::neon
+    };
+
+    if (!Simd::select(isa::scalar))
+    {
+        return;
+    }
+    const Simd::Kernels& ref(Simd::kernels());
+
+    bool ok(true);
+    for (isa id : all)
+    {
+        if (!Simd::select(id))
+        {
+            continue;
+        }
+        const Simd::Kernels& k(Simd::kernels());
+        bool kernel_ok(check_kernels(k, ref));
+        if (options.beVerbose())
+        {
+            cout << "Kernels for " << k.name << (kernel_ok ? " match" : " do not match")
+                 << " the scalar reference" << endl;
+        }
+        ok = ok && kernel_ok;
+    }
+
+    Simd::select_best();
+    if (options.beVerbose())
+    {
+        cout << "Using " << Simd::kernels().name << " kernels" << endl;
+    }
+    pass_ = ok;
+}
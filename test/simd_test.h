@@ -0,0 +1,22 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef SIMD_TEST_H_
+#define SIMD_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class SimdTestDispatch : public MatrixTest
+{
+public:
+    SimdTestDispatch() : MatrixTest("Simd::dispatch") {}
+    virtual void run(const Options& options);
+};
+
+#endif // SIMD_TEST_H_
@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <iostream>
+#include <vector>
+#include <math.h>
+#include "libmatrix_test.h"
+#include "soa_test.h"
+#include "../vec-soa.h"
+
+using LibMatrix::vec3;
+using LibMatrix::vec3_soa;
+using std::cout;
+using std::endl;
+using std::vector;
+
+static vec3
+element(unsigned int i)
+{
+    return vec3(static_cast<float>(i % 11) - 5.0f,
+                static_cast<float>(i % 3) * 0.25f,
+                static_cast<float>(i % 7) - 3.0f);
+}
+
+// Check that the lanes past the end of the last block are still zero.
+static bool
+padding_is_zero(const vec3_soa& v)
+{
+    for (unsigned int i = v.size(); i < v.num_blocks() * vec3_soa::lanes; i++)
+    {
+        const vec3_soa::block& b(v.blocks()[i / vec3_soa::lanes]);
+        for (unsigned int c = 0; c < 3; c++)
+        {
+            if (b.c[c][i % vec3_soa::lanes] != 0.0f)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void
+SoaTestConvert::run(const Options& options)
+{
+    // Not a multiple of the lane count, so that the last block is partial.
+    const unsigned int count(21);
+    vector<vec3> src(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        src[i] = element(i);
+    }
+
+    vec3_soa soa(src);
+    if (soa.size() != count || soa.num_blocks() != 3 || !padding_is_zero(soa))
+    {
+        if (options.beVerbose())
+        {
+            cout << "Unexpected layout after conversion" << endl;
+        }
+        return;
+    }
+
+    if (soa.to_vector() != src)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Round trip through vec3_soa changed the data" << endl;
+        }
+        return;
+    }
+
+    // Element access through the proxy.
+    soa[5] = vec3(1.0, 2.0, 3.0);
+    soa[6].y(7.0);
+    soa[7] = soa[5];
+    const vec3 e5(soa[5]);
+    const vec3 e6(soa[6]);
+    if (e5 != vec3(1.0, 2.0, 3.0) || e6.y() != 7.0f || e6.x() != src[6].x() ||
+        static_cast<vec3>(soa[7]) != e5)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Element proxy did not read back what was written" << endl;
+        }
+        return;
+    }
+
+    soa.push_back(vec3(4.0, 5.0, 6.0));
+    soa.resize(17);
+    if (soa.size() != 17 || !padding_is_zero(soa) || static_cast<vec3>(soa[16]) != src[16])
+    {
+        if (options.beVerbose())
+        {
+            cout << "Resizing broke the padding lanes" << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+SoaTestKernels::run(const Options& options)
+{
+    const unsigned int count(45);
+    vector<vec3> av(count);
+    vector<vec3> bv(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        av[i] = element(i);
+        bv[i] = element(i * 7 + 3);
+    }
+    // Exercise the zero-length case of normalize.
+    av[4] = vec3(0.0, 0.0, 0.0);
+
+    const vec3_soa a(av);
+    const vec3_soa b(bv);
+    vec3_soa sum;
+    vec3_soa scaled;
+    vec3_soa crossed;
+    vec3_soa normalized(a);
+    vector<float> dots(count);
+    vector<float> lengths(count);
+
+    LibMatrix::add(sum, a, b);
+    LibMatrix::scale(scaled, a, 2.5f);
+    LibMatrix::cross(crossed, a, b);
+    LibMatrix::normalize(normalized);
+    LibMatrix::dot(dots, a, b);
+    LibMatrix::length(lengths, a);
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        vec3 n(av[i]);
+        n.normalize();
+        if (!close(sum[i], av[i] + bv[i]) ||
+            !close(scaled[i], av[i] * 2.5f) ||
+            !close(crossed[i], vec3::cross(av[i], bv[i])) ||
+            !close(normalized[i], n) ||
+            !close(dots[i], vec3::dot(av[i], bv[i])) ||
+            !close(lengths[i], av[i].length()))
+        {
+            if (options.beVerbose())
+            {
+                cout << "SoA kernels disagree with vec3 at element " << i << endl;
+            }
+            return;
+        }
+    }
+
+    if (!padding_is_zero(sum) || !padding_is_zero(crossed))
+    {
+        return;
+    }
+
+    pass_ = true;
+}
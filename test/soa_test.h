@@ -0,0 +1,29 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef SOA_TEST_H_
+#define SOA_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class SoaTestConvert : public MatrixTest
+{
+public:
+    SoaTestConvert() : MatrixTest("vec3_soa::convert") {}
+    virtual void run(const Options& options);
+};
+
+class SoaTestKernels : public MatrixTest
+{
+public:
+    SoaTestKernels() : MatrixTest("vec3_soa::kernels") {}
+    virtual void run(const Options& options);
+};
+
+#endif // SOA_TEST_H_
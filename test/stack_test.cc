@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <iostream>
+#include <math.h>
+#include <stdint.h>
+#include "libmatrix_test.h"
+#include "stack_test.h"
+#include "../stack.h"
+
+using LibMatrix::mat3;
+using LibMatrix::mat4;
+using LibMatrix::Stack4;
+using LibMatrix::FixedStack4;
+using std::cout;
+using std::endl;
+
+void
+StackTestFixed::run(const Options& options)
+{
+    Stack4 reference;
+    FixedStack4<4> fixed;
+
+    // Mirror the same sequence of operations on both stacks.
+    reference.perspective(60.0, 1.0, 1.0, 50.0);
+    fixed.perspective(60.0, 1.0, 1.0, 50.0);
+    reference.push();
+    fixed.push();
+    reference.translate(1.0, 2.0, -10.0);
+    fixed.translate(1.0, 2.0, -10.0);
+    reference.push();
+    fixed.push();
+    reference.rotate(45.0, 0.0, 1.0, 0.0);
+    fixed.rotate(45.0, 0.0, 1.0, 0.0);
+    reference.push();
+    fixed.push();
+    reference.scale(2.0, 2.0, 2.0);
+    fixed.scale(2.0, 2.0, 2.0);
+
+    if (fixed.getCurrent() != reference.getCurrent() || !fixed.full() ||
+        fixed.getDepth() != 4)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Fixed stack does not match the reference stack" << endl;
+        }
+        return;
+    }
+
+    // Every slot starts on a 64-byte boundary.
+    bool aligned(true);
+    for (unsigned int i = 0; i < fixed.getCapacity(); i++)
+    {
+        aligned = aligned && reinterpret_cast<uintptr_t>(fixed.slots() + i) % 64 == 0;
+    }
+    if (!aligned)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Fixed stack slots are not 64-byte aligned" << endl;
+        }
+        return;
+    }
+
+    reference.pop();
+    fixed.pop();
+    reference.pop();
+    fixed.pop();
+    if (fixed.getCurrent() != reference.getCurrent() || fixed.getDepth() != 2)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Fixed stack does not match the reference stack after pop" << endl;
+        }
+        return;
+    }
+
+    // Popping the last matrix is refused (and logged as an underflow), and
+    // must not lose the operations pending on it.
+    fixed.pop();
+    reference.pop();
+    fixed.translate(1.0, 2.0, 3.0);
+    reference.translate(1.0, 2.0, 3.0);
+#ifdef USE_EXCEPTIONS
+    try
+    {
+        fixed.pop();
+    }
+    catch (const std::underflow_error&)
+    {
+    }
+#else // !USE_EXCEPTIONS
+    fixed.pop();
+#endif // USE_EXCEPTIONS
+    if (fixed.getCurrent() != reference.getCurrent() || fixed.getDepth() != 1)
+    {
+        if (options.beVerbose())
+        {
+            cout << "A refused pop changed the fixed stack" << endl;
+        }
+        return;
+    }
+
+    pass_ = true;
+}
+
+void
+StackTestLazy::run(const Options& options)
+{
+    Stack4 stack;
+    stack.setProjection(LibMatrix::Mat4::perspective(60.0, 1.0, 1.0, 50.0));
+    mat4 projection(LibMatrix::Mat4::perspective(60.0, 1.0, 1.0, 50.0));
+
+    // The same operations, multiplied in eagerly.
+    mat4 eager;
+    stack.lookAt(0.0, 2.0, 5.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0);
+    eager *= LibMatrix::Mat4::lookAt(0.0, 2.0, 5.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0);
+    stack.translate(1.0, 2.0, -3.0);
+    eager *= LibMatrix::Mat4::translate(1.0, 2.0, -3.0);
+    stack.rotate(30.0, 1.0, 1.0, 0.0);
+    eager *= LibMatrix::Mat4::rotate(30.0, 1.0, 1.0, 0.0);
+    stack.scale(2.0, 0.5, 3.0);
+    eager *= LibMatrix::Mat4::scale(2.0, 0.5, 3.0);
+
+    if (!close(stack.getCurrent(), eager))
+    {
+        if (options.beVerbose())
+        {
+            cout << "Deferred operations do not match the eager product" << endl;
+        }
+        return;
+    }
+
+    // Operations made after a push are discarded by the pop, even if the
+    // matrix was never looked at in between.
+    stack.push();
+    stack.translate(10.0, 0.0, 0.0);
+    stack.scale(5.0, 5.0, 5.0);
+    stack.pop();
+    if (!close(stack.getCurrent(), eager))
+    {
+        if (options.beVerbose())
+        {
+            cout << "Pending operations survived a pop" << endl;
+        }
+        return;
+    }
+
+    // The derived matrices, and their refresh after a change.
+    for (int i = 0; i < 2; i++)
+    {
+        mat4 inverse(eager);
+        inverse.inverse();
+        mat3 normal(eager.inverse_transpose3x3());
+        mat4 mvp(projection);
+        mvp *= eager;
+        if (!close(stack.getInverse(), inverse) ||
+            !close(stack.getNormalMatrix(), normal) ||
+            !close(stack.getModelViewProjection(), mvp))
+        {
+            if (options.beVerbose())
+            {
+                cout << "Cached matrices are wrong on pass " << i << endl;
+            }
+            return;
+        }
+        stack.translate(0.0, -1.0, 0.5);
+        eager *= LibMatrix::Mat4::translate(0.0, -1.0, 0.5);
+    }
+
+    pass_ = true;
+}
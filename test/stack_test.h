@@ -0,0 +1,29 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef STACK_TEST_H_
+#define STACK_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class StackTestFixed : public MatrixTest
+{
+public:
+    StackTestFixed() : MatrixTest("FixedStack4::push_pop") {}
+    virtual void run(const Options& options);
+};
+
+class StackTestLazy : public MatrixTest
+{
+public:
+    StackTestLazy() : MatrixTest("Stack4::lazy") {}
+    virtual void run(const Options& options);
+};
+
+#endif // STACK_TEST_H_
@@ -0,0 +1,205 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <math.h>
+#include "libmatrix_test.h"
+#include "transform_test.h"
+#include "../transform.h"
+
+using LibMatrix::mat4;
+using LibMatrix::vec3;
+using LibMatrix::vec4;
+using std::cout;
+using std::endl;
+using std::vector;
+
+static mat4
+test_matrix()
+{
+    mat4 m(LibMatrix::Mat4::translate(1.0, -2.0, 3.0));
+    m *= LibMatrix::Mat4::rotate(30.0, 1.0, 1.0, 0.0);
+    m *= LibMatrix::Mat4::scale(2.0, 0.5, 1.5);
+    return m;
+}
+
+// Transform a single vector the slow way to check the batches against.
+static vec4
+reference(const mat4& m, const vec3& v, float w)
+{
+    return m * vec4(v, w);
+}
+
+static vec3
+element(unsigned int i)
+{
+    return vec3(static_cast<float>(i % 13) - 6.0f,
+                static_cast<float>(i % 7) * 0.5f,
+                static_cast<float>(i % 5) - 2.5f);
+}
+
+void
+TransformTestBatch::run(const Options& options)
+{
+    const mat4 m(test_matrix());
+    const unsigned int count(37);
+    vector<vec3> src(count);
+    vector<vec4> src4(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        src[i] = element(i);
+        src4[i] = vec4(src[i], static_cast<float>(i % 3));
+    }
+
+    vector<vec3> points(count);
+    vector<vec3> vectors(count);
+    vector<vec4> out4(count);
+    LibMatrix::transform_points(m, src, points);
+    LibMatrix::transform_vectors(m, src, vectors);
+    LibMatrix::transform(m, src4, out4);
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (!close(vec4(points[i], 1.0f), reference(m, src[i], 1.0f), 1e-4) ||
+            !close(vec4(vectors[i], 0.0f), reference(m, src[i], 0.0f), 1e-4) ||
+            !close(out4[i], m * src4[i], 1e-4))
+        {
+            if (options.beVerbose())
+            {
+                cout << "Batch transform differs from operator* at element " << i << endl;
+            }
+            return;
+        }
+    }
+
+    // Transforming in place must give the same answer.
+    LibMatrix::transform_points(m, src, src);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (src[i] != points[i])
+        {
+            return;
+        }
+    }
+
+    pass_ = true;
+}
+
+void
+TransformTestStrided::run(const Options& options)
+{
+    // An interleaved vertex with the position in the middle.
+    struct Vertex
+    {
+        float uv[2];
+        float position[3];
+        float normal[3];
+    };
+
+    const mat4 m(test_matrix());
+    // Use more vertices than fit in a single gather block.
+    const unsigned int count(600);
+    vector<Vertex> vertices(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        vec3 p(element(i));
+        vertices[i].uv[0] = 0.25f;
+        vertices[i].uv[1] = 0.75f;
+        vertices[i].position[0] = p.x();
+        vertices[i].position[1] = p.y();
+        vertices[i].position[2] = p.z();
+        vertices[i].normal[0] = 0.0f;
+        vertices[i].normal[1] = 1.0f;
+        vertices[i].normal[2] = 0.0f;
+    }
+
+    vector<vec3> packed(count);
+    LibMatrix::transform_points(m, vertices[0].position, sizeof(Vertex),
+                                packed[0].data(), sizeof(vec3), count);
+    LibMatrix::transform_points(m, vertices[0].position, sizeof(Vertex),
+                                vertices[0].position, sizeof(Vertex), count);
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        vec4 expected(reference(m, element(i), 1.0f));
+        vec3 strided(vertices[i].position[0], vertices[i].position[1],
+                     vertices[i].position[2]);
+        if (!close(vec4(packed[i], 1.0f), expected, 1e-4) ||
+            !close(vec4(strided, 1.0f), expected, 1e-4) ||
+            vertices[i].uv[1] != 0.75f || vertices[i].normal[1] != 1.0f)
+        {
+            if (options.beVerbose())
+            {
+                cout << "Strided transform is wrong at vertex " << i << endl;
+            }
+            return;
+        }
+    }
+
+    // A stride shorter than an element must be refused, leaving dst alone.
+    vector<float> narrow(count * 4, -1.0f);
+#ifdef USE_EXCEPTIONS
+    try
+    {
+        LibMatrix::transform(m, narrow.data(), 4 * sizeof(float), narrow.data(),
+                             3 * sizeof(float), count);
+    }
+    catch (const std::invalid_argument&)
+    {
+    }
+#else // !USE_EXCEPTIONS
+    LibMatrix::transform(m, narrow.data(), 4 * sizeof(float), narrow.data(),
+                         3 * sizeof(float), count);
+#endif // USE_EXCEPTIONS
+    for (unsigned int i = 0; i < count * 4; i++)
+    {
+        if (narrow[i] != -1.0f)
+        {
+            if (options.beVerbose())
+            {
+                cout << "Strided transform accepted a stride shorter than a vec4" << endl;
+            }
+            return;
+        }
+    }
+
+    pass_ = true;
+}
+
+void
+TransformTestThreaded::run(const Options& options)
+{
+    const mat4 m(test_matrix());
+    const unsigned int count(100003);
+    vector<vec3> src(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        src[i] = element(i);
+    }
+
+    vector<vec3> single(count);
+    vector<vec3> threaded(count);
+    LibMatrix::transform_points(m, src, single);
+    LibMatrix::transform_points(m, src, threaded, 4);
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (single[i] != threaded[i])
+        {
+            if (options.beVerbose())
+            {
+                cout << "Threaded transform differs at element " << i << endl;
+            }
+            return;
+        }
+    }
+
+    pass_ = true;
+}
@@ -0,0 +1,36 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef TRANSFORM_TEST_H_
+#define TRANSFORM_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class TransformTestBatch : public MatrixTest
+{
+public:
+    TransformTestBatch() : MatrixTest("transform::batch") {}
+    virtual void run(const Options& options);
+};
+
+class TransformTestStrided : public MatrixTest
+{
+public:
+    TransformTestStrided() : MatrixTest("transform::strided") {}
+    virtual void run(const Options& options);
+};
+
+class TransformTestThreaded : public MatrixTest
+{
+public:
+    TransformTestThreaded() : MatrixTest("transform::threaded") {}
+    virtual void run(const Options& options);
+};
+
+#endif // TRANSFORM_TEST_H_
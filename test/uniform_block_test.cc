@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <iostream>
+#include <string.h>
+#include "libmatrix_test.h"
+#include "uniform_block_test.h"
+#include "../uniform-block.h"
+
+using LibMatrix::UniformBlock;
+using LibMatrix::std140;
+using LibMatrix::std430;
+using LibMatrix::mat3;
+using LibMatrix::mat4;
+using LibMatrix::vec2;
+using LibMatrix::vec3;
+using LibMatrix::vec4;
+using std::cout;
+using std::endl;
+
+// The offsets below are the ones GL reports for the equivalent blocks.
+typedef UniformBlock<std140, mat4, mat3, vec3, float, vec4[4]> Material;
+typedef UniformBlock<std140, float, vec2, float[3], mat3, vec3, int> Mixed140;
+typedef UniformBlock<std430, float, vec2, float[3], mat3, vec3, int> Mixed430;
+
+static_assert(Material::offset<1> == 64 && Material::offset<2> == 112 &&
+              Material::offset<3> == 124 && Material::offset<4> == 128 &&
+              Material::size == 192, "std140 material layout");
+
+struct Expected
+{
+    const char* name;
+    size_t actual;
+    size_t expected;
+};
+
+void
+UniformBlockTestLayout::run(const Options& options)
+{
+    const Expected expected[] = {
+        { "std140 vec2 offset", Mixed140::offset<1>, 8 },
+        { "std140 float[3] offset", Mixed140::offset<2>, 16 },
+        { "std140 float[3] stride", Mixed140::stride<2>, 16 },
+        { "std140 mat3 offset", Mixed140::offset<3>, 64 },
+        { "std140 vec3 offset", Mixed140::offset<4>, 112 },
+        { "std140 int offset", Mixed140::offset<5>, 124 },
+        { "std140 size", Mixed140::size, 128 },
+        { "std430 vec2 offset", Mixed430::offset<1>, 8 },
+        { "std430 float[3] offset", Mixed430::offset<2>, 16 },
+        { "std430 float[3] stride", Mixed430::stride<2>, 4 },
+        { "std430 mat3 offset", Mixed430::offset<3>, 32 },
+        { "std430 vec3 offset", Mixed430::offset<4>, 80 },
+        { "std430 int offset", Mixed430::offset<5>, 92 },
+        { "std430 size", Mixed430::size, 96 },
+    };
+
+    for (const Expected& e : expected)
+    {
+        if (e.actual != e.expected)
+        {
+            if (options.beVerbose())
+            {
+                cout << e.name << " is " << e.actual << ", expected "
+                     << e.expected << endl;
+            }
+            return;
+        }
+    }
+
+    pass_ = true;
+}
+
+template<typename T>
+static T
+load(const unsigned char* data, size_t offset)
+{
+    T value;
+    memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+void
+UniformBlockTestPack::run(const Options& options)
+{
+    mat3 normal(1.0, 2.0, 3.0,
+                4.0, 5.0, 6.0,
+                7.0, 8.0, 9.0);
+    vec4 light(0.5, 0.25, 0.125, 1.0);
+    float weights[3] = { 1.5, 2.5, 3.5 };
+
+    Mixed140 block;
+    block.set<3>(normal);
+    block.set<2>(weights);
+    block.set<5>(42);
+    Material material;
+    material.set<4>(2, light);
+    material.set<4>(4, light);   // out of range, ignored
+
+    const unsigned char* data(block.data());
+    for (unsigned int col = 0; col < 3; col++)
+    {
+        for (unsigned int row = 0; row < 3; row++)
+        {
+            // Each mat3 column is padded out to 16 bytes.
+            float value(load<float>(data, 64 + col * 16 + row * 4));
+            if (value != normal[row][col])
+            {
+                if (options.beVerbose())
+                {
+                    cout << "mat3 element [" << row << "][" << col << "] is "
+                         << value << ", expected " << normal[row][col] << endl;
+                }
+                return;
+            }
+        }
+        if (load<float>(data, 64 + col * 16 + 12) != 0.0)
+        {
+            if (options.beVerbose())
+            {
+                cout << "mat3 column " << col << " padding was written" << endl;
+            }
+            return;
+        }
+    }
+
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        if (load<float>(data, 16 + i * 16) != weights[i])
+        {
+            if (options.beVerbose())
+            {
+                cout << "float[3] element " << i << " is misplaced" << endl;
+            }
+            return;
+        }
+    }
+
+    if (load<int>(data, 124) != 42)
+    {
+        if (options.beVerbose())
+        {
+            cout << "int member is misplaced" << endl;
+        }
+        return;
+    }
+
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        if (load<float>(material.data(), 128 + 2 * 16 + i * 4) != light[i] ||
+            load<float>(material.data(), 128 + 3 * 16 + i * 4) != 0.0)
+        {
+            if (options.beVerbose())
+            {
+                cout << "vec4[4] element 2 is misplaced" << endl;
+            }
+            return;
+        }
+    }
+
+    pass_ = true;
+}
@@ -0,0 +1,29 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef UNIFORM_BLOCK_TEST_H_
+#define UNIFORM_BLOCK_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class UniformBlockTestLayout : public MatrixTest
+{
+public:
+    UniformBlockTestLayout() : MatrixTest("UniformBlock::layout") {}
+    virtual void run(const Options& options);
+};
+
+class UniformBlockTestPack : public MatrixTest
+{
+public:
+    UniformBlockTestPack() : MatrixTest("UniformBlock::pack") {}
+    virtual void run(const Options& options);
+};
+
+#endif // UNIFORM_BLOCK_TEST_H_
@@ -0,0 +1,255 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <algorithm>
+#include <stdexcept>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "transform.h"
+#include "simd.h"
+#include "util.h"
+#include "log.h"
+
+namespace LibMatrix
+{
+namespace
+{
+
+static_assert(sizeof(vec3) == 3 * sizeof(float), "vec3 arrays must be packed");
+static_assert(sizeof(vec4) == 4 * sizeof(float), "vec4 arrays must be packed");
+
+// The smallest share of a batch worth handing to its own thread.
+const size_t min_elements_per_thread(32768);
+
+// How many strided elements are gathered into a packed block at a time.
+const size_t gather_block(256);
+
+size_t
+checked_count(size_t src, size_t dst)
+{
+    if (dst < src)
+    {
+#ifdef USE_EXCEPTIONS
+        throw std::invalid_argument("Transform destination is smaller than the source");
+#else // !USE_EXCEPTIONS
+        Log::error("Transform destination is smaller than the source (%zu < %zu)\n",
+                   dst, src);
+#endif // USE_EXCEPTIONS
+        return dst;
+    }
+    return src;
+}
+
+// Check that the strides leave room for a whole element of 'packed' bytes.
+// Returns the number of elements to transform: 'count', or none if either
+// stride is too small.
+size_t
+checked_stride(size_t src_stride, size_t dst_stride, size_t packed, size_t count)
+{
+    if (src_stride < packed || dst_stride < packed)
+    {
+#ifdef USE_EXCEPTIONS
+        throw std::invalid_argument("Transform stride is smaller than an element");
+#else // !USE_EXCEPTIONS
+        Log::error("Transform stride is smaller than an element (%zu, %zu < %zu)\n",
+                   src_stride, dst_stride, packed);
+#endif // USE_EXCEPTIONS
+        return 0;
+    }
+    return count;
+}
+
+// Split [0, count) into contiguous ranges and run work(begin, end) on each,
+// using the calling thread for the first range.
+template<typename Work>
+void
+parallel_for(size_t count, unsigned int threads, Work work)
+{
+    if (threads == 0)
+    {
+        threads = Util::get_num_processors();
+    }
+    size_t useful(count / min_elements_per_thread);
+    if (useful < threads)
+    {
+        threads = useful ? useful : 1;
+    }
+    if (threads <= 1)
+    {
+        work(0, count);
+        return;
+    }
+
+    size_t chunk((count + threads - 1) / threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t begin = chunk; begin < count; begin += chunk)
+    {
+        try
+        {
+            workers.emplace_back(work, begin, std::min(count, begin + chunk));
+        }
+        catch (...)
+        {
+            // No more threads to be had (std::system_error), or no memory
+            // for one.  The calling thread does the rest.
+            work(begin, count);
+            break;
+        }
+    }
+    work(0, chunk);
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void
+strided3(const float* m, const float* src, size_t src_stride,
+         float* dst, size_t dst_stride, size_t count, float w)
+{
+    static const size_t packed(3 * sizeof(float));
+    if (src_stride == packed && dst_stride == packed)
+    {
+        Simd::mat4_transform3(dst, m, src, count, w);
+        return;
+    }
+
+    const char* in(reinterpret_cast<const char*>(src));
+    char* out(reinterpret_cast<char*>(dst));
+    float block[gather_block * 3];
+    for (size_t done = 0; done < count; done += gather_block)
+    {
+        size_t n(std::min(gather_block, count - done));
+        for (size_t i = 0; i < n; i++, in += src_stride)
+        {
+            memcpy(&block[i * 3], in, packed);
+        }
+        Simd::mat4_transform3(block, m, block, n, w);
+        for (size_t i = 0; i < n; i++, out += dst_stride)
+        {
+            memcpy(out, &block[i * 3], packed);
+        }
+    }
+}
+
+void
+strided4(const float* m, const float* src, size_t src_stride,
+         float* dst, size_t dst_stride, size_t count)
+{
+    static const size_t packed(4 * sizeof(float));
+    if (src_stride == packed && dst_stride == packed)
+    {
+        Simd::mat4_transform4(dst, m, src, count);
+        return;
+    }
+
+    const char* in(reinterpret_cast<const char*>(src));
+    char* out(reinterpret_cast<char*>(dst));
+    float block[gather_block * 4];
+    for (size_t done = 0; done < count; done += gather_block)
+    {
+        size_t n(std::min(gather_block, count - done));
+        for (size_t i = 0; i < n; i++, in += src_stride)
+        {
+            memcpy(&block[i * 4], in, packed);
+        }
+        Simd::mat4_transform4(block, m, block, n);
+        for (size_t i = 0; i < n; i++, out += dst_stride)
+        {
+            memcpy(out, &block[i * 4], packed);
+        }
+    }
+}
+
+void
+batch3(const mat4& m, const float* src, size_t src_stride,
+       float* dst, size_t dst_stride, size_t count, float w,
+       unsigned int threads)
+{
+    const float* data(m);
+    parallel_for(count, threads, [=](size_t begin, size_t end) {
+        strided3(data,
+                 reinterpret_cast<const float*>(reinterpret_cast<const char*>(src) + begin * src_stride),
+                 src_stride,
+                 reinterpret_cast<float*>(reinterpret_cast<char*>(dst) + begin * dst_stride),
+                 dst_stride, end - begin, w);
+    });
+}
+
+void
+batch4(const mat4& m, const float* src, size_t src_stride,
+       float* dst, size_t dst_stride, size_t count, unsigned int threads)
+{
+    const float* data(m);
+    parallel_for(count, threads, [=](size_t begin, size_t end) {
+        strided4(data,
+                 reinterpret_cast<const float*>(reinterpret_cast<const char*>(src) + begin * src_stride),
+                 src_stride,
+                 reinterpret_cast<float*>(reinterpret_cast<char*>(dst) + begin * dst_stride),
+                 dst_stride, end - begin);
+    });
+}
+
+} // namespace
+
+void
+transform_points(const mat4& m, std::span<const vec3> src, std::span<vec3> dst,
+                 unsigned int threads)
+{
+    batch3(m, reinterpret_cast<const float*>(src.data()), sizeof(vec3),
+           reinterpret_cast<float*>(dst.data()), sizeof(vec3),
+           checked_count(src.size(), dst.size()), 1.0f, threads);
+}
+
+void
+transform_vectors(const mat4& m, std::span<const vec3> src, std::span<vec3> dst,
+                  unsigned int threads)
+{
+    batch3(m, reinterpret_cast<const float*>(src.data()), sizeof(vec3),
+           reinterpret_cast<float*>(dst.data()), sizeof(vec3),
+           checked_count(src.size(), dst.size()), 0.0f, threads);
+}
+
+void
+transform(const mat4& m, std::span<const vec4> src, std::span<vec4> dst,
+          unsigned int threads)
+{
+    batch4(m, reinterpret_cast<const float*>(src.data()), sizeof(vec4),
+           reinterpret_cast<float*>(dst.data()), sizeof(vec4),
+           checked_count(src.size(), dst.size()), threads);
+}
+
+void
+transform_points(const mat4& m, const float* src, size_t src_stride,
+                 float* dst, size_t dst_stride, size_t count,
+                 unsigned int threads)
+{
+    batch3(m, src, src_stride, dst, dst_stride,
+           checked_stride(src_stride, dst_stride, 3 * sizeof(float), count), 1.0f, threads);
+}
+
+void
+transform_vectors(const mat4& m, const float* src, size_t src_stride,
+                  float* dst, size_t dst_stride, size_t count,
+                  unsigned int threads)
+{
+    batch3(m, src, src_stride, dst, dst_stride,
+           checked_stride(src_stride, dst_stride, 3 * sizeof(float), count), 0.0f, threads);
+}
+
+void
+transform(const mat4& m, const float* src, size_t src_stride,
+          float* dst, size_t dst_stride, size_t count, unsigned int threads)
+{
+    batch4(m, src, src_stride, dst, dst_stride,
+           checked_stride(src_stride, dst_stride, 4 * sizeof(float), count), threads);
+}
+
+} // namespace LibMatrix
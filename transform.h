@@ -0,0 +1,65 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef TRANSFORM_H_
+#define TRANSFORM_H_
+
+#include <span>
+#include <stddef.h>
+#include "mat.h"
+
+namespace LibMatrix
+{
+//
+// Batched transforms of whole arrays of vectors by a single matrix.  These
+// run the vectorized kernels from simd.h over the array rather than going
+// through operator* one element at a time.
+//
+// The 3-component variants treat the matrix as affine: points get the
+// translation applied (w = 1), vectors do not (w = 0), and no perspective
+// divide takes place.  The destination may be the same array as the
+// source, but must not otherwise overlap it: elements are transformed in
+// blocks, and across threads, so a destination that is offset from the
+// source would overwrite elements that are yet to be read.  If the
+// destination is shorter than the source, only as many elements as fit are
+// transformed (or an exception is thrown when built with USE_EXCEPTIONS).
+//
+// 'threads' allows large batches to be split across worker threads: 1 (the
+// default) keeps all of the work on the calling thread and 0 uses one
+// thread per processor.  Batches are only split when each thread gets a
+// few tens of thousands of elements, so small arrays never pay for it.
+//
+void transform_points(const mat4& m, std::span<const vec3> src,
+                      std::span<vec3> dst, unsigned int threads = 1);
+void transform_vectors(const mat4& m, std::span<const vec3> src,
+                       std::span<vec3> dst, unsigned int threads = 1);
+void transform(const mat4& m, std::span<const vec4> src,
+               std::span<vec4> dst, unsigned int threads = 1);
+
+//
+// Strided variants for interleaved vertex data (e.g. a position that is
+// followed by a normal and texture coordinates in each vertex).  Strides
+// are in bytes, and each element is read as 3 (or 4) consecutive floats,
+// so a stride smaller than that is refused (nothing is transformed, or an
+// exception is thrown when built with USE_EXCEPTIONS).  As above, the
+// destination may be the source itself, with the same stride, but must not
+// otherwise overlap it.
+//
+void transform_points(const mat4& m, const float* src, size_t src_stride,
+                      float* dst, size_t dst_stride, size_t count,
+                      unsigned int threads = 1);
+void transform_vectors(const mat4& m, const float* src, size_t src_stride,
+                       float* dst, size_t dst_stride, size_t count,
+                       unsigned int threads = 1);
+void transform(const mat4& m, const float* src, size_t src_stride,
+               float* dst, size_t dst_stride, size_t count,
+               unsigned int threads = 1);
+
+} // namespace LibMatrix
+
+#endif // TRANSFORM_H_
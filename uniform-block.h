@@ -0,0 +1,260 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef UNIFORM_BLOCK_H_
+#define UNIFORM_BLOCK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <tuple>
+#include <type_traits>
+#include "mat.h"
+
+namespace LibMatrix
+{
+//
+// CPU-side images of GLSL uniform (or shader storage) blocks, laid out by
+// the std140 or std430 rules so that a whole block can be handed to GL in
+// one buffer write.
+//
+// The layout is described entirely at compile time by the list of member
+// types, in the order they are declared in the shader:
+//
+//     // layout(std140) uniform Material
+//     // { mat4 model; mat3 normal; vec3 color; float shininess; vec4 lights[4]; };
+//     typedef UniformBlock<std140, mat4, mat3, vec3, float, vec4[4]> Material;
+//
+//     Material material;
+//     material.set<0>(model);
+//     material.set<4>(2, light);                  // lights[2]
+//     buffer.update(material.data());
+//
+// Members may be scalars (float, int, unsigned int, bool, double), tvec's
+// of 2 to 4 of those, square tmat's, or one-dimensional arrays of any of
+// these.  Booleans are stored as 32-bit integers, as GLSL does.  Matrices
+// are stored column-major, so a mat3 becomes three vec4-aligned columns.
+//
+
+// Layout rule tags.
+struct std140 {};
+struct std430 {};
+
+namespace detail
+{
+constexpr size_t
+round_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// How a member type maps onto GLSL: the component type it is stored as,
+// and its shape as 'columns' vectors of 'rows' components.
+template<typename T>
+struct block_type;
+
+template<scalar T>
+struct block_type<T>
+{
+    typedef std::conditional_t<std::is_same_v<T, bool>, uint32_t, T> component;
+    static constexpr size_t rows = 1;
+    static constexpr size_t columns = 1;
+    static const T* data(const T& value) { return &value; }
+};
+
+template<scalar T, size_t N, enum align A, size_t N_POW2>
+struct block_type<tvec<T,N,A,N_POW2> >
+{
+    static_assert(N >= 2 && N <= 4, "block vectors have 2 to 4 components");
+    typedef std::conditional_t<std::is_same_v<T, bool>, uint32_t, T> component;
+    static constexpr size_t rows = N;
+    static constexpr size_t columns = 1;
+    static const T* data(const tvec<T,N,A,N_POW2>& value) { return value.data(); }
+};
+
+template<typename T>
+struct block_type<tmat2<T> >
+{
+    typedef T component;
+    static constexpr size_t rows = 2;
+    static constexpr size_t columns = 2;
+    static const T* data(const tmat2<T>& value) { return value; }
+};
+
+template<typename T>
+struct block_type<tmat3<T> >
+{
+    typedef T component;
+    static constexpr size_t rows = 3;
+    static constexpr size_t columns = 3;
+    static const T* data(const tmat3<T>& value) { return value; }
+};
+
+template<typename T>
+struct block_type<tmat4<T> >
+{
+    typedef T component;
+    static constexpr size_t rows = 4;
+    static constexpr size_t columns = 4;
+    static const T* data(const tmat4<T>& value) { return value; }
+};
+
+// The alignment, size and (for arrays and matrices) stride of a member
+// under each set of rules.
+template<typename Layout, typename T>
+struct block_layout
+{
+    typedef block_type<T> type;
+    static constexpr size_t component_size = sizeof(typename type::component);
+    static_assert(component_size == 4 || component_size == 8,
+                  "block components must be 32 or 64 bits");
+    // A vector of 3 components is aligned like one of 4.
+    static constexpr size_t vector_alignment =
+        component_size * (type::rows == 1 ? 1 : (type::rows == 2 ? 2 : 4));
+    static constexpr size_t vector_size = component_size * type::rows;
+    // Matrices are laid out as arrays of column vectors.
+    static constexpr size_t alignment = type::columns == 1 ? vector_alignment :
+        (std::is_same_v<Layout, std140> ? round_up(vector_alignment, 16) : vector_alignment);
+    static constexpr size_t column_stride = round_up(vector_size, alignment);
+    static constexpr size_t size =
+        type::columns == 1 ? vector_size : column_stride * type::columns;
+    static constexpr size_t elements = 1;
+    static constexpr size_t stride = round_up(size, alignment);
+};
+
+template<typename Layout, typename T, size_t Count>
+struct block_layout<Layout, T[Count]>
+{
+    typedef block_layout<Layout, T> element;
+    typedef typename element::type type;
+    // Under std140 every array element is aligned like a vec4.
+    static constexpr size_t alignment = std::is_same_v<Layout, std140> ?
+        round_up(element::alignment, 16) : element::alignment;
+    static constexpr size_t column_stride = element::column_stride;
+    static constexpr size_t elements = Count;
+    static constexpr size_t stride = round_up(element::size, alignment);
+    static constexpr size_t size = stride * Count;
+};
+
+// Store one value (of a non-array type) at dst.
+template<typename Layout, typename T>
+void
+block_store(unsigned char* dst, const T& value)
+{
+    typedef block_layout<Layout, T> layout;
+    typedef typename layout::type type;
+    typedef typename type::component component;
+    const auto* src(type::data(value));
+    for (size_t col = 0; col < type::columns; col++)
+    {
+        for (size_t row = 0; row < type::rows; row++)
+        {
+            component c(static_cast<component>(src[col * type::rows + row]));
+            memcpy(dst + col * layout::column_stride + row * sizeof(component),
+                   &c, sizeof(component));
+        }
+    }
+}
+} // namespace detail
+
+template<typename Layout, typename... Members>
+class UniformBlock
+{
+    static_assert(std::is_same_v<Layout, std140> || std::is_same_v<Layout, std430>,
+                  "UniformBlock layout must be std140 or std430");
+    static_assert(sizeof...(Members) > 0, "UniformBlock needs at least one member");
+
+    typedef std::tuple<Members...> member_list;
+
+    template<size_t I>
+    using layout = detail::block_layout<Layout, std::tuple_element_t<I, member_list> >;
+
+    template<size_t I>
+    static constexpr size_t compute_offset()
+    {
+        if constexpr (I == 0)
+        {
+            return 0;
+        }
+        else
+        {
+            return detail::round_up(compute_offset<I - 1>() + layout<I - 1>::size,
+                                    layout<I>::alignment);
+        }
+    }
+
+    template<size_t... I>
+    static constexpr size_t compute_alignment(std::index_sequence<I...>)
+    {
+        size_t alignment(std::is_same_v<Layout, std140> ? 16 : 1);
+        ((alignment = layout<I>::alignment > alignment ? layout<I>::alignment : alignment), ...);
+        return alignment;
+    }
+
+public:
+    static constexpr size_t members = sizeof...(Members);
+
+    // The declared type of member I (for arrays, the element type).
+    template<size_t I>
+    using member_type = std::remove_extent_t<std::tuple_element_t<I, member_list> >;
+
+    // Byte offset of member I from the start of the block.
+    template<size_t I>
+    static constexpr size_t offset = compute_offset<I>();
+
+    // Distance in bytes between elements of member I, if it is an array.
+    template<size_t I>
+    static constexpr size_t stride = layout<I>::stride;
+
+    // Base alignment of the block, and its total size rounded up to it.
+    static constexpr size_t alignment =
+        compute_alignment(std::index_sequence_for<Members...>());
+    static constexpr size_t size =
+        detail::round_up(offset<members - 1> + layout<members - 1>::size, alignment);
+
+    UniformBlock() { memset(data_, 0, size); }
+
+    // Set member I, or element 'element' of it if it is an array.  Out of
+    // range elements are ignored.
+    template<size_t I>
+    void set(const member_type<I>& value)
+    {
+        set<I>(0, value);
+    }
+
+    template<size_t I>
+    void set(size_t element, const member_type<I>& value)
+    {
+        if (element >= layout<I>::elements)
+        {
+            return;
+        }
+        detail::block_store<Layout>(data_ + offset<I> + element * stride<I>, value);
+    }
+
+    // Set a whole array member.
+    template<size_t I>
+        requires (std::is_array_v<std::tuple_element_t<I, member_list> >)
+    void set(const std::tuple_element_t<I, member_list>& values)
+    {
+        for (size_t i = 0; i < layout<I>::elements; i++)
+        {
+            set<I>(i, values[i]);
+        }
+    }
+
+    // The packed block, ready to be copied into a buffer object.
+    const unsigned char* data() const { return data_; }
+
+private:
+    alignas(16) unsigned char data_[size];
+};
+
+} // namespace LibMatrix
+
+#endif // UNIFORM_BLOCK_H_
@@ -230,6 +230,18 @@ Util::get_timestamp_us()
             std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
+uint64_t
+Util::hash(const string& s, uint64_t seed)
+{
+    uint64_t h(seed);
+    for (string::const_iterator it = s.begin(); it != s.end(); it++)
+    {
+        h ^= static_cast<unsigned char>(*it);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
 #ifndef ANDROID
 
 std::istream *
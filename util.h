@@ -58,6 +58,17 @@ struct Util {
      * get_timestamp_us() - Returns the current time in microseconds
      */
     static uint64_t get_timestamp_us();
+    /**
+     * hash() - Computes a 64-bit FNV-1a hash of a string
+     *
+     * @s:          the string to hash
+     * @seed:       the value to start from
+     *
+     * Passing the result of one call as @seed to the next hashes the
+     * concatenation of several strings.  Not suitable for cryptographic use.
+     */
+    static uint64_t hash(const std::string& s,
+                         uint64_t seed = 14695981039346656037ULL);
     /**
      * get_resource() - Gets an input filestream for a given file.
      *
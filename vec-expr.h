@@ -0,0 +1,250 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef VEC_EXPR_H_
+#define VEC_EXPR_H_
+
+#include <functional>
+#include <type_traits>
+#include "vec.h"
+
+namespace LibMatrix
+{
+namespace Expr
+{
+//
+// Opt-in expression templates for tvec arithmetic.
+//
+// The tvec operators each return a complete vector, so a chain such as
+// a * s + b * t - c stores three temporaries on the way to its result.
+// Wrapping vectors in lazy() instead builds a small expression object that
+// records the operations, and nothing is computed until it is converted to
+// a tvec or passed to assign().  At that point each component of the result
+// is evaluated in a single pass:
+//
+//     vec3 x = Expr::lazy(a) * s + Expr::lazy(b) * t - c;
+//     Expr::assign(v, Expr::lazy(accel) * dt + v);
+//
+// Once one operand of an operator is an expression, the other may be an
+// expression, a tvec of the same size and element type, or a scalar.  Note
+// that an operator between a plain tvec and a scalar (b * t above) is still
+// the eager tvec one, so each such term needs its own lazy().
+//
+// Expressions refer to their tvec operands rather than copying them, so
+// they must be evaluated within the statement that builds them; don't hold
+// on to one in an 'auto' variable.  As every operation works component by
+// component, it is safe for the destination to appear in the expression.
+//
+
+// Common base of all expression nodes.  Provides evaluation into a tvec.
+template<typename E>
+class Base
+{
+public:
+    template<scalar T, size_t N, enum align A, size_t N_POW2>
+    operator tvec<T,N,A,N_POW2>() const
+    {
+        static_assert(N == E::size, "expression and vector sizes differ");
+        tvec<T,N,A,N_POW2> dst;
+        for (size_t i = 0; i < N; i++)
+        {
+            dst[i] = static_cast<const E&>(*this)[i];
+        }
+        return dst;
+    }
+};
+
+template<typename E>
+concept expression = std::is_base_of_v<Base<E>, E>;
+
+// A tvec operand.
+template<scalar T, size_t N, enum align A, size_t N_POW2>
+class Ref : public Base<Ref<T,N,A,N_POW2>>
+{
+public:
+    typedef T value_type;
+    static constexpr size_t size = N;
+
+    Ref(const tvec<T,N,A,N_POW2>& v) : v_(v) {}
+    T operator[](size_t i) const { return v_[i]; }
+
+private:
+    const tvec<T,N,A,N_POW2>& v_;
+};
+
+// A scalar operand, standing in for a vector with every component equal.
+template<scalar T, size_t N>
+class Constant : public Base<Constant<T,N>>
+{
+public:
+    typedef T value_type;
+    static constexpr size_t size = N;
+
+    Constant(const T& t) : t_(t) {}
+    T operator[](size_t) const { return t_; }
+
+private:
+    T t_;
+};
+
+// Component-wise binary operation.
+template<typename L, typename R, typename Op>
+class Binary : public Base<Binary<L,R,Op>>
+{
+    static_assert(L::size == R::size, "operand sizes differ");
+    static_assert(std::is_same_v<typename L::value_type, typename R::value_type>,
+                  "operand element types differ");
+public:
+    typedef typename L::value_type value_type;
+    static constexpr size_t size = L::size;
+
+    Binary(const L& l, const R& r) : l_(l), r_(r) {}
+    value_type operator[](size_t i) const { return Op()(l_[i], r_[i]); }
+
+private:
+    L l_;
+    R r_;
+};
+
+// Component-wise negation.
+template<typename E>
+class Negate : public Base<Negate<E>>
+{
+public:
+    typedef typename E::value_type value_type;
+    static constexpr size_t size = E::size;
+
+    Negate(const E& e) : e_(e) {}
+    value_type operator[](size_t i) const { return -e_[i]; }
+
+private:
+    E e_;
+};
+
+// Start an expression from a vector.
+template<scalar T, size_t N, enum align A, size_t N_POW2>
+Ref<T,N,A,N_POW2> lazy(const tvec<T,N,A,N_POW2>& v)
+{
+    return Ref<T,N,A,N_POW2>(v);
+}
+
+namespace detail
+{
+template<typename X>
+struct is_tvec : std::false_type {};
+template<scalar T, size_t N, enum align A, size_t N_POW2>
+struct is_tvec<tvec<T,N,A,N_POW2>> : std::true_type {};
+
+template<typename X>
+concept vector_operand = expression<X> || is_tvec<X>::value;
+
+template<typename X>
+concept operand = vector_operand<X> || scalar<X>;
+
+template<typename L, typename R>
+concept operands = operand<L> && operand<R> && (expression<L> || expression<R>);
+
+template<typename X>
+auto wrap(const X& x)
+{
+    if constexpr (expression<X>)
+    {
+        return x;
+    }
+    else
+    {
+        return lazy(x);
+    }
+}
+
+template<typename Op, typename L, typename R>
+auto combine(const L& l, const R& r)
+{
+    if constexpr (scalar<L>)
+    {
+        typedef decltype(wrap(r)) RE;
+        typedef Constant<typename RE::value_type, RE::size> LE;
+        return Binary<LE, RE, Op>(LE(static_cast<typename RE::value_type>(l)), wrap(r));
+    }
+    else if constexpr (scalar<R>)
+    {
+        typedef decltype(wrap(l)) LE;
+        typedef Constant<typename LE::value_type, LE::size> RE;
+        return Binary<LE, RE, Op>(wrap(l), RE(static_cast<typename LE::value_type>(r)));
+    }
+    else
+    {
+        typedef decltype(wrap(l)) LE;
+        typedef decltype(wrap(r)) RE;
+        return Binary<LE, RE, Op>(wrap(l), wrap(r));
+    }
+}
+} // namespace detail
+
+template<typename L, typename R> requires detail::operands<L,R>
+auto operator+(const L& l, const R& r)
+{
+    return detail::combine<std::plus<>>(l, r);
+}
+
+template<typename L, typename R> requires detail::operands<L,R>
+auto operator-(const L& l, const R& r)
+{
+    return detail::combine<std::minus<>>(l, r);
+}
+
+template<typename L, typename R> requires detail::operands<L,R>
+auto operator*(const L& l, const R& r)
+{
+    return detail::combine<std::multiplies<>>(l, r);
+}
+
+template<typename L, typename R> requires detail::operands<L,R>
+auto operator/(const L& l, const R& r)
+{
+    return detail::combine<std::divides<>>(l, r);
+}
+
+template<expression E>
+Negate<E> operator-(const E& e)
+{
+    return Negate<E>(e);
+}
+
+// Evaluate an expression straight into an existing vector.
+template<scalar T, size_t N, enum align A, size_t N_POW2, expression E>
+void assign(tvec<T,N,A,N_POW2>& dst, const E& e)
+{
+    static_assert(N == E::size, "expression and vector sizes differ");
+    for (size_t i = 0; i < N; i++)
+    {
+        dst[i] = e[i];
+    }
+}
+
+// Evaluate the dot product of two expressions (or an expression and a
+// vector) without storing either of them.
+template<typename L, typename R>
+    requires detail::vector_operand<L> && detail::vector_operand<R>
+auto dot(const L& l, const R& r)
+{
+    auto le(detail::wrap(l));
+    auto re(detail::wrap(r));
+    static_assert(decltype(le)::size == decltype(re)::size, "operand sizes differ");
+    typename decltype(le)::value_type sum(le[0] * re[0]);
+    for (size_t i = 1; i < decltype(le)::size; i++)
+    {
+        sum += le[i] * re[i];
+    }
+    return sum;
+}
+
+} // namespace Expr
+} // namespace LibMatrix
+
+#endif // VEC_EXPR_H_
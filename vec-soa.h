@@ -0,0 +1,437 @@
+//
+// Copyright (c) 2026 libmatrix contributors
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef VEC_SOA_H_
+#define VEC_SOA_H_
+
+#include <algorithm>
+#include <math.h>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "vec.h"
+#include "simd.h"
+
+namespace LibMatrix
+{
+//
+// A container of N-component vectors stored in "array of structures of
+// arrays" form: the vectors are grouped into blocks of 'Lanes' elements, and
+// within a block each component is stored contiguously.  So for vec3 with 8
+// lanes, a block holds 8 x values, then 8 y values, then 8 z values.
+//
+// Unlike a std::vector<tvec3>, this lets the arithmetic below operate on a
+// whole block with full-width vector loads and stores and no shuffling.
+// Lanes should be a multiple of the widest SIMD register in use (8 floats
+// covers AVX2, 16 covers AVX-512).
+//
+// The unused lanes at the end of the last block are kept at zero, so the
+// block kernels may safely process them.
+//
+template<scalar T, size_t N = 3, size_t Lanes = 8>
+class tvec_soa
+{
+    static_assert(N > 0, "tvec_soa needs at least one component");
+    static_assert(Lanes > 0 && (Lanes & (Lanes - 1)) == 0,
+                  "tvec_soa lanes must be a power of two");
+public:
+    typedef tvec<T,N> value_type;
+    static constexpr size_t components = N;
+    static constexpr size_t lanes = Lanes;
+
+    // One block of Lanes vectors.  c[i][l] is component i of lane l.
+    struct alignas(Lanes * sizeof(T)) block
+    {
+        T c[N][Lanes];
+    };
+
+    // Proxy for a single element, so that the container can be indexed and
+    // assigned through much like a std::vector<tvec>.
+    class reference
+    {
+    public:
+        reference(block& b, size_t lane) : block_(b), lane_(lane) {}
+
+        operator value_type() const
+        {
+            value_type v;
+            for (size_t i = 0; i < N; i++)
+            {
+                v[i] = block_.c[i][lane_];
+            }
+            return v;
+        }
+
+        reference& operator=(const value_type& v)
+        {
+            for (size_t i = 0; i < N; i++)
+            {
+                block_.c[i][lane_] = v[i];
+            }
+            return *this;
+        }
+
+        reference& operator=(const reference& r)
+        {
+            return *this = static_cast<value_type>(r);
+        }
+
+        T& operator[](size_t i) { return block_.c[i][lane_]; }
+        const T& operator[](size_t i) const { return block_.c[i][lane_]; }
+
+        const T x() const                 { return block_.c[0][lane_]; }
+        const T y() const requires(N > 1) { return block_.c[1][lane_]; }
+        const T z() const requires(N > 2) { return block_.c[2][lane_]; }
+        const T w() const requires(N > 3) { return block_.c[3][lane_]; }
+
+        void x(const T& val)                 { block_.c[0][lane_] = val; }
+        void y(const T& val) requires(N > 1) { block_.c[1][lane_] = val; }
+        void z(const T& val) requires(N > 2) { block_.c[2][lane_] = val; }
+        void w(const T& val) requires(N > 3) { block_.c[3][lane_] = val; }
+
+    private:
+        block& block_;
+        size_t lane_;
+    };
+
+    tvec_soa() : size_(0) {}
+    explicit tvec_soa(size_t count) : size_(0) { resize(count); }
+    tvec_soa(std::span<const value_type> src) : size_(0) { assign(src); }
+
+    // Replace the contents with a copy of an array of vectors.
+    void assign(std::span<const value_type> src)
+    {
+        resize(src.size());
+        for (size_t i = 0; i < src.size(); i++)
+        {
+            (*this)[i] = src[i];
+        }
+    }
+
+    // Copy the contents back out into an array of vectors.
+    std::vector<value_type> to_vector() const
+    {
+        std::vector<value_type> dst(size_);
+        for (size_t i = 0; i < size_; i++)
+        {
+            dst[i] = (*this)[i];
+        }
+        return dst;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear() { resize(0); }
+
+    // Grow (with zero vectors) or shrink the container.
+    void resize(size_t count)
+    {
+        blocks_.resize((count + Lanes - 1) / Lanes);
+        const bool shrunk(count < size_);
+        size_ = count;
+        if (shrunk)
+        {
+            zero_padding();
+        }
+    }
+
+    // Reset the unused lanes of the last block to zero.  Only needed after
+    // writing whole blocks through blocks().
+    void zero_padding()
+    {
+        if (blocks_.empty())
+        {
+            return;
+        }
+        block& last(blocks_.back());
+        const size_t used(size_ - (blocks_.size() - 1) * Lanes);
+        for (size_t i = 0; i < N; i++)
+        {
+            std::fill(last.c[i] + used, last.c[i] + Lanes, T(0));
+        }
+    }
+
+    void push_back(const value_type& v)
+    {
+        resize(size_ + 1);
+        (*this)[size_ - 1] = v;
+    }
+
+    reference operator[](size_t index)
+    {
+        return reference(blocks_[index / Lanes], index % Lanes);
+    }
+
+    const value_type operator[](size_t index) const
+    {
+        const block& b(blocks_[index / Lanes]);
+        value_type v;
+        for (size_t i = 0; i < N; i++)
+        {
+            v[i] = b.c[i][index % Lanes];
+        }
+        return v;
+    }
+
+    // Raw access to the blocks for custom kernels.
+    size_t num_blocks() const { return blocks_.size(); }
+    block* blocks() { return blocks_.data(); }
+    const block* blocks() const { return blocks_.data(); }
+
+    // The blocks as one array of num_blocks() * N * Lanes values.
+    T* data() { return reinterpret_cast<T*>(blocks_.data()); }
+    const T* data() const { return reinterpret_cast<const T*>(blocks_.data()); }
+
+private:
+    std::vector<block> blocks_;
+    size_t size_;
+};
+
+typedef tvec_soa<float,2> vec2_soa;
+typedef tvec_soa<float,3> vec3_soa;
+typedef tvec_soa<float,4> vec4_soa;
+
+typedef tvec_soa<double,2,4> dvec2_soa;
+typedef tvec_soa<double,3,4> dvec3_soa;
+typedef tvec_soa<double,4,4> dvec4_soa;
+
+//
+// Whole-container arithmetic.  For float vectors, with a lane count that is
+// a multiple of Simd::soa_lane_multiple, these run on the Simd::Kernels
+// block kernels built for the host's best instruction set.  Otherwise each
+// works a block at a time, with inner loops over the lanes for the compiler
+// to vectorize.  Where two inputs differ in length, only the common prefix
+// is processed, and 'dst' is resized to match.  It is safe for 'dst' to be
+// one of the inputs.
+//
+
+namespace detail
+{
+// Whether the Simd::soa_* kernels can handle a container.
+template<scalar T, size_t Lanes>
+constexpr bool soa_kernels = std::is_same_v<T, float> &&
+                             Lanes % Simd::soa_lane_multiple == 0;
+} // namespace detail
+
+// dst[i] = a[i] + b[i]
+template<scalar T, size_t N, size_t Lanes>
+void add(tvec_soa<T,N,Lanes>& dst, const tvec_soa<T,N,Lanes>& a,
+         const tvec_soa<T,N,Lanes>& b)
+{
+    const size_t count(std::min(a.size(), b.size()));
+    dst.resize(count);
+    if constexpr (detail::soa_kernels<T,Lanes>)
+    {
+        Simd::soa_add(dst.data(), a.data(), b.data(), dst.num_blocks() * N * Lanes);
+    }
+    else
+    {
+        typename tvec_soa<T,N,Lanes>::block* d(dst.blocks());
+        for (size_t blk = 0; blk < dst.num_blocks(); blk++)
+        {
+            for (size_t i = 0; i < N; i++)
+            {
+                for (size_t l = 0; l < Lanes; l++)
+                {
+                    d[blk].c[i][l] = a.blocks()[blk].c[i][l] + b.blocks()[blk].c[i][l];
+                }
+            }
+        }
+    }
+    dst.zero_padding();
+}
+
+// dst[i] = a[i] * s
+template<scalar T, size_t N, size_t Lanes>
+void scale(tvec_soa<T,N,Lanes>& dst, const tvec_soa<T,N,Lanes>& a, const T s)
+{
+    dst.resize(a.size());
+    if constexpr (detail::soa_kernels<T,Lanes>)
+    {
+        Simd::soa_scale(dst.data(), a.data(), s, dst.num_blocks() * N * Lanes);
+    }
+    else
+    {
+        typename tvec_soa<T,N,Lanes>::block* d(dst.blocks());
+        for (size_t blk = 0; blk < dst.num_blocks(); blk++)
+        {
+            for (size_t i = 0; i < N; i++)
+            {
+                for (size_t l = 0; l < Lanes; l++)
+                {
+                    d[blk].c[i][l] = a.blocks()[blk].c[i][l] * s;
+                }
+            }
+        }
+    }
+    dst.zero_padding();
+}
+
+// dst[i] = cross(a[i], b[i])
+template<scalar T, size_t Lanes>
+void cross(tvec_soa<T,3,Lanes>& dst, const tvec_soa<T,3,Lanes>& a,
+           const tvec_soa<T,3,Lanes>& b)
+{
+    const size_t count(std::min(a.size(), b.size()));
+    dst.resize(count);
+    if constexpr (detail::soa_kernels<T,Lanes>)
+    {
+        Simd::soa_cross(dst.data(), a.data(), b.data(), dst.num_blocks(), Lanes);
+    }
+    else
+    {
+        typename tvec_soa<T,3,Lanes>::block* d(dst.blocks());
+        for (size_t blk = 0; blk < dst.num_blocks(); blk++)
+        {
+            const typename tvec_soa<T,3,Lanes>::block& u(a.blocks()[blk]);
+            const typename tvec_soa<T,3,Lanes>::block& v(b.blocks()[blk]);
+            typename tvec_soa<T,3,Lanes>::block r;
+            for (size_t l = 0; l < Lanes; l++)
+            {
+                r.c[0][l] = u.c[1][l] * v.c[2][l] - u.c[2][l] * v.c[1][l];
+                r.c[1][l] = u.c[2][l] * v.c[0][l] - u.c[0][l] * v.c[2][l];
+                r.c[2][l] = u.c[0][l] * v.c[1][l] - u.c[1][l] * v.c[0][l];
+            }
+            d[blk] = r;
+        }
+    }
+    dst.zero_padding();
+}
+
+// Normalize every vector in place.  Zero-length vectors are left alone.
+template<scalar T, size_t N, size_t Lanes>
+void normalize(tvec_soa<T,N,Lanes>& v)
+{
+    if constexpr (detail::soa_kernels<T,Lanes>)
+    {
+        Simd::soa_normalize(v.data(), v.data(), v.num_blocks(), N, Lanes);
+    }
+    else
+    {
+        typename tvec_soa<T,N,Lanes>::block* d(v.blocks());
+        for (size_t blk = 0; blk < v.num_blocks(); blk++)
+        {
+            T scale[Lanes];
+            for (size_t l = 0; l < Lanes; l++)
+            {
+                T len2(0);
+                for (size_t i = 0; i < N; i++)
+                {
+                    len2 += d[blk].c[i][l] * d[blk].c[i][l];
+                }
+                scale[l] = len2 > T(0) ? T(1) / sqrt(len2) : T(1);
+            }
+            for (size_t i = 0; i < N; i++)
+            {
+                for (size_t l = 0; l < Lanes; l++)
+                {
+                    d[blk].c[i][l] *= scale[l];
+                }
+            }
+        }
+    }
+}
+
+namespace detail
+{
+// Compute a per-lane scalar for every block and store the results for the
+// first 'count' elements into dst.  The kernel is handed a run of blocks
+// and somewhere to put all of their lane results: dst itself for the
+// blocks whose lanes are all wanted, and a scratch block for the last,
+// partial one.
+template<scalar T, size_t Lanes, typename Kernel>
+void soa_reduce(std::span<T> dst, size_t count, Kernel kernel)
+{
+    count = std::min(count, dst.size());
+    const size_t whole(count / Lanes);
+    if (whole)
+    {
+        kernel(0, whole, dst.data());
+    }
+    if (count % Lanes)
+    {
+        T lane[Lanes];
+        kernel(whole, 1, lane);
+        std::copy_n(lane, count % Lanes, dst.data() + whole * Lanes);
+    }
+}
+} // namespace detail
+
+// dst[i] = dot(a[i], b[i]), for as many elements as fit in dst.
+template<scalar T, size_t N, size_t Lanes>
+void dot(std::type_identity_t<std::span<T>> dst, const tvec_soa<T,N,Lanes>& a,
+         const tvec_soa<T,N,Lanes>& b)
+{
+    detail::soa_reduce<T,Lanes>(dst, std::min(a.size(), b.size()),
+        [&a, &b](size_t blk, size_t blocks, T* lane)
+        {
+            const typename tvec_soa<T,N,Lanes>::block* u(a.blocks() + blk);
+            const typename tvec_soa<T,N,Lanes>::block* v(b.blocks() + blk);
+            if constexpr (detail::soa_kernels<T,Lanes>)
+            {
+                Simd::soa_dot(lane, u->c[0], v->c[0], blocks, N, Lanes);
+            }
+            else
+            {
+                for (size_t k = 0; k < blocks; k++, u++, v++, lane += Lanes)
+                {
+                    for (size_t l = 0; l < Lanes; l++)
+                    {
+                        lane[l] = T(0);
+                    }
+                    for (size_t i = 0; i < N; i++)
+                    {
+                        for (size_t l = 0; l < Lanes; l++)
+                        {
+                            lane[l] += u->c[i][l] * v->c[i][l];
+                        }
+                    }
+                }
+            }
+        });
+}
+
+// dst[i] = length(a[i]), for as many elements as fit in dst.
+template<scalar T, size_t N, size_t Lanes>
+void length(std::type_identity_t<std::span<T>> dst, const tvec_soa<T,N,Lanes>& a)
+{
+    detail::soa_reduce<T,Lanes>(dst, a.size(),
+        [&a](size_t blk, size_t blocks, T* lane)
+        {
+            const typename tvec_soa<T,N,Lanes>::block* u(a.blocks() + blk);
+            if constexpr (detail::soa_kernels<T,Lanes>)
+            {
+                Simd::soa_length(lane, u->c[0], blocks, N, Lanes);
+            }
+            else
+            {
+                for (size_t k = 0; k < blocks; k++, u++, lane += Lanes)
+                {
+                    for (size_t l = 0; l < Lanes; l++)
+                    {
+                        lane[l] = T(0);
+                    }
+                    for (size_t i = 0; i < N; i++)
+                    {
+                        for (size_t l = 0; l < Lanes; l++)
+                        {
+                            lane[l] += u->c[i][l] * u->c[i][l];
+                        }
+                    }
+                    for (size_t l = 0; l < Lanes; l++)
+                    {
+                        lane[l] = sqrt(lane[l]);
+                    }
+                }
+            }
+        });
+}
+
+} // namespace LibMatrix
+
+#endif // VEC_SOA_H_
@@ -117,34 +117,38 @@ struct alignas(((N == N_POW2 && A != align::element) || A == align::vector) ? N_
 	std::transform((*this).cbegin(),(*this).cbegin() + dst.size(), rhs.cbegin(), dst.begin(), std::minus<>{});
 	return dst;
     }
-    /* arithmetic scalar operators with constructor fill */
+    /* arithmetic scalar operators applied in place to a copy */
     template<scalar T_RHS = T>
     inline constexpr const tvec<T,N,A> operator*(const T_RHS& rhs) const
     {
-        tvec<T, N, A> dst((T)rhs);
-	std::transform((*this).cbegin(),(*this).cend(), dst.cbegin(), dst.begin(), std::multiplies<>{});
-	return dst;
+        tvec<T, N, A> dst(*this);
+        for (T& i : dst)
+            i *= (T)rhs;
+        return dst;
     }
     template<scalar T_RHS = T>
     inline constexpr const tvec<T,N,A> operator/(const T_RHS& rhs) const
     {
-        tvec<T, N, A> dst((T)rhs);
-	std::transform((*this).cbegin(),(*this).cend(), dst.cbegin(), dst.begin(), std::divides<>{});
-	return dst;
+        tvec<T, N, A> dst(*this);
+        for (T& i : dst)
+            i /= (T)rhs;
+        return dst;
     }
     template<scalar T_RHS = T>
     inline constexpr const tvec<T,N,A> operator+(const T_RHS& rhs) const
     {
-        tvec<T, N, A> dst((T)rhs);
-	std::transform((*this).cbegin(),(*this).cend(), dst.cbegin(), dst.begin(), std::plus<>{});
-	return dst;
+        tvec<T, N, A> dst(*this);
+        for (T& i : dst)
+            i += (T)rhs;
+        return dst;
     }
     template<scalar T_RHS = T>
     inline constexpr const tvec<T,N,A> operator-(const T_RHS& rhs) const
     {
-        tvec<T, N, A> dst((T)rhs);
-	std::transform((*this).cbegin(),(*this).cend(), dst.cbegin(), dst.begin(), std::minus<>{});
-	return dst;
+        tvec<T, N, A> dst(*this);
+        for (T& i : dst)
+            i -= (T)rhs;
+        return dst;
     }
 
 